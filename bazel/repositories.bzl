@@ -189,6 +189,7 @@ def envoy_dependencies(path = "@envoy_deps//", skip_targets = []):
     _com_github_tencent_rapidjson()
     _com_google_googletest()
     _com_google_protobuf()
+    _com_googlesource_code_re2()
 
     # Used for bundling gcovr into a relocatable .par file.
     _repository_impl("subpar")
@@ -310,6 +311,13 @@ def _com_google_googletest():
         actual = "@com_google_googletest//:gtest",
     )
 
+def _com_googlesource_code_re2():
+    _repository_impl("com_googlesource_code_re2")
+    native.bind(
+        name = "re2",
+        actual = "@com_googlesource_code_re2//:re2",
+    )
+
 def _com_google_absl():
     _repository_impl("com_google_absl")
     native.bind(
@@ -66,6 +66,10 @@ REPOSITORY_LOCATIONS = dict(
         commit = "f54b0e47a08782a6131cc3d60f94d038fa6e0a51",  # v1.1.0
         remote = "https://github.com/tencent/rapidjson",
     ),
+    com_googlesource_code_re2 = dict(
+        commit = "26cd968b735e227361c9703683266f01e5df7857",
+        remote = "https://github.com/google/re2",
+    ),
     com_google_googletest = dict(
         commit = "43863938377a9ea1399c0596269e0890b5c5515a",
         remote = "https://github.com/google/googletest",
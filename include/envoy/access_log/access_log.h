@@ -77,6 +77,16 @@ public:
   virtual std::string format(const Http::HeaderMap& request_headers,
                              const Http::HeaderMap& response_headers,
                              const RequestInfo::RequestInfo& request_info) const PURE;
+
+  /**
+   * Same as format() but appends the result to an existing string. Reusing the output string
+   * across calls avoids allocating a new string for every log line.
+   * @param output supplies the string to append to.
+   */
+  virtual void formatInto(const Http::HeaderMap& request_headers,
+                          const Http::HeaderMap& response_headers,
+                          const RequestInfo::RequestInfo& request_info,
+                          std::string& output) const PURE;
 };
 
 typedef std::unique_ptr<Formatter> FormatterPtr;
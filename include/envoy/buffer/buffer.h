@@ -174,6 +174,26 @@ public:
 
 typedef std::unique_ptr<Instance> InstancePtr;
 
+/**
+ * Tracks the number of bytes held in a set of buffers, for example the buffers of a connection.
+ */
+class MemoryAccount {
+public:
+  virtual ~MemoryAccount() {}
+
+  /**
+   * Called when the tracked buffers grow.
+   * @param bytes supplies the number of bytes added.
+   */
+  virtual void charge(uint64_t bytes) PURE;
+
+  /**
+   * Called when the tracked buffers shrink or are released.
+   * @param bytes supplies the number of bytes removed.
+   */
+  virtual void credit(uint64_t bytes) PURE;
+};
+
 /**
  * A factory for creating buffers which call callbacks when reaching high and low watermarks.
  */
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+
+/**
+ * Deleter for objects created in an Arena. The object is destroyed but its memory is only released
+ * when the arena itself is destroyed.
+ */
+struct ArenaDeleter {
+  template <class T> void operator()(T* object) const { object->~T(); }
+};
+
+template <class T> using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+/**
+ * A region of memory whose lifetime is bound to an owner, e.g. an HTTP stream. Allocations are
+ * never freed individually. All the memory is released at once when the arena is destroyed, which
+ * makes allocation and teardown of many short lived objects cheap. Arenas are not thread safe.
+ */
+class Arena {
+public:
+  virtual ~Arena() {}
+
+  /**
+   * Allocate memory from the arena.
+   * @param size supplies the number of bytes to allocate.
+   * @param alignment supplies the required alignment, which must be a power of two.
+   * @return void* the allocated memory, which is valid until the arena is destroyed.
+   */
+  virtual void* allocate(size_t size, size_t alignment) PURE;
+
+  /**
+   * Construct an object in the arena. The returned pointer must be released before the arena is
+   * destroyed.
+   */
+  template <class T, class... Args> ArenaPtr<T> make(Args&&... args) {
+    return ArenaPtr<T>(new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...));
+  }
+};
+
+} // namespace Envoy
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Regex {
+
+/**
+ * Regular expression engines that a compiled matcher can be backed by.
+ */
+enum class Engine {
+  // libstdc++ std::regex with ECMAScript syntax. This is a backtracking engine; match time can be
+  // exponential in the input size for some patterns and every match allocates.
+  StdRegex,
+  // RE2 (https://github.com/google/re2). Match time is linear in the input size and matching does
+  // not allocate. RE2 syntax does not support backreferences or lookaround.
+  Re2
+};
+
+/**
+ * A regular expression compiled once (typically at configuration load time) and matched many
+ * times.
+ */
+class CompiledMatcher {
+public:
+  virtual ~CompiledMatcher() {}
+
+  /**
+   * @param value supplies the value to match.
+   * @return bool true if the regular expression matches the entire value.
+   */
+  virtual bool match(absl::string_view value) const PURE;
+};
+
+typedef std::unique_ptr<const CompiledMatcher> CompiledMatcherPtr;
+
+} // namespace Regex
+} // namespace Envoy
@@ -151,6 +151,14 @@ public:
    * @return the watermark buffer factory for this dispatcher.
    */
   virtual Buffer::WatermarkFactory& getWatermarkFactory() PURE;
+
+  /**
+   * Start recording stats for the dispatcher's posted callbacks. Must be called before the
+   * dispatcher runs on a different thread than the caller.
+   * @param scope supplies the scope to create the stats in.
+   * @param prefix supplies the prefix of the stat names.
+   */
+  virtual void initializeStats(Stats::Scope& scope, const std::string& prefix) PURE;
 };
 
 typedef std::unique_ptr<Dispatcher> DispatcherPtr;
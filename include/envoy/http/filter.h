@@ -6,6 +6,7 @@
 #include <string>
 
 #include "envoy/access_log/access_log.h"
+#include "envoy/common/arena.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/http/codec.h"
 #include "envoy/http/header_map.h"
@@ -138,6 +139,12 @@ public:
    * @return tracing configuration.
    */
   virtual const Tracing::Config& tracingConfig() PURE;
+
+  /**
+   * @return Arena& an arena for allocating objects that live no longer than the stream. Memory
+   *         allocated from the arena is released in one go when the stream is destroyed.
+   */
+  virtual Arena& arena() PURE;
 };
 
 /**
@@ -176,6 +176,14 @@ public:
    */
   virtual void setConnectionStats(const ConnectionStats& stats) PURE;
 
+  /**
+   * Set the account that the bytes held in the connection's read and write buffers are charged to.
+   * The bytes already buffered are charged right away, and everything charged is credited back
+   * when the connection is closed or the account is replaced.
+   * @param account supplies the account to charge, or nullptr to stop accounting.
+   */
+  virtual void setBufferMemoryAccount(Buffer::MemoryAccount* account) PURE;
+
   /**
    * @return the SSL connection data if this is an SSL connection, or nullptr if it is not.
    */
@@ -40,6 +40,17 @@ public:
   int64_t& asInteger();
   int64_t asInteger() const;
 
+  /**
+   * A bulk string can hold its bytes in a buffer instead of in its string, which lets a long value
+   * be moved out of one connection's read buffer and into another connection's write buffer
+   * without copying its bytes. The buffer is shared with the write buffers that the value has been
+   * encoded to, and must not be modified after the value has been encoded. A null buffer means that
+   * the bytes are in the string. asString() copies the bytes of a buffered bulk string into its
+   * string and releases the buffer.
+   */
+  std::shared_ptr<Buffer::Instance>& asBuffer();
+  const std::shared_ptr<Buffer::Instance>& asBuffer() const;
+
   /**
    * Get/set the type of the RespValue. A RespValue can only be a single type at a time. Each time
    * type() is called the type is changed and then the type specific as* methods can be used.
@@ -50,13 +61,16 @@ public:
 private:
   union {
     std::vector<RespValue> array_;
-    std::string string_;
+    // Mutable so that a const bulk string can move its buffered bytes into the string.
+    mutable std::string string_;
     int64_t integer_;
   };
 
   void cleanup();
+  void unbuffer() const;
 
   RespType type_;
+  mutable std::shared_ptr<Buffer::Instance> buffer_;
 };
 
 typedef std::unique_ptr<RespValue> RespValuePtr;
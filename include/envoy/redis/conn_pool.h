@@ -91,6 +91,14 @@ public:
    * passive healthcheck operations.
    */
   virtual bool disableOutlierEvents() const PURE;
+
+  /**
+   * @return uint32_t the number of bytes of encoded requests that a client buffers before it
+   *         writes them to the upstream connection. Requests below the limit are written once per
+   *         dispatcher loop iteration, so that requests pipelined within an iteration share one
+   *         write. 0 disables buffering and every request is written as it is made.
+   */
+  virtual uint32_t maxBufferSizeBeforeFlush() const PURE;
 };
 
 /**
@@ -147,6 +147,12 @@ public:
    * @return bool indicating whether the hot restart functionality has been disabled via cli flags.
    */
   virtual bool hotRestartDisabled() PURE;
+
+  /**
+   * @return uint64_t the maximum number of bytes that the connections of one worker may hold in
+   * their read and write buffers before the largest of them are closed, or 0 for no limit.
+   */
+  virtual uint64_t maxWorkerBufferedBytes() PURE;
 };
 
 } // namespace Server
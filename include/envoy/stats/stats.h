@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <functional>
 #include <list>
 #include <memory>
 #include <string>
@@ -171,6 +172,78 @@ public:
 
 typedef std::shared_ptr<Histogram> HistogramSharedPtr;
 
+/**
+ * Holds the computed statistics for a histogram.
+ */
+class HistogramStatistics {
+public:
+  virtual ~HistogramStatistics() {}
+
+  /**
+   * Returns summary representation of the histogram.
+   */
+  virtual std::string summary() const PURE;
+
+  /**
+   * Returns supported quantiles (e.g., 0.5, 0.99).
+   */
+  virtual const std::vector<double>& supportedQuantiles() const PURE;
+
+  /**
+   * Returns computed quantile values during the period. Each value corresponds to the quantile at
+   * the same position in supportedQuantiles(). The value is NaN if no samples were recorded.
+   */
+  virtual const std::vector<double>& computedQuantiles() const PURE;
+
+  /**
+   * Returns the number of samples recorded during the period.
+   */
+  virtual uint64_t sampleCount() const PURE;
+
+  /**
+   * Returns the sum of all samples recorded during the period.
+   */
+  virtual uint64_t sampleSum() const PURE;
+};
+
+/**
+ * A histogram that is stored in the main thread and provides summary view of the histogram.
+ * Values recorded on worker threads are buffered thread locally and are only merged into the
+ * parent when StoreRoot::mergeHistograms() is called.
+ */
+class ParentHistogram : public virtual Histogram {
+public:
+  virtual ~ParentHistogram() {}
+
+  /**
+   * This method is called during the main stats flush process for each of the histograms and used
+   * to merge the thread local histogram values into the interval and cumulative statistics.
+   */
+  virtual void merge() PURE;
+
+  /**
+   * Returns the interval histogram summary statistics.
+   */
+  virtual const HistogramStatistics& intervalStatistics() const PURE;
+
+  /**
+   * Returns the cumulative histogram summary statistics.
+   */
+  virtual const HistogramStatistics& cumulativeStatistics() const PURE;
+
+  /**
+   * Returns a summary of both the interval and cumulative statistics.
+   */
+  virtual std::string summary() const PURE;
+
+  /**
+   * @return bool whether any value has been merged into the histogram since it was created.
+   */
+  virtual bool used() const PURE;
+};
+
+typedef std::shared_ptr<ParentHistogram> ParentHistogramSharedPtr;
+
 /**
  * A sink for stats. Each sink is responsible for writing stats to a backing store.
  */
@@ -179,8 +252,8 @@ public:
   virtual ~Sink() {}
 
   /**
-   * This will be called before a sequence of flushCounter() and flushGauge() calls. Sinks can
-   * choose to optimize writing if desired with a paired endFlush() call.
+   * This will be called before a sequence of flushCounter(), flushGauge() and flushHistogram()
+   * calls. Sinks can choose to optimize writing if desired with a paired endFlush() call.
    */
   virtual void beginFlush() PURE;
 
@@ -195,15 +268,29 @@ public:
   virtual void flushGauge(const Gauge& gauge, uint64_t value) PURE;
 
   /**
-   * This will be called after beginFlush(), some number of flushCounter(), and some number of
-   * flushGauge(). Sinks can use this to optimize writing if desired.
+   * Flush the merged statistics of a histogram. Called once per used histogram per flush interval,
+   * after the thread local values have been merged.
+   */
+  virtual void flushHistogram(const ParentHistogram& histogram) PURE;
+
+  /**
+   * This will be called after beginFlush(), some number of flushCounter(), some number of
+   * flushGauge() and some number of flushHistogram(). Sinks can use this to optimize writing if
+   * desired.
    */
   virtual void endFlush() PURE;
 
   /**
-   * Flush a histogram value.
+   * Flush a histogram value. Only called if wantsHistogramValues() returns true.
    */
   virtual void onHistogramComplete(const Histogram& histogram, uint64_t value) PURE;
+
+  /**
+   * @return bool whether the sink needs every histogram value as it is recorded. Sinks that only
+   *         consume the merged histograms passed to flushHistogram() return false, so that
+   *         recording a value never reaches them. Called once when the sink is added to the store.
+   */
+  virtual bool wantsHistogramValues() const PURE;
 };
 
 typedef std::unique_ptr<Sink> SinkPtr;
@@ -263,6 +350,12 @@ public:
    * @return a list of all known gauges.
    */
   virtual std::list<GaugeSharedPtr> gauges() const PURE;
+
+  /**
+   * @return a list of all known histograms that aggregate their values. Stores that do not
+   *         aggregate histogram values return an empty list.
+   */
+  virtual std::list<ParentHistogramSharedPtr> histograms() const PURE;
 };
 
 typedef std::unique_ptr<Store> StorePtr;
@@ -294,6 +387,17 @@ public:
    * down.
    */
   virtual void shutdownThreading() PURE;
+
+  typedef std::function<void()> PostMergeCb;
+
+  /**
+   * Called during the flush process to merge all the thread local histograms. The passed in
+   * callback will be called on the main thread once the thread local values of every histogram
+   * have been merged. The callback may not be called if the store is shut down while the merge is
+   * in progress.
+   * @param merge_complete_cb supplies the callback to run when the merge is complete.
+   */
+  virtual void mergeHistograms(PostMergeCb merge_complete_cb) PURE;
 };
 
 typedef std::unique_ptr<StoreRoot> StoreRootPtr;
@@ -199,6 +199,28 @@ public:
    */
   virtual const HostsPerLocality& healthyHostsPerLocality() const PURE;
 
+  /**
+   * @return HostVectorConstSharedPtr the immutable list returned by hosts(). The list is replaced,
+   *         never modified, on update, so it can be shared with other threads.
+   */
+  virtual HostVectorConstSharedPtr hostsPtr() const PURE;
+
+  /**
+   * @return HostVectorConstSharedPtr the immutable list returned by healthyHosts().
+   */
+  virtual HostVectorConstSharedPtr healthyHostsPtr() const PURE;
+
+  /**
+   * @return HostsPerLocalityConstSharedPtr the immutable buckets returned by hostsPerLocality().
+   */
+  virtual HostsPerLocalityConstSharedPtr hostsPerLocalityPtr() const PURE;
+
+  /**
+   * @return HostsPerLocalityConstSharedPtr the immutable buckets returned by
+   *         healthyHostsPerLocality().
+   */
+  virtual HostsPerLocalityConstSharedPtr healthyHostsPerLocalityPtr() const PURE;
+
   /**
    * Updates the hosts in a given host set.
    *
@@ -262,6 +284,7 @@ public:
  */
 // clang-format off
 #define ALL_CLUSTER_STATS(COUNTER, GAUGE, HISTOGRAM)                                               \
+  COUNTER  (lb_hash_bounded_load_overflow)                                                         \
   COUNTER  (lb_healthy_panic)                                                                      \
   COUNTER  (lb_local_cluster_not_ok)                                                               \
   COUNTER  (lb_recalculate_zone_structures)                                                        \
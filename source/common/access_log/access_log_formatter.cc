@@ -2,11 +2,13 @@
 
 #include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
 #include "common/common/utility.h"
+#include "common/http/headers.h"
 #include "common/http/utility.h"
 #include "common/request_info/utility.h"
 
@@ -34,21 +36,25 @@ AccessLogFormatUtils::protocolToString(const Optional<Http::Protocol>& protocol)
   return UnspecifiedValueString;
 }
 
+std::string FormatterBase::format(const Http::HeaderMap& request_headers,
+                                  const Http::HeaderMap& response_headers,
+                                  const RequestInfo::RequestInfo& request_info) const {
+  std::string output;
+  formatInto(request_headers, response_headers, request_info, output);
+  return output;
+}
+
 FormatterImpl::FormatterImpl(const std::string& format) {
   formatters_ = AccessLogFormatParser::parse(format);
 }
 
-std::string FormatterImpl::format(const Http::HeaderMap& request_headers,
-                                  const Http::HeaderMap& response_headers,
-                                  const RequestInfo::RequestInfo& request_info) const {
-  std::string log_line;
-  log_line.reserve(256);
-
+void FormatterImpl::formatInto(const Http::HeaderMap& request_headers,
+                               const Http::HeaderMap& response_headers,
+                               const RequestInfo::RequestInfo& request_info,
+                               std::string& output) const {
   for (const FormatterPtr& formatter : formatters_) {
-    log_line += formatter->format(request_headers, response_headers, request_info);
+    formatter->formatInto(request_headers, response_headers, request_info, output);
   }
-
-  return log_line;
 }
 
 void AccessLogFormatParser::parseCommand(const std::string& token, const size_t start,
@@ -143,99 +149,104 @@ std::vector<FormatterPtr> AccessLogFormatParser::parse(const std::string& format
   return formatters;
 }
 
+namespace {
+
+void appendDurationMs(const Optional<std::chrono::microseconds>& duration, std::string& output) {
+  if (duration.valid()) {
+    output += std::to_string(
+        std::chrono::duration_cast<std::chrono::milliseconds>(duration.value()).count());
+  } else {
+    output += UnspecifiedValueString;
+  }
+}
+
+} // namespace
+
 RequestInfoFormatter::RequestInfoFormatter(const std::string& field_name) {
   if (field_name == "START_TIME") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return AccessLogDateTimeFormatter::fromTime(request_info.startTime());
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += AccessLogDateTimeFormatter::fromTime(request_info.startTime());
     };
   } else if (field_name == "REQUEST_DURATION") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      Optional<std::chrono::microseconds> duration = request_info.requestReceivedDuration();
-      if (duration.valid()) {
-        return std::to_string(
-            std::chrono::duration_cast<std::chrono::milliseconds>(duration.value()).count());
-      } else {
-        return UnspecifiedValueString;
-      }
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      appendDurationMs(request_info.requestReceivedDuration(), output);
     };
   } else if (field_name == "RESPONSE_DURATION") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      Optional<std::chrono::microseconds> duration = request_info.responseReceivedDuration();
-      if (duration.valid()) {
-        return std::to_string(
-            std::chrono::duration_cast<std::chrono::milliseconds>(duration.value()).count());
-      } else {
-        return UnspecifiedValueString;
-      }
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      appendDurationMs(request_info.responseReceivedDuration(), output);
     };
   } else if (field_name == "BYTES_RECEIVED") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return std::to_string(request_info.bytesReceived());
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += std::to_string(request_info.bytesReceived());
     };
   } else if (field_name == "PROTOCOL") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return AccessLogFormatUtils::protocolToString(request_info.protocol());
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += AccessLogFormatUtils::protocolToString(request_info.protocol());
     };
   } else if (field_name == "RESPONSE_CODE") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return request_info.responseCode().valid()
-                 ? std::to_string(request_info.responseCode().value())
-                 : "0";
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      if (request_info.responseCode().valid()) {
+        output += std::to_string(request_info.responseCode().value());
+      } else {
+        output += "0";
+      }
     };
   } else if (field_name == "BYTES_SENT") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return std::to_string(request_info.bytesSent());
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += std::to_string(request_info.bytesSent());
     };
   } else if (field_name == "DURATION") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return std::to_string(
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += std::to_string(
           std::chrono::duration_cast<std::chrono::milliseconds>(request_info.duration()).count());
     };
   } else if (field_name == "RESPONSE_FLAGS") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return RequestInfo::ResponseFlagUtils::toShortString(request_info);
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += RequestInfo::ResponseFlagUtils::toShortString(request_info);
     };
   } else if (field_name == "UPSTREAM_HOST") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
       if (request_info.upstreamHost()) {
-        return request_info.upstreamHost()->address()->asString();
+        output += request_info.upstreamHost()->address()->asString();
       } else {
-        return UnspecifiedValueString;
+        output += UnspecifiedValueString;
       }
     };
   } else if (field_name == "UPSTREAM_CLUSTER") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      std::string upstream_cluster_name;
-      if (nullptr != request_info.upstreamHost()) {
-        upstream_cluster_name = request_info.upstreamHost()->cluster().name();
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      if (nullptr != request_info.upstreamHost() &&
+          !request_info.upstreamHost()->cluster().name().empty()) {
+        output += request_info.upstreamHost()->cluster().name();
+      } else {
+        output += UnspecifiedValueString;
       }
-
-      return upstream_cluster_name.empty() ? UnspecifiedValueString : upstream_cluster_name;
     };
   } else if (field_name == "UPSTREAM_LOCAL_ADDRESS") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return request_info.upstreamLocalAddress() != nullptr
-                 ? request_info.upstreamLocalAddress()->asString()
-                 : UnspecifiedValueString;
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      if (request_info.upstreamLocalAddress() != nullptr) {
+        output += request_info.upstreamLocalAddress()->asString();
+      } else {
+        output += UnspecifiedValueString;
+      }
     };
   } else if (field_name == "DOWNSTREAM_LOCAL_ADDRESS") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return request_info.downstreamLocalAddress()->asString();
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += request_info.downstreamLocalAddress()->asString();
     };
   } else if (field_name == "DOWNSTREAM_LOCAL_ADDRESS_WITHOUT_PORT") {
-    field_extractor_ = [](const Envoy::RequestInfo::RequestInfo& request_info) {
-      return RequestInfo::Utility::formatDownstreamAddressNoPort(
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += RequestInfo::Utility::formatDownstreamAddressNoPort(
           *request_info.downstreamLocalAddress());
     };
   } else if (field_name == "DOWNSTREAM_REMOTE_ADDRESS") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return request_info.downstreamRemoteAddress()->asString();
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += request_info.downstreamRemoteAddress()->asString();
     };
   } else if (field_name == "DOWNSTREAM_ADDRESS" ||
              field_name == "DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT") {
     // DEPRECATED: "DOWNSTREAM_ADDRESS" will be removed post 1.6.0.
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return RequestInfo::Utility::formatDownstreamAddressNoPort(
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += RequestInfo::Utility::formatDownstreamAddressNoPort(
           *request_info.downstreamRemoteAddress());
     };
   } else {
@@ -243,42 +254,69 @@ RequestInfoFormatter::RequestInfoFormatter(const std::string& field_name) {
   }
 }
 
-std::string RequestInfoFormatter::format(const Http::HeaderMap&, const Http::HeaderMap&,
-                                         const RequestInfo::RequestInfo& request_info) const {
-  return field_extractor_(request_info);
+void RequestInfoFormatter::formatInto(const Http::HeaderMap&, const Http::HeaderMap&,
+                                      const RequestInfo::RequestInfo& request_info,
+                                      std::string& output) const {
+  field_extractor_(request_info, output);
 }
 
 PlainStringFormatter::PlainStringFormatter(const std::string& str) : str_(str) {}
 
-std::string PlainStringFormatter::format(const Http::HeaderMap&, const Http::HeaderMap&,
-                                         const RequestInfo::RequestInfo&) const {
-  return str_;
+void PlainStringFormatter::formatInto(const Http::HeaderMap&, const Http::HeaderMap&,
+                                      const RequestInfo::RequestInfo&, std::string& output) const {
+  output += str_;
 }
 
 HeaderFormatter::HeaderFormatter(const std::string& main_header,
                                  const std::string& alternative_header,
                                  const Optional<size_t>& max_length)
-    : main_header_(main_header), alternative_header_(alternative_header), max_length_(max_length) {}
+    : main_header_(main_header), alternative_header_(alternative_header),
+      main_header_getter_(inlineHeaderGetter(main_header_)),
+      alternative_header_getter_(inlineHeaderGetter(alternative_header_)),
+      max_length_(max_length) {}
+
+HeaderFormatter::InlineHeaderGetter
+HeaderFormatter::inlineHeaderGetter(const Http::LowerCaseString& header) {
+  typedef std::unordered_map<std::string, InlineHeaderGetter> GetterMap;
+  static const GetterMap* getters = []() {
+    GetterMap* getters = new GetterMap();
+#define INLINE_HEADER_GETTER(name)                                                                 \
+  getters->emplace(Http::Headers::get().name.get(),                                                \
+                   static_cast<InlineHeaderGetter>(&Http::HeaderMap::name));
+    ALL_INLINE_HEADERS(INLINE_HEADER_GETTER)
+#undef INLINE_HEADER_GETTER
+    return getters;
+  }();
+
+  const auto getter = getters->find(header.get());
+  return getter != getters->end() ? getter->second : nullptr;
+}
 
-std::string HeaderFormatter::format(const Http::HeaderMap& headers) const {
-  const Http::HeaderEntry* header = headers.get(main_header_);
+const Http::HeaderEntry* HeaderFormatter::get(const Http::HeaderMap& headers,
+                                              const Http::LowerCaseString& header,
+                                              InlineHeaderGetter getter) const {
+  return getter != nullptr ? (headers.*getter)() : headers.get(header);
+}
+
+void HeaderFormatter::formatInto(const Http::HeaderMap& headers, std::string& output) const {
+  const Http::HeaderEntry* header = get(headers, main_header_, main_header_getter_);
 
   if (!header && !alternative_header_.get().empty()) {
-    header = headers.get(alternative_header_);
+    header = get(headers, alternative_header_, alternative_header_getter_);
   }
 
-  std::string header_value_string;
   if (!header) {
-    header_value_string = UnspecifiedValueString;
-  } else {
-    header_value_string = header->value().c_str();
+    output += UnspecifiedValueString;
+    return;
   }
 
-  if (max_length_.valid() && header_value_string.length() > max_length_.value()) {
-    return header_value_string.substr(0, max_length_.value());
+  const Http::HeaderString& value = header->value();
+  size_t length = value.size();
+  if (max_length_.valid() && length > max_length_.value()) {
+    length = max_length_.value();
   }
 
-  return header_value_string;
+  output.append(value.c_str(), length);
 }
 
 ResponseHeaderFormatter::ResponseHeaderFormatter(const std::string& main_header,
@@ -286,10 +324,11 @@ ResponseHeaderFormatter::ResponseHeaderFormatter(const std::string& main_header,
                                                  const Optional<size_t>& max_length)
     : HeaderFormatter(main_header, alternative_header, max_length) {}
 
-std::string ResponseHeaderFormatter::format(const Http::HeaderMap&,
-                                            const Http::HeaderMap& response_headers,
-                                            const RequestInfo::RequestInfo&) const {
-  return HeaderFormatter::format(response_headers);
+void ResponseHeaderFormatter::formatInto(const Http::HeaderMap&,
+                                         const Http::HeaderMap& response_headers,
+                                         const RequestInfo::RequestInfo&,
+                                         std::string& output) const {
+  HeaderFormatter::formatInto(response_headers, output);
 }
 
 RequestHeaderFormatter::RequestHeaderFormatter(const std::string& main_header,
@@ -297,10 +336,10 @@ RequestHeaderFormatter::RequestHeaderFormatter(const std::string& main_header,
                                                const Optional<size_t>& max_length)
     : HeaderFormatter(main_header, alternative_header, max_length) {}
 
-std::string RequestHeaderFormatter::format(const Http::HeaderMap& request_headers,
-                                           const Http::HeaderMap&,
-                                           const RequestInfo::RequestInfo&) const {
-  return HeaderFormatter::format(request_headers);
+void RequestHeaderFormatter::formatInto(const Http::HeaderMap& request_headers,
+                                        const Http::HeaderMap&, const RequestInfo::RequestInfo&,
+                                        std::string& output) const {
+  HeaderFormatter::formatInto(request_headers, output);
 }
 
 } // namespace AccessLog
@@ -37,16 +37,28 @@ private:
 };
 
 /**
- * Composite formatter implementation.
+ * Base class for formatters that implement formatInto(). format() is implemented on top of it.
  */
-class FormatterImpl : public Formatter {
+class FormatterBase : public Formatter {
 public:
-  FormatterImpl(const std::string& format);
-
   // Formatter::format
   std::string format(const Http::HeaderMap& request_headers,
                      const Http::HeaderMap& response_headers,
                      const RequestInfo::RequestInfo& request_info) const override;
+};
+
+/**
+ * Composite formatter implementation. The format string is parsed once into a list of field
+ * formatters, each of which appends directly to the output string.
+ */
+class FormatterImpl : public FormatterBase {
+public:
+  FormatterImpl(const std::string& format);
+
+  // Formatter::formatInto
+  void formatInto(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                  const RequestInfo::RequestInfo& request_info,
+                  std::string& output) const override;
 
 private:
   std::vector<FormatterPtr> formatters_;
@@ -56,13 +68,13 @@ private:
  * Formatter for string literal. It ignores headers and request info and returns string by which it
  * was initialized.
  */
-class PlainStringFormatter : public Formatter {
+class PlainStringFormatter : public FormatterBase {
 public:
   PlainStringFormatter(const std::string& str);
 
-  // Formatter::format
-  std::string format(const Http::HeaderMap&, const Http::HeaderMap&,
-                     const RequestInfo::RequestInfo&) const override;
+  // Formatter::formatInto
+  void formatInto(const Http::HeaderMap&, const Http::HeaderMap&, const RequestInfo::RequestInfo&,
+                  std::string& output) const override;
 
 private:
   std::string str_;
@@ -73,53 +85,68 @@ public:
   HeaderFormatter(const std::string& main_header, const std::string& alternative_header,
                   const Optional<size_t>& max_length);
 
-  std::string format(const Http::HeaderMap& headers) const;
+  void formatInto(const Http::HeaderMap& headers, std::string& output) const;
 
 private:
+  typedef const Http::HeaderEntry* (Http::HeaderMap::*InlineHeaderGetter)() const;
+
+  /**
+   * @return the accessor of the inline header with the given name, or nullptr if the header is not
+   *         one of the inline headers.
+   */
+  static InlineHeaderGetter inlineHeaderGetter(const Http::LowerCaseString& header);
+
+  const Http::HeaderEntry* get(const Http::HeaderMap& headers, const Http::LowerCaseString& header,
+                               InlineHeaderGetter getter) const;
+
   Http::LowerCaseString main_header_;
   Http::LowerCaseString alternative_header_;
+  // Inline headers are read with their accessor, which avoids a scan of the header map.
+  InlineHeaderGetter main_header_getter_;
+  InlineHeaderGetter alternative_header_getter_;
   Optional<size_t> max_length_;
 };
 
 /**
  * Formatter based on request header.
  */
-class RequestHeaderFormatter : public Formatter, HeaderFormatter {
+class RequestHeaderFormatter : public FormatterBase, HeaderFormatter {
 public:
   RequestHeaderFormatter(const std::string& main_header, const std::string& alternative_header,
                          const Optional<size_t>& max_length);
 
-  // Formatter::format
-  std::string format(const Http::HeaderMap& request_headers, const Http::HeaderMap&,
-                     const RequestInfo::RequestInfo&) const override;
+  // Formatter::formatInto
+  void formatInto(const Http::HeaderMap& request_headers, const Http::HeaderMap&,
+                  const RequestInfo::RequestInfo&, std::string& output) const override;
 };
 
 /**
  * Formatter based on the response header.
  */
-class ResponseHeaderFormatter : public Formatter, HeaderFormatter {
+class ResponseHeaderFormatter : public FormatterBase, HeaderFormatter {
 public:
   ResponseHeaderFormatter(const std::string& main_header, const std::string& alternative_header,
                           const Optional<size_t>& max_length);
 
-  // Formatter::format
-  std::string format(const Http::HeaderMap&, const Http::HeaderMap& response_headers,
-                     const RequestInfo::RequestInfo&) const override;
+  // Formatter::formatInto
+  void formatInto(const Http::HeaderMap&, const Http::HeaderMap& response_headers,
+                  const RequestInfo::RequestInfo&, std::string& output) const override;
 };
 
 /**
  * Formatter based on the RequestInfo field.
  */
-class RequestInfoFormatter : public Formatter {
+class RequestInfoFormatter : public FormatterBase {
 public:
   RequestInfoFormatter(const std::string& field_name);
 
-  // Formatter::format
-  std::string format(const Http::HeaderMap&, const Http::HeaderMap&,
-                     const RequestInfo::RequestInfo& request_info) const override;
+  // Formatter::formatInto
+  void formatInto(const Http::HeaderMap&, const Http::HeaderMap&,
+                  const RequestInfo::RequestInfo& request_info,
+                  std::string& output) const override;
 
 private:
-  std::function<std::string(const RequestInfo::RequestInfo&)> field_extractor_;
+  std::function<void(const RequestInfo::RequestInfo&, std::string&)> field_extractor_;
 };
 
 } // namespace AccessLog
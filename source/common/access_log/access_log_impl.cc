@@ -191,7 +191,11 @@ void FileAccessLog::log(const Http::HeaderMap* request_headers,
     }
   }
 
-  log_file_->write(formatter_->format(*request_headers, *response_headers, request_info));
+  // Log lines are rendered into a per thread string so that its capacity is reused.
+  static thread_local std::string log_line;
+  log_line.clear();
+  formatter_->formatInto(*request_headers, *response_headers, request_info, log_line);
+  log_file_->write(log_line);
 }
 
 } // namespace AccessLog
@@ -0,0 +1,57 @@
+#include "common/access_log/binary_file_access_log_impl.h"
+
+#include <string>
+
+#include "envoy/config/filter/accesslog/v2/accesslog.pb.h"
+
+#include "common/access_log/grpc_access_log_impl.h"
+#include "common/http/header_map_impl.h"
+#include "common/protobuf/protobuf.h"
+
+namespace Envoy {
+namespace AccessLog {
+
+BinaryFileAccessLog::BinaryFileAccessLog(const std::string& access_log_path, FilterPtr&& filter,
+                                         AccessLogManager& log_manager)
+    : log_file_(log_manager.createAccessLog(access_log_path)), filter_(std::move(filter)) {}
+
+void BinaryFileAccessLog::log(const Http::HeaderMap* request_headers,
+                              const Http::HeaderMap* response_headers,
+                              const RequestInfo::RequestInfo& request_info) {
+  static Http::HeaderMapImpl empty_headers;
+  if (!request_headers) {
+    request_headers = &empty_headers;
+  }
+  if (!response_headers) {
+    response_headers = &empty_headers;
+  }
+
+  if (filter_) {
+    if (!filter_->evaluate(request_info, *request_headers)) {
+      return;
+    }
+  }
+
+  // The entry and the output string are per thread so that the memory of the previous log line is
+  // reused. Clear() keeps the allocated sub-messages and strings around.
+  static thread_local envoy::config::filter::accesslog::v2::HTTPAccessLogEntry log_entry;
+  static thread_local std::string record;
+  log_entry.Clear();
+  record.clear();
+
+  HttpGrpcAccessLog::populateLogEntry(log_entry, *request_headers, *response_headers,
+                                      request_info);
+
+  const uint32_t size = log_entry.ByteSize();
+  {
+    Protobuf::io::StringOutputStream string_stream(&record);
+    Protobuf::io::CodedOutputStream coded_stream(&string_stream);
+    coded_stream.WriteVarint32(size);
+    log_entry.SerializeWithCachedSizes(&coded_stream);
+  }
+
+  log_file_->write(record);
+}
+
+} // namespace AccessLog
+} // namespace Envoy
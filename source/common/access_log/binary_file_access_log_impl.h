@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/filesystem/filesystem.h"
+
+namespace Envoy {
+namespace AccessLog {
+
+/**
+ * Access log Instance that writes HTTP logs to a file as length delimited
+ * envoy.config.filter.accesslog.v2.HTTPAccessLogEntry messages: each entry is preceded by its size
+ * as a varint32, which is the framing read by the protobuf parseDelimitedFrom() family of
+ * functions. The entries are identical to the ones sent by HttpGrpcAccessLog, so offline pipelines
+ * can ingest them without parsing text.
+ */
+class BinaryFileAccessLog : public Instance {
+public:
+  BinaryFileAccessLog(const std::string& access_log_path, FilterPtr&& filter,
+                      AccessLogManager& log_manager);
+
+  // AccessLog::Instance
+  void log(const Http::HeaderMap* request_headers, const Http::HeaderMap* response_headers,
+           const RequestInfo::RequestInfo& request_info) override;
+
+private:
+  Filesystem::FileSharedPtr log_file_;
+  FilterPtr filter_;
+};
+
+} // namespace AccessLog
+} // namespace Envoy
@@ -139,8 +139,17 @@ void HttpGrpcAccessLog::log(const Http::HeaderMap* request_headers,
   }
 
   envoy::service::accesslog::v2::StreamAccessLogsMessage message;
-  auto* log_entry = message.mutable_http_logs()->add_log_entry();
+  populateLogEntry(*message.mutable_http_logs()->add_log_entry(), *request_headers,
+                   *response_headers, request_info);
 
+  // TODO(mattklein123): Consider batching multiple logs and flushing.
+  grpc_access_log_streamer_->send(message, config_.common_config().log_name());
+}
+
+void HttpGrpcAccessLog::populateLogEntry(
+    envoy::config::filter::accesslog::v2::HTTPAccessLogEntry& log_entry,
+    const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+    const RequestInfo::RequestInfo& request_info) {
   // Common log properties.
   // TODO(mattklein123): Populate sample_rate field.
   // TODO(mattklein123): Populate tls_properties field.
@@ -149,7 +158,7 @@ void HttpGrpcAccessLog::log(const Http::HeaderMap* request_headers,
   // TODO(mattklein123): Populate time_to_last_upstream_rx_byte field.
   // TODO(mattklein123): Populate time_to_first_downstream_tx_byte field.
   // TODO(mattklein123): Populate metadata field and wire up to filters.
-  auto* common_properties = log_entry->mutable_common_properties();
+  auto* common_properties = log_entry.mutable_common_properties();
 
   if (request_info.downstreamRemoteAddress() != nullptr) {
     Network::Utility::addressToProtobufAddress(
@@ -193,15 +202,15 @@ void HttpGrpcAccessLog::log(const Http::HeaderMap* request_headers,
   if (request_info.protocol().valid()) {
     switch (request_info.protocol().value()) {
     case Http::Protocol::Http10:
-      log_entry->set_protocol_version(
+      log_entry.set_protocol_version(
           envoy::config::filter::accesslog::v2::HTTPAccessLogEntry::HTTP10);
       break;
     case Http::Protocol::Http11:
-      log_entry->set_protocol_version(
+      log_entry.set_protocol_version(
           envoy::config::filter::accesslog::v2::HTTPAccessLogEntry::HTTP11);
       break;
     case Http::Protocol::Http2:
-      log_entry->set_protocol_version(
+      log_entry.set_protocol_version(
           envoy::config::filter::accesslog::v2::HTTPAccessLogEntry::HTTP2);
       break;
     }
@@ -210,45 +219,42 @@ void HttpGrpcAccessLog::log(const Http::HeaderMap* request_headers,
   // HTTP request properities.
   // TODO(mattklein123): Populate port field.
   // TODO(mattklein123): Populate custom request headers.
-  auto* request_properties = log_entry->mutable_request();
-  if (request_headers->Scheme() != nullptr) {
-    request_properties->set_scheme(request_headers->Scheme()->value().c_str());
+  auto* request_properties = log_entry.mutable_request();
+  if (request_headers.Scheme() != nullptr) {
+    request_properties->set_scheme(request_headers.Scheme()->value().c_str());
   }
-  if (request_headers->Host() != nullptr) {
-    request_properties->set_authority(request_headers->Host()->value().c_str());
+  if (request_headers.Host() != nullptr) {
+    request_properties->set_authority(request_headers.Host()->value().c_str());
   }
-  if (request_headers->Path() != nullptr) {
-    request_properties->set_path(request_headers->Path()->value().c_str());
+  if (request_headers.Path() != nullptr) {
+    request_properties->set_path(request_headers.Path()->value().c_str());
   }
-  if (request_headers->UserAgent() != nullptr) {
-    request_properties->set_user_agent(request_headers->UserAgent()->value().c_str());
+  if (request_headers.UserAgent() != nullptr) {
+    request_properties->set_user_agent(request_headers.UserAgent()->value().c_str());
   }
-  if (request_headers->Referer() != nullptr) {
-    request_properties->set_referer(request_headers->Referer()->value().c_str());
+  if (request_headers.Referer() != nullptr) {
+    request_properties->set_referer(request_headers.Referer()->value().c_str());
   }
-  if (request_headers->ForwardedFor() != nullptr) {
-    request_properties->set_forwarded_for(request_headers->ForwardedFor()->value().c_str());
+  if (request_headers.ForwardedFor() != nullptr) {
+    request_properties->set_forwarded_for(request_headers.ForwardedFor()->value().c_str());
   }
-  if (request_headers->RequestId() != nullptr) {
-    request_properties->set_request_id(request_headers->RequestId()->value().c_str());
+  if (request_headers.RequestId() != nullptr) {
+    request_properties->set_request_id(request_headers.RequestId()->value().c_str());
   }
-  if (request_headers->EnvoyOriginalPath() != nullptr) {
-    request_properties->set_original_path(request_headers->EnvoyOriginalPath()->value().c_str());
+  if (request_headers.EnvoyOriginalPath() != nullptr) {
+    request_properties->set_original_path(request_headers.EnvoyOriginalPath()->value().c_str());
   }
-  request_properties->set_request_headers_bytes(request_headers->byteSize());
+  request_properties->set_request_headers_bytes(request_headers.byteSize());
   request_properties->set_request_body_bytes(request_info.bytesReceived());
 
   // HTTP response properties.
   // TODO(mattklein123): Populate custom response headers.
-  auto* response_properties = log_entry->mutable_response();
+  auto* response_properties = log_entry.mutable_response();
   if (request_info.responseCode().valid()) {
     response_properties->mutable_response_code()->set_value(request_info.responseCode().value());
   }
-  response_properties->set_response_headers_bytes(response_headers->byteSize());
+  response_properties->set_response_headers_bytes(response_headers.byteSize());
   response_properties->set_response_body_bytes(request_info.bytesSent());
-
-  // TODO(mattklein123): Consider batching multiple logs and flushing.
-  grpc_access_log_streamer_->send(message, config_.common_config().log_name());
 }
 
 } // namespace AccessLog
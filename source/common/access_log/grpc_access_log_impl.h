@@ -118,6 +118,19 @@ public:
       envoy::config::filter::accesslog::v2::AccessLogCommon& common_access_log,
       const RequestInfo::RequestInfo& request_info);
 
+  /**
+   * Fill in an HTTP access log entry. This is also used by BinaryFileAccessLog so that both sinks
+   * emit identical entries.
+   * @param log_entry supplies the entry to fill in. It is expected to be empty.
+   * @param request_headers supplies the request headers.
+   * @param response_headers supplies the response headers.
+   * @param request_info supplies the request info.
+   */
+  static void populateLogEntry(envoy::config::filter::accesslog::v2::HTTPAccessLogEntry& log_entry,
+                               const Http::HeaderMap& request_headers,
+                               const Http::HeaderMap& response_headers,
+                               const RequestInfo::RequestInfo& request_info);
+
   // AccessLog::Instance
   void log(const Http::HeaderMap* request_headers, const Http::HeaderMap* response_headers,
            const RequestInfo::RequestInfo& request_info) override;
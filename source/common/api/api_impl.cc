@@ -4,7 +4,6 @@
 #include <string>
 
 #include "common/event/dispatcher_impl.h"
-#include "common/filesystem/filesystem_impl.h"
 
 namespace Envoy {
 namespace Api {
@@ -18,8 +17,8 @@ Impl::Impl(std::chrono::milliseconds file_flush_interval_msec)
 
 Filesystem::FileSharedPtr Impl::createFile(const std::string& path, Event::Dispatcher& dispatcher,
                                            Thread::BasicLockable& lock, Stats::Store& stats_store) {
-  return std::make_shared<Filesystem::FileImpl>(path, dispatcher, lock, stats_store,
-                                                file_flush_interval_msec_);
+  return std::make_shared<Filesystem::FileImpl>(path, dispatcher, lock, file_flush_thread_,
+                                                stats_store, file_flush_interval_msec_);
 }
 
 bool Impl::fileExists(const std::string& path) { return Filesystem::fileExists(path); }
@@ -6,6 +6,8 @@
 #include "envoy/api/api.h"
 #include "envoy/filesystem/filesystem.h"
 
+#include "common/filesystem/filesystem_impl.h"
+
 namespace Envoy {
 namespace Api {
 
@@ -26,6 +28,8 @@ public:
 
 private:
   std::chrono::milliseconds file_flush_interval_msec_;
+  // Shared by all the files created by this Api. Files must be destroyed before the Api.
+  Filesystem::FlushThread file_flush_thread_;
 };
 
 } // namespace Api
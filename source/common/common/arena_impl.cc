@@ -0,0 +1,94 @@
+#include "common/common/arena_impl.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+
+const size_t ArenaImpl::BLOCK_SIZE;
+const size_t ArenaImpl::MAX_CACHED_BLOCKS;
+thread_local ArenaImpl::BlockCache ArenaImpl::block_cache_;
+
+ArenaImpl::BlockCache::~BlockCache() {
+  while (head_ != nullptr) {
+    Block* next = head_->next_;
+    ::free(head_);
+    head_ = next;
+  }
+}
+
+ArenaImpl::~ArenaImpl() {
+  while (blocks_ != nullptr) {
+    Block* next = blocks_->next_;
+    releaseBlock(blocks_);
+    blocks_ = next;
+  }
+}
+
+void* ArenaImpl::allocate(size_t size, size_t alignment) {
+  ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+  bytes_allocated_ += size;
+
+  uint8_t* aligned = reinterpret_cast<uint8_t*>(
+      (reinterpret_cast<uintptr_t>(current_) + alignment - 1) & ~(alignment - 1));
+  if (current_ != nullptr && aligned + size <= end_) {
+    current_ = aligned + size;
+    return aligned;
+  }
+
+  // Block data is aligned to alignof(std::max_align_t) so only over aligned types need padding.
+  const size_t padded_size = size + (alignment > alignof(std::max_align_t) ? alignment : 0);
+  if (padded_size > BLOCK_SIZE / 4) {
+    // Large allocations get their own block so that the current block is not wasted. It is linked
+    // behind the current block. Blocks are never smaller than BLOCK_SIZE so that they can be cached.
+    Block* block = acquireBlock(std::max(padded_size, BLOCK_SIZE));
+    if (blocks_ != nullptr) {
+      block->next_ = blocks_->next_;
+      blocks_->next_ = block;
+    } else {
+      block->next_ = nullptr;
+      blocks_ = block;
+    }
+    return reinterpret_cast<uint8_t*>(
+        (reinterpret_cast<uintptr_t>(block->data()) + alignment - 1) & ~(alignment - 1));
+  }
+
+  Block* block = acquireBlock(BLOCK_SIZE);
+  block->next_ = blocks_;
+  blocks_ = block;
+  aligned = reinterpret_cast<uint8_t*>(
+      (reinterpret_cast<uintptr_t>(block->data()) + alignment - 1) & ~(alignment - 1));
+  current_ = aligned + size;
+  end_ = block->data() + BLOCK_SIZE;
+  return aligned;
+}
+
+size_t ArenaImpl::cachedBlocks() { return block_cache_.size_; }
+
+ArenaImpl::Block* ArenaImpl::acquireBlock(size_t size) {
+  if (size == BLOCK_SIZE && block_cache_.head_ != nullptr) {
+    Block* block = block_cache_.head_;
+    block_cache_.head_ = block->next_;
+    block_cache_.size_--;
+    return block;
+  }
+
+  Block* block = static_cast<Block*>(::malloc(sizeof(Block) + size));
+  RELEASE_ASSERT(block != nullptr);
+  block->size_ = size;
+  return block;
+}
+
+void ArenaImpl::releaseBlock(Block* block) {
+  if (block->size_ == BLOCK_SIZE && block_cache_.size_ < MAX_CACHED_BLOCKS) {
+    block->next_ = block_cache_.head_;
+    block_cache_.head_ = block;
+    block_cache_.size_++;
+  } else {
+    ::free(block);
+  }
+}
+
+} // namespace Envoy
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "envoy/common/arena.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * Arena implementation that carves allocations out of fixed size blocks. Blocks released by a
+ * destroyed arena are kept in a small per thread cache and reused by the next arena created on that
+ * thread, so in steady state creating and destroying an arena (e.g., one per HTTP stream on a
+ * worker) does not touch the global allocator. Allocations that are too large to share a block
+ * get a dedicated block, which is only cached if it fits in BLOCK_SIZE.
+ */
+class ArenaImpl : public Arena, NonCopyable {
+public:
+  static const size_t BLOCK_SIZE = 4096;
+  static const size_t MAX_CACHED_BLOCKS = 64;
+
+  ArenaImpl() {}
+  ~ArenaImpl();
+
+  // Arena
+  void* allocate(size_t size, size_t alignment) override;
+
+  /**
+   * @return uint64_t the total number of bytes allocated from the arena.
+   */
+  uint64_t bytesAllocated() const { return bytes_allocated_; }
+
+  /**
+   * @return size_t the number of blocks currently cached by the calling thread.
+   */
+  static size_t cachedBlocks();
+
+private:
+  struct Block {
+    Block* next_;
+    size_t size_;
+
+    uint8_t* data() { return reinterpret_cast<uint8_t*>(this + 1); }
+  };
+
+  // Block data directly follows the block header so the header size must preserve the alignment
+  // guaranteed by malloc().
+  static_assert(sizeof(Block) % alignof(std::max_align_t) == 0,
+                "arena block header breaks alignment");
+
+  // Per thread cache of BLOCK_SIZE blocks. Cached blocks are freed when the thread exits.
+  struct BlockCache {
+    ~BlockCache();
+
+    Block* head_{};
+    size_t size_{};
+  };
+
+  static Block* acquireBlock(size_t size);
+  static void releaseBlock(Block* block);
+
+  static thread_local BlockCache block_cache_;
+
+  // All the blocks owned by the arena. The first block is the one currently being carved up.
+  Block* blocks_{};
+  uint8_t* current_{};
+  uint8_t* end_{};
+  uint64_t bytes_allocated_{};
+};
+
+} // namespace Envoy
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "common/common/assert.h"
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * Unbounded multi-producer single-consumer FIFO queue. push() never blocks on other producers or
+ * on the consumer. pop() must only be called from a single consumer thread at a time.
+ *
+ * This is the intrusive queue described by Dmitry Vyukov. A consumer can briefly see the queue as
+ * empty while a producer is between its exchange and linking its node; pop() then returns false
+ * and the element becomes visible to a later pop().
+ *
+ * The nodes come from a pool that is allocated with the queue, so that pushing does not allocate
+ * while fewer than pool_size elements are queued. Free pool nodes are kept on a lock-free stack
+ * which producers pop from and the consumer pushes back to. Only when the pool is exhausted is a
+ * node allocated, and it is freed rather than pooled once it has been popped.
+ */
+template <class T> class MpscQueue : NonCopyable {
+public:
+  /**
+   * @param pool_size supplies the number of nodes to allocate with the queue.
+   */
+  explicit MpscQueue(uint32_t pool_size = 0)
+      : pool_(new Node[pool_size]), pool_size_(pool_size), head_(&stub_), tail_(&stub_) {
+    ASSERT(pool_size < NO_NODE);
+    for (uint32_t i = 0; i < pool_size; i++) {
+      pool_[i].next_free_.store(i + 1 < pool_size ? i + 1 : NO_NODE, std::memory_order_relaxed);
+    }
+    free_head_.store(pool_size > 0 ? 0 : NO_NODE, std::memory_order_release);
+  }
+
+  ~MpscQueue() {
+    T value;
+    while (pop(value)) {
+    }
+  }
+
+  /**
+   * Add an element to the back of the queue. May be called from any thread.
+   */
+  void push(T&& value) { pushNode(allocNode(std::move(value))); }
+
+  /**
+   * Remove the element at the front of the queue. Must only be called by the consumer.
+   * @param value supplies where to move the element.
+   * @return true if an element was removed, false if the queue is empty or the next element has
+   *         not been fully published yet.
+   */
+  bool pop(T& value) {
+    Node* head = head_;
+    Node* next = head->next_.load(std::memory_order_acquire);
+    if (head == &stub_) {
+      if (next == nullptr) {
+        return false;
+      }
+      head_ = next;
+      head = next;
+      next = next->next_.load(std::memory_order_acquire);
+    }
+
+    if (next == nullptr) {
+      if (head != tail_.load(std::memory_order_acquire)) {
+        // A producer has swapped in a new tail but not yet linked it.
+        return false;
+      }
+
+      // head is the last node. Push the stub behind it so that head can be unlinked.
+      pushNode(&stub_);
+      next = head->next_.load(std::memory_order_acquire);
+      if (next == nullptr) {
+        return false;
+      }
+    }
+
+    head_ = next;
+    value = std::move(head->value_);
+    ASSERT(head != &stub_);
+    releaseNode(head);
+    return true;
+  }
+
+private:
+  // The index of no node, which ends the free stack.
+  static const uint32_t NO_NODE = UINT32_MAX;
+
+  struct Node {
+    Node() {}
+    Node(T&& value) : value_(std::move(value)) {}
+
+    std::atomic<Node*> next_{nullptr};
+    // The next node on the free stack, for pool nodes that are not queued.
+    std::atomic<uint32_t> next_free_{NO_NODE};
+    T value_;
+  };
+
+  // The free stack head packs the index of the top node with a tag that changes on every push and
+  // pop. A producer that read an old head then fails its compare_exchange even if the same node
+  // has since been popped and pushed back with a different next node.
+  static uint64_t freeHead(uint32_t index, uint64_t previous) {
+    return (((previous >> 32) + 1) << 32) | index;
+  }
+  static uint32_t nodeIndex(uint64_t free_head) { return static_cast<uint32_t>(free_head); }
+
+  Node* allocNode(T&& value) {
+    uint64_t free_head = free_head_.load(std::memory_order_acquire);
+    while (nodeIndex(free_head) != NO_NODE) {
+      Node& node = pool_[nodeIndex(free_head)];
+      const uint64_t next_head =
+          freeHead(node.next_free_.load(std::memory_order_relaxed), free_head);
+      if (free_head_.compare_exchange_weak(free_head, next_head, std::memory_order_acquire,
+                                           std::memory_order_acquire)) {
+        node.value_ = std::move(value);
+        return &node;
+      }
+    }
+
+    return new Node(std::move(value));
+  }
+
+  void releaseNode(Node* node) {
+    const std::less<const Node*> less;
+    if (less(node, pool_.get()) || !less(node, pool_.get() + pool_size_)) {
+      delete node;
+      return;
+    }
+
+    const uint32_t index = node - pool_.get();
+    uint64_t free_head = free_head_.load(std::memory_order_relaxed);
+    do {
+      node->next_free_.store(nodeIndex(free_head), std::memory_order_relaxed);
+    } while (!free_head_.compare_exchange_weak(free_head, freeHead(index, free_head),
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed));
+  }
+
+  void pushNode(Node* node) {
+    node->next_.store(nullptr, std::memory_order_relaxed);
+    Node* prev = tail_.exchange(node, std::memory_order_acq_rel);
+    prev->next_.store(node, std::memory_order_release);
+  }
+
+  const std::unique_ptr<Node[]> pool_;
+  const uint32_t pool_size_;
+  std::atomic<uint64_t> free_head_;
+  // Only accessed by the consumer.
+  Node* head_;
+  std::atomic<Node*> tail_;
+  Node stub_;
+};
+
+} // namespace Envoy
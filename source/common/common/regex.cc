@@ -0,0 +1,52 @@
+#include "common/common/regex.h"
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/utility.h"
+
+namespace Envoy {
+namespace Regex {
+
+namespace {
+
+re2::RE2::Options re2Options() {
+  re2::RE2::Options options;
+  // Errors are reported via exception below instead of being logged by RE2.
+  options.set_log_errors(false);
+  return options;
+}
+
+} // namespace
+
+CompiledStdMatcher::CompiledStdMatcher(const std::string& regex)
+    : regex_(RegexUtil::parseRegex(regex)) {}
+
+bool CompiledStdMatcher::match(absl::string_view value) const {
+  return std::regex_match(value.begin(), value.end(), regex_);
+}
+
+CompiledRe2Matcher::CompiledRe2Matcher(const std::string& regex) : regex_(regex, re2Options()) {
+  if (!regex_.ok()) {
+    throw EnvoyException(fmt::format("Invalid regex '{}': {}", regex, regex_.error()));
+  }
+}
+
+bool CompiledRe2Matcher::match(absl::string_view value) const {
+  return re2::RE2::FullMatch(re2::StringPiece(value.data(), value.size()), regex_);
+}
+
+CompiledMatcherPtr Utility::parseRegex(const std::string& regex, Engine engine) {
+  switch (engine) {
+  case Engine::StdRegex:
+    return CompiledMatcherPtr{new CompiledStdMatcher(regex)};
+  case Engine::Re2:
+    return CompiledMatcherPtr{new CompiledRe2Matcher(regex)};
+  }
+
+  NOT_REACHED;
+}
+
+} // namespace Regex
+} // namespace Envoy
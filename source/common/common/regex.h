@@ -0,0 +1,58 @@
+#pragma once
+
+#include <regex>
+#include <string>
+
+#include "envoy/common/regex.h"
+
+#include "re2/re2.h"
+
+namespace Envoy {
+namespace Regex {
+
+/**
+ * CompiledMatcher backed by std::regex.
+ */
+class CompiledStdMatcher : public CompiledMatcher {
+public:
+  CompiledStdMatcher(const std::string& regex);
+
+  // Regex::CompiledMatcher
+  bool match(absl::string_view value) const override;
+
+private:
+  const std::regex regex_;
+};
+
+/**
+ * CompiledMatcher backed by RE2. The compiled automaton is owned by the matcher so it is built once
+ * per configured pattern.
+ */
+class CompiledRe2Matcher : public CompiledMatcher {
+public:
+  CompiledRe2Matcher(const std::string& regex);
+
+  // Regex::CompiledMatcher
+  bool match(absl::string_view value) const override;
+
+private:
+  const re2::RE2 regex_;
+};
+
+/**
+ * Utilities for constructing compiled regular expression matchers.
+ */
+class Utility {
+public:
+  /**
+   * Compile a regular expression for full string matching.
+   * @param regex supplies the regular expression.
+   * @param engine supplies the engine that will be used to match the expression.
+   * @return CompiledMatcherPtr the compiled matcher.
+   * @throw EnvoyException if the regex string is invalid for the selected engine.
+   */
+  static CompiledMatcherPtr parseRegex(const std::string& regex, Engine engine);
+};
+
+} // namespace Regex
+} // namespace Envoy
@@ -186,6 +186,8 @@ class AccessLogNameValues {
 public:
   // File access log
   const std::string FILE = "envoy.file_access_log";
+  // Binary (length delimited protobuf) file access log
+  const std::string BINARY_FILE = "envoy.binary_file_access_log";
   // HTTP gRPC access log
   const std::string HTTP_GRPC = "envoy.http_grpc_access_log";
 };
@@ -8,7 +8,6 @@
 #include "envoy/stats/stats.h"
 
 #include "common/dynamo/dynamo_request_parser.h"
-#include "common/json/json_loader.h"
 
 namespace Envoy {
 namespace Dynamo {
@@ -18,6 +17,8 @@ namespace Dynamo {
  * It captures RPS/latencies:
  *  1) Per table per response code (and group of response codes, e.g., 2xx/3xx/etc)
  *  2) Per operation per response code (and group of response codes, e.g., 2xx/3xx/etc)
+ * The request and response bodies are parsed as they stream through the filter, without being
+ * buffered.
  */
 class DynamoFilter : public Http::StreamFilter {
 public:
@@ -49,15 +50,14 @@ public:
   }
 
 private:
-  void onDecodeComplete(const Buffer::Instance& data);
-  void onEncodeComplete(const Buffer::Instance& data);
-  std::string buildBody(const Buffer::Instance* buffered, const Buffer::Instance& last);
+  void onDecodeComplete();
+  void onEncodeComplete();
   void chargeBasicStats(uint64_t status);
   void chargeStatsPerEntity(const std::string& entity, const std::string& entity_type,
                             uint64_t status);
-  void chargeFailureSpecificStats(const Json::Object& json_body);
-  void chargeUnProcessedKeysStats(const Json::Object& json_body);
-  void chargeTablePartitionIdStats(const Json::Object& json_body);
+  void chargeFailureSpecificStats();
+  void chargeUnProcessedKeysStats();
+  void chargeTablePartitionIdStats();
 
   Runtime::Loader& runtime_;
   std::string stat_prefix_;
@@ -66,7 +66,8 @@ private:
   bool enabled_{};
   std::string operation_{};
   RequestParser::TableDescriptor table_descriptor_{"", true};
-  std::string error_type_{};
+  BodyParser request_body_;
+  BodyParser response_body_;
   MonotonicTime start_decode_;
   Http::HeaderMap* response_headers_;
   Http::StreamDecoderFilterCallbacks* decoder_callbacks_{};
@@ -69,11 +69,9 @@ RequestParser::TableDescriptor RequestParser::parseTable(const std::string& oper
   TableDescriptor table{"", true};
 
   // Simple operations on a single table, have "TableName" explicitly specified.
-  if (find(SINGLE_TABLE_OPERATIONS.begin(), SINGLE_TABLE_OPERATIONS.end(), operation) !=
-      SINGLE_TABLE_OPERATIONS.end()) {
+  if (isSingleTableOperation(operation)) {
     table.table_name = json_data.getString("TableName", "");
-  } else if (find(BATCH_OPERATIONS.begin(), BATCH_OPERATIONS.end(), operation) !=
-             BATCH_OPERATIONS.end()) {
+  } else if (isBatchOperation(operation)) {
     Json::ObjectSharedPtr tables = json_data.getObject("RequestItems", true);
     tables->iterate([&table](const std::string& key, const Json::Object&) {
       if (table.table_name.empty()) {
@@ -102,7 +100,10 @@ std::vector<std::string> RequestParser::parseBatchUnProcessedKeys(const Json::Ob
   return unprocessed_tables;
 }
 std::string RequestParser::parseErrorType(const Json::Object& json_data) {
-  std::string error_type = json_data.getString("__type", "");
+  return parseErrorType(json_data.getString("__type", ""));
+}
+
+std::string RequestParser::parseErrorType(const std::string& error_type) {
   if (error_type.empty()) {
     return "";
   }
@@ -121,6 +122,11 @@ bool RequestParser::isBatchOperation(const std::string& operation) {
          BATCH_OPERATIONS.end();
 }
 
+bool RequestParser::isSingleTableOperation(const std::string& operation) {
+  return find(SINGLE_TABLE_OPERATIONS.begin(), SINGLE_TABLE_OPERATIONS.end(), operation) !=
+         SINGLE_TABLE_OPERATIONS.end();
+}
+
 std::vector<RequestParser::PartitionDescriptor>
 RequestParser::parsePartitions(const Json::Object& json_data) {
   std::vector<RequestParser::PartitionDescriptor> partition_descriptors;
@@ -141,5 +147,100 @@ RequestParser::parsePartitions(const Json::Object& json_data) {
   return partition_descriptors;
 }
 
+void BodyParser::parse(const Buffer::Instance& data) {
+  if (data.length() == 0) {
+    return;
+  }
+  empty_ = false;
+  if (!valid_) {
+    return;
+  }
+
+  uint64_t num_slices = data.getRawSlices(nullptr, 0);
+  Buffer::RawSlice slices[num_slices];
+  data.getRawSlices(slices, num_slices);
+  try {
+    for (const Buffer::RawSlice& slice : slices) {
+      parser_.parse(static_cast<const char*>(slice.mem_), slice.len_);
+    }
+  } catch (const Json::Exception&) {
+    valid_ = false;
+  }
+}
+
+bool BodyParser::finish() {
+  if (valid_) {
+    try {
+      parser_.finish();
+    } catch (const Json::Exception&) {
+      valid_ = false;
+    }
+  }
+
+  return valid_;
+}
+
+RequestParser::TableDescriptor BodyParser::table(const std::string& operation) const {
+  RequestParser::TableDescriptor table{"", true};
+
+  if (RequestParser::isSingleTableOperation(operation)) {
+    table.table_name = table_name_;
+  } else if (RequestParser::isBatchOperation(operation)) {
+    for (const std::string& request_table : request_tables_) {
+      if (table.table_name.empty()) {
+        table.table_name = request_table;
+      } else if (table.table_name != request_table) {
+        table.table_name = "";
+        table.is_single_table = false;
+        break;
+      }
+    }
+  }
+
+  return table;
+}
+
+void BodyParser::onStartContainer(bool object) {
+  path_.push_back({key_, object});
+  key_.clear();
+}
+
+void BodyParser::onEndContainer() {
+  path_.pop_back();
+  key_.clear();
+}
+
+void BodyParser::onKey(const std::string& key) {
+  key_ = key;
+
+  // The keys of the top level RequestItems and UnprocessedKeys objects are table names.
+  if (path_.size() == 2) {
+    if (path_[1].key_ == "RequestItems") {
+      request_tables_.push_back(key);
+    } else if (path_[1].key_ == "UnprocessedKeys") {
+      unprocessed_tables_.push_back(key);
+    }
+  }
+}
+
+void BodyParser::onString(const std::string& value) {
+  if (path_.size() == 1) {
+    if (key_ == "TableName") {
+      table_name_ = value;
+    } else if (key_ == "__type") {
+      error_type_ = value;
+    }
+  }
+}
+
+void BodyParser::onNumber(double value) {
+  if (path_.size() == 3 && path_[2].object_ && path_[1].key_ == "ConsumedCapacity" &&
+      path_[2].key_ == "Partitions") {
+    // Stats counters only increment by whole numbers, so the capacity is rounded up as in
+    // RequestParser::parsePartitions().
+    partitions_.emplace_back(key_, static_cast<uint64_t>(std::ceil(value)));
+  }
+}
+
 } // namespace Dynamo
 } // namespace Envoy
@@ -4,9 +4,11 @@
 #include <string>
 #include <vector>
 
+#include "envoy/buffer/buffer.h"
 #include "envoy/http/header_map.h"
 
 #include "common/json/json_loader.h"
+#include "common/json/json_streaming_parser.h"
 
 namespace Envoy {
 namespace Dynamo {
@@ -68,6 +70,12 @@ public:
    */
   static std::string parseErrorType(const Json::Object& json_data);
 
+  /**
+   * Map the __type of an error response to one of the supported error types.
+   * @return empty string if the error type is not supported.
+   */
+  static std::string parseErrorType(const std::string& error_type);
+
   /**
    * Parse unprocessed keys for batch operation results.
    * @return empty set if there are no unprocessed keys or a set of table names that did not get
@@ -80,6 +88,11 @@ public:
    */
   static bool isBatchOperation(const std::string& operation);
 
+  /**
+   * @return true if the operation is in the set of supported SINGLE_TABLE_OPERATIONS
+   */
+  static bool isSingleTableOperation(const std::string& operation);
+
   /**
    * Parse the Partition ids and the consumed capacity from the body.
    * @return empty set if there is no partition data or a set of partition data containing
@@ -100,5 +113,92 @@ private:
   RequestParser() {}
 };
 
+/**
+ * Incremental parser for the fields of a dynamodb request or response body that stats are charged
+ * for. The body is parsed as it streams through, so it does not need to be buffered, and only the
+ * top levels of the body are looked at:
+ *  1) TableName, RequestItems table names and the __type of errors, as in RequestParser.
+ *  2) UnprocessedKeys table names and ConsumedCapacity.Partitions capacities.
+ * Fields that are not of the expected type are ignored.
+ */
+class BodyParser : public Json::StreamingParserCallbacks {
+public:
+  BodyParser() : parser_(*this, MaxDepth) {}
+
+  /**
+   * Parse the next chunk of the body. Once the body is found to not be valid JSON, the rest of it
+   * is ignored.
+   */
+  void parse(const Buffer::Instance& data);
+
+  /**
+   * Signal the end of the body.
+   * @return false if the body is not valid JSON.
+   */
+  bool finish();
+
+  /**
+   * @return true if no data has been parsed.
+   */
+  bool empty() const { return empty_; }
+
+  /**
+   * @return the table of the operation, following the same rules as RequestParser::parseTable().
+   */
+  RequestParser::TableDescriptor table(const std::string& operation) const;
+
+  /**
+   * @return the supported error type of the __type field, or empty string if there is none.
+   */
+  std::string errorType() const { return RequestParser::parseErrorType(error_type_); }
+
+  /**
+   * @return the table names of the UnprocessedKeys of a batch operation.
+   */
+  const std::vector<std::string>& unprocessedTables() const { return unprocessed_tables_; }
+
+  /**
+   * @return the partition ids and the consumed capacity of the ConsumedCapacity.Partitions, as in
+   *         RequestParser::parsePartitions().
+   */
+  const std::vector<RequestParser::PartitionDescriptor>& partitions() const { return partitions_; }
+
+  // Json::StreamingParserCallbacks
+  void onStartObject() override { onStartContainer(true); }
+  void onKey(const std::string& key) override;
+  void onEndObject() override { onEndContainer(); }
+  void onStartArray() override { onStartContainer(false); }
+  void onEndArray() override { onEndContainer(); }
+  void onString(const std::string& value) override;
+  void onNumber(double value) override;
+  void onBool(bool) override {}
+  void onNull() override {}
+
+private:
+  // ConsumedCapacity.Partitions values are the deepest fields that are parsed.
+  static const uint32_t MaxDepth = 3;
+
+  struct Container {
+    // The key of the container in its parent object, or empty string.
+    std::string key_;
+    bool object_;
+  };
+
+  void onStartContainer(bool object);
+  void onEndContainer();
+
+  Json::StreamingParser parser_;
+  bool empty_{true};
+  bool valid_{true};
+  std::vector<Container> path_;
+  // The last key of the innermost object. Always empty in an array, as arrays have no keys.
+  std::string key_;
+  std::string table_name_;
+  std::string error_type_;
+  std::vector<std::string> request_tables_;
+  std::vector<std::string> unprocessed_tables_;
+  std::vector<RequestParser::PartitionDescriptor> partitions_;
+};
+
 } // namespace Dynamo
 } // namespace Envoy
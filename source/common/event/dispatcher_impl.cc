@@ -3,7 +3,6 @@
 #include <chrono>
 #include <cstdint>
 #include <functional>
-#include <mutex>
 #include <string>
 #include <vector>
 
@@ -24,6 +23,10 @@
 namespace Envoy {
 namespace Event {
 
+// The number of queue nodes allocated with the dispatcher. Posts only allocate a node while more
+// than this many callbacks are queued.
+static const uint32_t PostQueuePoolSize = 256;
+
 DispatcherImpl::DispatcherImpl()
     : DispatcherImpl(Buffer::WatermarkFactoryPtr{new Buffer::WatermarkBufferFactory}) {
   // The dispatcher won't work as expected if libevent hasn't been configured to use threads.
@@ -34,7 +37,7 @@ DispatcherImpl::DispatcherImpl(Buffer::WatermarkFactoryPtr&& factory)
     : buffer_factory_(std::move(factory)), base_(event_base_new()),
       deferred_delete_timer_(createTimer([this]() -> void { clearDeferredDeleteList(); })),
       post_timer_(createTimer([this]() -> void { runPostCallbacks(); })),
-      current_to_delete_(&to_delete_1_) {
+      current_to_delete_(&to_delete_1_), post_callbacks_(PostQueuePoolSize) {
   RELEASE_ASSERT(Libevent::Global::initialized());
 }
 
@@ -137,12 +140,10 @@ SignalEventPtr DispatcherImpl::listenForSignal(int signal_num, SignalCb cb) {
 }
 
 void DispatcherImpl::post(std::function<void()> callback) {
-  bool do_post;
-  {
-    std::unique_lock<std::mutex> lock(post_lock_);
-    do_post = post_callbacks_.empty();
-    post_callbacks_.push_back(callback);
-  }
+  // The callback is counted before it is queued, so that the count never goes below the number of
+  // callbacks that runPostCallbacks() can see.
+  const bool do_post = num_post_callbacks_.fetch_add(1) == 0;
+  post_callbacks_.push({std::move(callback), std::chrono::steady_clock::now()});
 
   if (do_post) {
     post_timer_->enableTimer(std::chrono::milliseconds(0));
@@ -161,15 +162,34 @@ void DispatcherImpl::run(RunType type) {
   event_base_loop(base_.get(), type == RunType::NonBlock ? EVLOOP_NONBLOCK : 0);
 }
 
+void DispatcherImpl::initializeStats(Stats::Scope& scope, const std::string& prefix) {
+  ASSERT(isThreadSafe());
+  stats_.reset(new DispatcherStats{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(scope, prefix))});
+}
+
 void DispatcherImpl::runPostCallbacks() {
-  std::unique_lock<std::mutex> lock(post_lock_);
-  while (!post_callbacks_.empty()) {
-    std::function<void()> callback = post_callbacks_.front();
-    post_callbacks_.pop_front();
-
-    lock.unlock();
-    callback();
-    lock.lock();
+  PostedCallback posted;
+  if (post_callbacks_.pop(posted)) {
+    // The stats are recorded once per run, for the callback that has waited the longest.
+    if (stats_) {
+      stats_->post_queue_depth_.recordValue(num_post_callbacks_.load());
+      const MonotonicTime now = std::chrono::steady_clock::now();
+      stats_->post_latency_us_.recordValue(
+          std::chrono::duration_cast<std::chrono::microseconds>(now - posted.posted_time_).count());
+    }
+
+    do {
+      posted.callback_();
+      if (num_post_callbacks_.fetch_sub(1) == 1) {
+        return;
+      }
+    } while (post_callbacks_.pop(posted));
+  }
+
+  // Some callbacks have been counted but their producers have not finished queueing them yet. They
+  // did not arm the timer, so come back for them on the next loop iteration rather than spinning.
+  if (num_post_callbacks_.load() > 0) {
+    post_timer_->enableTimer(std::chrono::milliseconds(0));
   }
 }
 
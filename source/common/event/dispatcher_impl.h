@@ -1,22 +1,42 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
-#include <list>
-#include <mutex>
+#include <memory>
+#include <string>
 #include <vector>
 
+#include "envoy/common/time.h"
 #include "envoy/event/deferred_deletable.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/network/connection_handler.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "common/common/logger.h"
+#include "common/common/mpsc_queue.h"
 #include "common/common/thread.h"
 #include "common/event/libevent.h"
 
 namespace Envoy {
 namespace Event {
 
+/**
+ * All dispatcher stats. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_DISPATCHER_STATS(HISTOGRAM)                                                            \
+  HISTOGRAM(post_queue_depth)                                                                      \
+  HISTOGRAM(post_latency_us)
+// clang-format on
+
+/**
+ * Struct definition for all dispatcher stats. @see stats_macros.h
+ */
+struct DispatcherStats {
+  ALL_DISPATCHER_STATS(GENERATE_HISTOGRAM_STRUCT)
+};
+
 /**
  * libevent implementation of Event::Dispatcher.
  */
@@ -56,8 +76,14 @@ public:
   void post(std::function<void()> callback) override;
   void run(RunType type) override;
   Buffer::WatermarkFactory& getWatermarkFactory() override { return *buffer_factory_; }
+  void initializeStats(Stats::Scope& scope, const std::string& prefix) override;
 
 private:
+  struct PostedCallback {
+    PostCb callback_;
+    MonotonicTime posted_time_;
+  };
+
   void runPostCallbacks();
 #ifndef NDEBUG
   // Validate that an operation is thread safe, i.e. it's invoked on the same thread that the
@@ -76,9 +102,12 @@ private:
   std::vector<DeferredDeletablePtr> to_delete_1_;
   std::vector<DeferredDeletablePtr> to_delete_2_;
   std::vector<DeferredDeletablePtr>* current_to_delete_;
-  std::mutex post_lock_;
-  std::list<std::function<void()>> post_callbacks_;
+  MpscQueue<PostedCallback> post_callbacks_;
+  // The number of posted callbacks that have not run yet. The post that raises it from zero arms
+  // post_timer_.
+  std::atomic<uint64_t> num_post_callbacks_{};
   bool deferred_deleting_{};
+  std::unique_ptr<DispatcherStats> stats_;
 };
 
 } // namespace Event
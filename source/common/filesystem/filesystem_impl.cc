@@ -3,6 +3,7 @@
 #include <dirent.h>
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <fstream>
@@ -61,12 +62,67 @@ std::string fileReadToEnd(const std::string& path) {
   return file_string.str();
 }
 
+FlushThread::~FlushThread() {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    ASSERT(pending_files_.empty());
+    exit_ = true;
+    flush_event_.notify_one();
+  }
+
+  if (thread_ != nullptr) {
+    thread_->join();
+  }
+}
+
+void FlushThread::requestFlush(FileImpl& file) {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (thread_ == nullptr) {
+    thread_.reset(new Thread::Thread([this]() -> void { threadRoutine(); }));
+  }
+
+  if (std::find(pending_files_.begin(), pending_files_.end(), &file) == pending_files_.end()) {
+    pending_files_.push_back(&file);
+    flush_event_.notify_one();
+  }
+}
+
+void FlushThread::removeFile(FileImpl& file) {
+  std::unique_lock<std::mutex> lock(lock_);
+  pending_files_.remove(&file);
+  while (flushing_file_ == &file) {
+    idle_event_.wait(lock);
+  }
+}
+
+void FlushThread::threadRoutine() {
+  std::unique_lock<std::mutex> lock(lock_);
+  while (true) {
+    while (pending_files_.empty() && !exit_) {
+      flush_event_.wait(lock);
+    }
+
+    if (exit_) {
+      return;
+    }
+
+    flushing_file_ = pending_files_.front();
+    pending_files_.pop_front();
+    lock.unlock();
+    flushing_file_->flushFromThread();
+    lock.lock();
+    flushing_file_ = nullptr;
+    idle_event_.notify_all();
+  }
+}
+
 FileImpl::FileImpl(const std::string& path, Event::Dispatcher& dispatcher,
-                   Thread::BasicLockable& lock, Stats::Store& stats_store,
-                   std::chrono::milliseconds flush_interval_msec)
-    : path_(path), file_lock_(lock), flush_timer_(dispatcher.createTimer([this]() -> void {
+                   Thread::BasicLockable& lock, FlushThread& flush_thread,
+                   Stats::Store& stats_store, std::chrono::milliseconds flush_interval_msec)
+    : path_(path), file_lock_(lock), flush_thread_(flush_thread),
+      flush_timer_(dispatcher.createTimer([this]() -> void {
         stats_.flushed_by_timer_.inc();
-        flush_event_.notify_one();
+        flush_thread_.requestFlush(*this);
         flush_timer_->enableTimer(flush_interval_msec_);
       })),
       os_sys_calls_(Api::OsSysCallsSingleton::get()), flush_interval_msec_(flush_interval_msec),
@@ -87,15 +143,7 @@ void FileImpl::open() {
 void FileImpl::reopen() { reopen_file_ = true; }
 
 FileImpl::~FileImpl() {
-  {
-    std::unique_lock<std::mutex> lock(write_lock_);
-    flush_thread_exit_ = true;
-    flush_event_.notify_one();
-  }
-
-  if (flush_thread_ != nullptr) {
-    flush_thread_->join();
-  }
+  flush_thread_.removeFile(*this);
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (fd_ != -1) {
@@ -134,43 +182,35 @@ void FileImpl::doWrite(Buffer::Instance& buffer) {
   buffer.drain(buffer.length());
 }
 
-void FileImpl::flushThreadFunc() {
+void FileImpl::flushFromThread() {
+  std::unique_lock<std::mutex> flush_lock;
 
-  while (true) {
-    std::unique_lock<std::mutex> flush_lock;
+  {
+    std::unique_lock<std::mutex> write_lock(write_lock_);
 
-    {
-      std::unique_lock<std::mutex> write_lock(write_lock_);
+    // A flush can be requested either by a large enough flush_buffer_ or by the timer. In case it
+    // was the timer, flush_buffer_ can be empty.
+    if (flush_buffer_.length() == 0) {
+      return;
+    }
 
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_) {
-        flush_event_.wait(write_lock);
-      }
+    flush_lock = std::unique_lock<std::mutex>(flush_lock_);
+    about_to_write_buffer_.move(flush_buffer_);
+    ASSERT(flush_buffer_.length() == 0);
+  }
 
-      if (flush_thread_exit_) {
-        return;
+  // if we failed to open file before (-1 == fd_), then simply ignore
+  if (fd_ != -1) {
+    try {
+      if (reopen_file_) {
+        reopen_file_ = false;
+        os_sys_calls_.close(fd_);
+        open();
       }
 
-      flush_lock = std::unique_lock<std::mutex>(flush_lock_);
-      ASSERT(flush_buffer_.length() > 0);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
-    }
-
-    // if we failed to open file before (-1 == fd_), then simply ignore
-    if (fd_ != -1) {
-      try {
-        if (reopen_file_) {
-          reopen_file_ = false;
-          os_sys_calls_.close(fd_);
-          open();
-        }
-
-        doWrite(about_to_write_buffer_);
-      } catch (const EnvoyException&) {
-        stats_.reopen_failed_.inc();
-      }
+      doWrite(about_to_write_buffer_);
+    } catch (const EnvoyException&) {
+      stats_.reopen_failed_.inc();
     }
   }
 }
@@ -182,7 +222,7 @@ void FileImpl::flush() {
     std::lock_guard<std::mutex> write_lock(write_lock_);
 
     // flush_lock_ must be held while checking this or else it is
-    // possible that flushThreadFunc() has already moved data from
+    // possible that flushFromThread() has already moved data from
     // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
     // but has not yet completed doWrite(). This would allow flush() to
     // return before the pending data has actually been written to disk.
@@ -200,24 +240,31 @@ void FileImpl::flush() {
 }
 
 void FileImpl::write(const std::string& data) {
-  std::lock_guard<std::mutex> lock(write_lock_);
+  bool request_flush;
 
-  if (flush_thread_ == nullptr) {
-    createFlushStructures();
+  {
+    std::lock_guard<std::mutex> lock(write_lock_);
+
+    stats_.write_buffered_.inc();
+    stats_.write_total_buffered_.add(data.length());
+    flush_buffer_.add(data);
+    request_flush = flush_buffer_.length() > MIN_FLUSH_SIZE;
+
+    // The first write starts the flush timer and is flushed right away, so that a new log file
+    // shows its first entry promptly.
+    if (!flush_timer_started_) {
+      flush_timer_started_ = true;
+      flush_timer_->enableTimer(flush_interval_msec_);
+      request_flush = true;
+    }
   }
 
-  stats_.write_buffered_.inc();
-  stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data);
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
-    flush_event_.notify_one();
+  // Requested outside of write_lock_ so that writers of different files never wait on each other
+  // while holding their file's lock.
+  if (request_flush) {
+    flush_thread_.requestFlush(*this);
   }
 }
 
-void FileImpl::createFlushStructures() {
-  flush_thread_.reset(new Thread::Thread([this]() -> void { flushThreadFunc(); }));
-  flush_timer_->enableTimer(flush_interval_msec_);
-}
-
 } // namespace Filesystem
 } // namespace Envoy
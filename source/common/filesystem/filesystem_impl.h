@@ -5,6 +5,7 @@
 #include <condition_variable>
 #include <cstdint>
 #include <cstdlib>
+#include <list>
 #include <mutex>
 #include <string>
 
@@ -56,17 +57,52 @@ ssize_t fileSize(const std::string& path);
  */
 std::string fileReadToEnd(const std::string& path);
 
+class FileImpl;
+
+/**
+ * A single thread that performs the disk writes of all the FileImpl instances that share it, so
+ * that the number of threads does not grow with the number of access log files. Files request a
+ * flush when their buffer is large enough or their flush timer fires; the thread services requests
+ * one file at a time in the order they were made. The thread is started on the first request.
+ */
+class FlushThread {
+public:
+  ~FlushThread();
+
+  /**
+   * Ask the thread to flush a file. Does nothing if the file already has a pending request.
+   */
+  void requestFlush(FileImpl& file);
+
+  /**
+   * Drop any pending request for a file and wait for an in progress flush of it to finish. Must be
+   * called before the file is destroyed.
+   */
+  void removeFile(FileImpl& file);
+
+private:
+  void threadRoutine();
+
+  std::mutex lock_;
+  std::condition_variable flush_event_; // Signalled when a request is added or on exit.
+  std::condition_variable idle_event_;  // Signalled when the thread finishes flushing a file.
+  std::list<FileImpl*> pending_files_;
+  FileImpl* flushing_file_{};
+  bool exit_{};
+  Thread::ThreadPtr thread_;
+};
+
 /**
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
- * This implementation uses a flush thread per file, with the idea there there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * Writes are therefore only buffered by the caller, and the disk writes are done by a FlushThread
+ * that is shared by all the files created through the same Api::Api.
  */
 class FileImpl : public File {
 public:
   FileImpl(const std::string& path, Event::Dispatcher& dispatcher, Thread::BasicLockable& lock,
-           Stats::Store& stats_store, std::chrono::milliseconds flush_interval_msec);
+           FlushThread& flush_thread, Stats::Store& stats_store,
+           std::chrono::milliseconds flush_interval_msec);
   ~FileImpl();
 
   // Filesystem::File
@@ -85,9 +121,8 @@ public:
 
 private:
   void doWrite(Buffer::Instance& buffer);
-  void flushThreadFunc();
+  void flushFromThread();
   void open();
-  void createFlushStructures();
 
   // Minimum size before the flush thread will be told to flush.
   static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
@@ -111,9 +146,8 @@ private:
   std::mutex write_lock_;            // The lock is used when filling the flush buffer. It allows
                                      // multiple threads to write to the same file at relatively
                                      // high performance. It is always local to the process.
-  Thread::ThreadPtr flush_thread_;
-  std::condition_variable_any flush_event_;
-  std::atomic<bool> flush_thread_exit_{};
+  FlushThread& flush_thread_;
+  bool flush_timer_started_{};
   std::atomic<bool> reopen_file_{};
   Buffer::OwnedImpl flush_buffer_; // This buffer is used by multiple threads. It gets filled and
                                    // then flushed either when max size is reached or when a timer
@@ -129,6 +163,8 @@ private:
                                                         // matter if it reached the MIN_FLUSH_SIZE
                                                         // or not.
   FileSystemStats stats_;
+
+  friend class FlushThread;
 };
 
 } // namespace Filesystem
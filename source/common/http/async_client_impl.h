@@ -20,6 +20,7 @@
 #include "envoy/ssl/connection.h"
 #include "envoy/tracing/http_tracer.h"
 
+#include "common/common/arena_impl.h"
 #include "common/common/empty_string.h"
 #include "common/common/linked_object.h"
 #include "common/http/message_impl.h"
@@ -239,6 +240,7 @@ private:
   RequestInfo::RequestInfo& requestInfo() override { return request_info_; }
   Tracing::Span& activeSpan() override { return active_span_; }
   const Tracing::Config& tracingConfig() override { return tracing_config_; }
+  Arena& arena() override { return arena_; }
   void continueDecoding() override { NOT_IMPLEMENTED; }
   void addDecodedData(Buffer::Instance&, bool) override { NOT_IMPLEMENTED; }
   const Buffer::Instance* decodingBuffer() override { return buffered_body_.get(); }
@@ -257,6 +259,9 @@ private:
 
   AsyncClient::StreamCallbacks& stream_callbacks_;
   const uint64_t stream_id_;
+  // Must be declared before (and therefore destroyed after) the router, which allocates its
+  // upstream requests in the arena.
+  ArenaImpl arena_;
   Router::ProdFilter router_;
   RequestInfo::RequestInfoImpl request_info_;
   Tracing::NullSpan active_span_;
@@ -24,6 +24,7 @@
 #include "envoy/upstream/upstream.h"
 
 #include "common/buffer/watermark_buffer.h"
+#include "common/common/arena_impl.h"
 #include "common/common/linked_object.h"
 #include "common/http/date_provider.h"
 #include "common/http/user_agent.h"
@@ -375,6 +376,7 @@ private:
     RequestInfo::RequestInfo& requestInfo() override;
     Tracing::Span& activeSpan() override;
     Tracing::Config& tracingConfig() override;
+    Arena& arena() override;
 
     ActiveStream& parent_;
     bool headers_continued_ : 1;
@@ -388,7 +390,7 @@ private:
    */
   struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
                                      public StreamDecoderFilterCallbacks,
-                                     LinkedObject<ActiveStreamDecoderFilter> {
+                                     LinkedObject<ActiveStreamDecoderFilter, ArenaDeleter> {
     ActiveStreamDecoderFilter(ActiveStream& parent, StreamDecoderFilterSharedPtr filter,
                               bool dual_filter)
         : ActiveStreamFilterBase(parent, dual_filter), handle_(filter) {}
@@ -440,14 +442,14 @@ private:
     StreamDecoderFilterSharedPtr handle_;
   };
 
-  typedef std::unique_ptr<ActiveStreamDecoderFilter> ActiveStreamDecoderFilterPtr;
+  typedef ArenaPtr<ActiveStreamDecoderFilter> ActiveStreamDecoderFilterPtr;
 
   /**
    * Wrapper for a stream encoder filter.
    */
   struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
                                      public StreamEncoderFilterCallbacks,
-                                     LinkedObject<ActiveStreamEncoderFilter> {
+                                     LinkedObject<ActiveStreamEncoderFilter, ArenaDeleter> {
     ActiveStreamEncoderFilter(ActiveStream& parent, StreamEncoderFilterSharedPtr filter,
                               bool dual_filter)
         : ActiveStreamFilterBase(parent, dual_filter), handle_(filter) {}
@@ -486,7 +488,7 @@ private:
     StreamEncoderFilterSharedPtr handle_;
   };
 
-  typedef std::unique_ptr<ActiveStreamEncoderFilter> ActiveStreamEncoderFilterPtr;
+  typedef ArenaPtr<ActiveStreamEncoderFilter> ActiveStreamEncoderFilterPtr;
 
   /**
    * Wraps a single active stream on the connection. These are either full request/response pairs
@@ -614,6 +616,9 @@ private:
     HeaderMapPtr request_headers_;
     Buffer::WatermarkBufferPtr buffered_request_data_;
     HeaderMapPtr request_trailers_;
+    // Filter wrappers and anything filters allocate via arena() live in the arena, so it must be
+    // declared before (and therefore destroyed after) the filter lists.
+    ArenaImpl arena_;
     std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
     std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
     std::list<AccessLog::InstanceSharedPtr> access_log_handlers_;
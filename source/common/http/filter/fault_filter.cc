@@ -49,8 +49,9 @@ FaultFilterConfig::FaultFilterConfig(const envoy::config::filter::http::fault::v
     fixed_duration_ms_ = PROTOBUF_GET_MS_OR_DEFAULT(delay, fixed_delay, 0);
   }
 
-  for (const Router::ConfigUtility::HeaderData& header_map : fault.headers()) {
-    fault_filter_headers_.push_back(header_map);
+  const Regex::Engine regex_engine = Router::ConfigImpl::runtimeRegexEngine(runtime);
+  for (const auto& header_matcher : fault.headers()) {
+    fault_filter_headers_.emplace_back(header_matcher, regex_engine);
   }
 
   upstream_cluster_ = fault.upstream_cluster();
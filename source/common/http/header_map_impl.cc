@@ -1,7 +1,6 @@
 #include "common/http/header_map_impl.h"
 
 #include <cstdint>
-#include <list>
 #include <string>
 
 #include "common/common/assert.h"
@@ -212,6 +211,52 @@ void HeaderMapImpl::HeaderEntryImpl::value(const HeaderEntry& header) {
   value(header.value().c_str(), header.value().size());
 }
 
+HeaderMapImpl::HeaderList::~HeaderList() {
+  for (HeaderEntryImpl* entry = head_; entry != nullptr;) {
+    HeaderEntryImpl* next = entry->next_;
+    entry->~HeaderEntryImpl();
+    entry = next;
+  }
+}
+
+void HeaderMapImpl::HeaderList::erase(HeaderEntryImpl& entry) {
+  if (entry.prev_ != nullptr) {
+    entry.prev_->next_ = entry.next_;
+  } else {
+    head_ = entry.next_;
+  }
+  if (entry.next_ != nullptr) {
+    entry.next_->prev_ = entry.prev_;
+  } else {
+    tail_ = entry.prev_;
+  }
+  size_--;
+
+  entry.~HeaderEntryImpl();
+  Slot* slot = reinterpret_cast<Slot*>(&entry);
+  slot->next_free_ = free_list_;
+  free_list_ = slot;
+}
+
+void* HeaderMapImpl::HeaderList::allocateSlot() {
+  if (free_list_ != nullptr) {
+    Slot* slot = free_list_;
+    free_list_ = slot->next_free_;
+    return slot;
+  }
+
+  if (next_unused_ == unused_end_) {
+    // Each overflow block is twice the size of the previous one so that the number of allocations
+    // stays logarithmic in the number of headers.
+    const size_t block_size = INLINE_CAPACITY << overflow_blocks_.size();
+    overflow_blocks_.emplace_back(new Slot[block_size]);
+    next_unused_ = overflow_blocks_.back().get();
+    unused_end_ = next_unused_ + block_size;
+  }
+
+  return next_unused_++;
+}
+
 #define INLINE_HEADER_STATIC_MAP_ENTRY(name)                                                       \
   add(Headers::get().name.get().c_str(), [](HeaderMapImpl& h) -> StaticLookupResponse {            \
     return {&h.inline_headers_.name##_, &Headers::get().name};                                     \
@@ -273,6 +318,18 @@ HeaderMapImpl::HeaderMapImpl(const HeaderMap& rhs) : HeaderMapImpl() {
       this);
 }
 
+HeaderMapImpl::HeaderMapImpl(HeaderMapImpl&& rhs) : HeaderMapImpl() {
+  for (HeaderEntryImpl* header = rhs.headers_.front(); header != nullptr; header = header->next_) {
+    // Inline headers are re-resolved by key, so the inline pointers of this map are rebuilt here.
+    addViaMove(std::move(header->key_), std::move(header->value_));
+  }
+
+  memset(&rhs.inline_headers_, 0, sizeof(rhs.inline_headers_));
+  while (rhs.headers_.front() != nullptr) {
+    rhs.headers_.erase(*rhs.headers_.front());
+  }
+}
+
 HeaderMapImpl::HeaderMapImpl(
     const std::initializer_list<std::pair<LowerCaseString, std::string>>& values)
     : HeaderMapImpl() {
@@ -290,7 +347,8 @@ bool HeaderMapImpl::operator==(const HeaderMapImpl& rhs) const {
     return false;
   }
 
-  for (auto i = headers_.begin(), j = rhs.headers_.begin(); i != headers_.end(); ++i, ++j) {
+  for (const HeaderEntryImpl *i = headers_.front(), *j = rhs.headers_.front(); i != nullptr;
+       i = i->next_, j = j->next_) {
     if (i->key() != j->key().c_str() || i->value() != j->value().c_str()) {
       return false;
     }
@@ -311,9 +369,7 @@ void HeaderMapImpl::insertByKey(HeaderString&& key, HeaderString&& value) {
     StaticLookupResponse ref_lookup_response = cb(*this);
     maybeCreateInline(ref_lookup_response.entry_, *ref_lookup_response.key_, std::move(value));
   } else {
-    std::list<HeaderEntryImpl>::iterator i =
-        headers_.emplace(headers_.end(), std::move(key), std::move(value));
-    i->entry_ = i;
+    headers_.emplaceBack(std::move(key), std::move(value));
   }
 }
 
@@ -381,18 +437,20 @@ void HeaderMapImpl::setReferenceKey(const LowerCaseString& key, const std::strin
 
 uint64_t HeaderMapImpl::byteSize() const {
   uint64_t byte_size = 0;
-  for (const HeaderEntryImpl& header : headers_) {
-    byte_size += header.key().size();
-    byte_size += header.value().size();
+  for (const HeaderEntryImpl* header = headers_.front(); header != nullptr;
+       header = header->next_) {
+    byte_size += header->key().size();
+    byte_size += header->value().size();
   }
 
   return byte_size;
 }
 
 const HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) const {
-  for (const HeaderEntryImpl& header : headers_) {
-    if (header.key() == key.get().c_str()) {
-      return &header;
+  for (const HeaderEntryImpl* header = headers_.front(); header != nullptr;
+       header = header->next_) {
+    if (header->key() == key.get().c_str()) {
+      return header;
     }
   }
 
@@ -400,9 +458,9 @@ const HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) const {
 }
 
 HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) {
-  for (HeaderEntryImpl& header : headers_) {
-    if (header.key() == key.get().c_str()) {
-      return &header;
+  for (HeaderEntryImpl* header = headers_.front(); header != nullptr; header = header->next_) {
+    if (header->key() == key.get().c_str()) {
+      return header;
     }
   }
 
@@ -410,16 +468,18 @@ HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) {
 }
 
 void HeaderMapImpl::iterate(ConstIterateCb cb, void* context) const {
-  for (const HeaderEntryImpl& header : headers_) {
-    if (cb(header, context) == HeaderMap::Iterate::Break) {
+  for (const HeaderEntryImpl* header = headers_.front(); header != nullptr;
+       header = header->next_) {
+    if (cb(*header, context) == HeaderMap::Iterate::Break) {
       break;
     }
   }
 }
 
 void HeaderMapImpl::iterateReverse(ConstIterateCb cb, void* context) const {
-  for (auto it = headers_.rbegin(); it != headers_.rend(); it++) {
-    if (cb(*it, context) == HeaderMap::Iterate::Break) {
+  for (const HeaderEntryImpl* header = headers_.back(); header != nullptr;
+       header = header->prev_) {
+    if (cb(*header, context) == HeaderMap::Iterate::Break) {
       break;
     }
   }
@@ -454,12 +514,12 @@ void HeaderMapImpl::remove(const LowerCaseString& key) {
     StaticLookupResponse ref_lookup_response = cb(*this);
     removeInline(ref_lookup_response.entry_);
   } else {
-    for (auto i = headers_.begin(); i != headers_.end();) {
-      if (i->key() == key.get().c_str()) {
-        i = headers_.erase(i);
-      } else {
-        ++i;
+    for (HeaderEntryImpl* header = headers_.front(); header != nullptr;) {
+      HeaderEntryImpl* next = header->next_;
+      if (header->key() == key.get().c_str()) {
+        headers_.erase(*header);
       }
+      header = next;
     }
   }
 }
@@ -470,9 +530,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
     return **entry;
   }
 
-  std::list<HeaderEntryImpl>::iterator i = headers_.emplace(headers_.end(), key);
-  i->entry_ = i;
-  *entry = &(*i);
+  *entry = &headers_.emplaceBack(key);
   return **entry;
 }
 
@@ -484,9 +542,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
     return **entry;
   }
 
-  std::list<HeaderEntryImpl>::iterator i = headers_.emplace(headers_.end(), key, std::move(value));
-  i->entry_ = i;
-  *entry = &(*i);
+  *entry = &headers_.emplaceBack(key, std::move(value));
   return **entry;
 }
 
@@ -497,7 +553,7 @@ void HeaderMapImpl::removeInline(HeaderEntryImpl** ptr_to_entry) {
 
   HeaderEntryImpl* entry = *ptr_to_entry;
   *ptr_to_entry = nullptr;
-  headers_.erase(entry->entry_);
+  headers_.erase(*entry);
 }
 
 } // namespace Http
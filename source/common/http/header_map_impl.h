@@ -2,9 +2,10 @@
 
 #include <array>
 #include <cstdint>
-#include <list>
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "envoy/http/header_map.h"
 
@@ -33,7 +34,8 @@ public:
  * headers are added to the map, we do a hash lookup to see if it's one of the O(1) headers.
  * If it is, we store a reference to it that can be accessed later directly. Most high performance
  * paths use O(1) direct access. In general, we try to copy as little as possible and allocate as
- * little as possible in any of the paths.
+ * little as possible in any of the paths. Header entries are stored in contiguous blocks (see
+ * HeaderList) so that a typical request or response does not perform any per header allocation.
  */
 class HeaderMapImpl : public HeaderMap {
 public:
@@ -41,6 +43,12 @@ public:
   HeaderMapImpl(const std::initializer_list<std::pair<LowerCaseString, std::string>>& values);
   HeaderMapImpl(const HeaderMap& rhs);
 
+  /**
+   * Entries may live inside the map itself so they can not be moved in place. Instead, all the
+   * keys and values of rhs are moved into new entries. rhs is left empty.
+   */
+  HeaderMapImpl(HeaderMapImpl&& rhs);
+
   /**
    * Add a header via full move. This is the expected high performance paths for codecs populating
    * a map when receiving.
@@ -87,7 +95,58 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
-    std::list<HeaderEntryImpl>::iterator entry_;
+    HeaderEntryImpl* prev_{};
+    HeaderEntryImpl* next_{};
+  };
+
+  /**
+   * Ordered, intrusively linked list of header entries. Rather than allocating a node per entry,
+   * entries are constructed in place: the first INLINE_CAPACITY entries are stored inside the list
+   * itself and further entries are stored in heap blocks of doubling size. The slots of removed
+   * entries are reused. Entries never move, so pointers to them (e.g., the O(1) inline header
+   * pointers) stay valid until the entry is removed.
+   */
+  class HeaderList : NonCopyable {
+  public:
+    static const size_t INLINE_CAPACITY = 16;
+
+    HeaderList() {}
+    ~HeaderList();
+
+    template <class... Args> HeaderEntryImpl& emplaceBack(Args&&... args) {
+      HeaderEntryImpl* entry = new (allocateSlot()) HeaderEntryImpl(std::forward<Args>(args)...);
+      entry->prev_ = tail_;
+      if (tail_ != nullptr) {
+        tail_->next_ = entry;
+      } else {
+        head_ = entry;
+      }
+      tail_ = entry;
+      size_++;
+      return *entry;
+    }
+
+    void erase(HeaderEntryImpl& entry);
+    HeaderEntryImpl* front() const { return head_; }
+    HeaderEntryImpl* back() const { return tail_; }
+    size_t size() const { return size_; }
+
+  private:
+    union Slot {
+      Slot* next_free_;
+      std::aligned_storage<sizeof(HeaderEntryImpl), alignof(HeaderEntryImpl)>::type entry_;
+    };
+
+    void* allocateSlot();
+
+    Slot inline_slots_[INLINE_CAPACITY];
+    std::vector<std::unique_ptr<Slot[]>> overflow_blocks_;
+    Slot* next_unused_{inline_slots_};
+    Slot* unused_end_{inline_slots_ + INLINE_CAPACITY};
+    Slot* free_list_{};
+    HeaderEntryImpl* head_{};
+    HeaderEntryImpl* tail_{};
+    size_t size_{};
   };
 
   struct StaticLookupResponse {
@@ -125,7 +184,7 @@ protected:
   void removeInline(HeaderEntryImpl** entry);
 
   AllInlineHeaders inline_headers_;
-  std::list<HeaderEntryImpl> headers_;
+  HeaderList headers_;
 
   ALL_INLINE_HEADERS(DEFINE_INLINE_HEADER_FUNCS)
 };
@@ -1,6 +1,7 @@
 #include "common/http/http2/conn_pool.h"
 
 #include <cstdint>
+#include <vector>
 
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
@@ -16,16 +17,24 @@ namespace Http2 {
 
 ConnPoolImpl::ConnPoolImpl(Event::Dispatcher& dispatcher, Upstream::HostConstSharedPtr host,
                            Upstream::ResourcePriority priority,
-                           const Network::ConnectionSocket::OptionsSharedPtr& options)
-    : dispatcher_(dispatcher), host_(host), priority_(priority), socket_options_(options) {}
+                           const Network::ConnectionSocket::OptionsSharedPtr& options,
+                           uint32_t max_active_clients)
+    : dispatcher_(dispatcher), host_(host), priority_(priority), socket_options_(options),
+      max_active_clients_(max_active_clients) {
+  ASSERT(max_active_clients_ > 0);
+}
 
 ConnPoolImpl::~ConnPoolImpl() {
-  if (primary_client_) {
-    primary_client_->client_->close();
+  // Drop the pending requests first so that closing the connections below does not open new ones
+  // to serve them.
+  pending_requests_.clear();
+
+  while (!active_clients_.empty()) {
+    active_clients_.front()->client_->close();
   }
 
-  if (draining_client_) {
-    draining_client_->client_->close();
+  while (!draining_clients_.empty()) {
+    draining_clients_.front()->client_->close();
   }
 
   // Make sure all clients are destroyed before we are destroyed.
@@ -33,9 +42,11 @@ ConnPoolImpl::~ConnPoolImpl() {
 }
 
 void ConnPoolImpl::ConnPoolImpl::drainConnections() {
-  if (primary_client_ != nullptr) {
-    movePrimaryClientToDraining();
+  while (!active_clients_.empty()) {
+    moveClientToDraining(*active_clients_.front());
   }
+
+  processPendingRequests();
 }
 
 void ConnPoolImpl::addDrainedCallback(DrainedCb cb) {
@@ -43,27 +54,40 @@ void ConnPoolImpl::addDrainedCallback(DrainedCb cb) {
   checkForDrained();
 }
 
+void ConnPoolImpl::attachRequestToClient(ActiveClient& client, StreamDecoder& response_decoder,
+                                         ConnectionPool::Callbacks& callbacks) {
+  ENVOY_CONN_LOG(debug, "creating stream", *client.client_);
+  client.total_streams_++;
+  host_->stats().rq_total_.inc();
+  host_->stats().rq_active_.inc();
+  host_->cluster().stats().upstream_rq_total_.inc();
+  host_->cluster().stats().upstream_rq_active_.inc();
+  host_->cluster().resourceManager(priority_).requests().inc();
+  callbacks.onPoolReady(client.client_->newStream(response_decoder),
+                        client.real_host_description_);
+}
+
 void ConnPoolImpl::checkForDrained() {
   if (drained_callbacks_.empty()) {
     return;
   }
 
-  bool drained = true;
-  if (primary_client_) {
-    if (primary_client_->client_->numActiveRequests() == 0) {
-      primary_client_->client_->close();
-      ASSERT(!primary_client_);
-    } else {
-      drained = false;
+  // Idle connections are closed right away, the others once their last stream finishes.
+  std::vector<ActiveClient*> idle_clients;
+  for (const ActiveClientPtr& client : active_clients_) {
+    if (client->client_->numActiveRequests() == 0) {
+      idle_clients.push_back(client.get());
     }
   }
 
-  ASSERT(!draining_client_ || (draining_client_->client_->numActiveRequests() > 0));
-  if (draining_client_ && draining_client_->client_->numActiveRequests() > 0) {
-    drained = false;
+  for (ActiveClient* client : idle_clients) {
+    if (client->state_ == ActiveClient::State::Active &&
+        client->client_->numActiveRequests() == 0) {
+      client->client_->close();
+    }
   }
 
-  if (drained) {
+  if (pending_requests_.empty() && active_clients_.empty() && draining_clients_.empty()) {
     ENVOY_LOG(debug, "invoking drained callbacks");
     for (const DrainedCb& cb : drained_callbacks_) {
       cb();
@@ -71,41 +95,89 @@ void ConnPoolImpl::checkForDrained() {
   }
 }
 
-ConnectionPool::Cancellable* ConnPoolImpl::newStream(Http::StreamDecoder& response_decoder,
-                                                     ConnectionPool::Callbacks& callbacks) {
-  ASSERT(drained_callbacks_.empty());
-
+ConnPoolImpl::ActiveClient* ConnPoolImpl::chooseClient() {
   // First see if we need to handle max streams rollover.
   uint64_t max_streams = host_->cluster().maxRequestsPerConnection();
   if (max_streams == 0) {
     max_streams = maxTotalStreams();
   }
 
-  if (primary_client_ && primary_client_->total_streams_ >= max_streams) {
-    movePrimaryClientToDraining();
+  std::vector<ActiveClient*> rollover_clients;
+  for (const ActiveClientPtr& client : active_clients_) {
+    if (client->total_streams_ >= max_streams) {
+      rollover_clients.push_back(client.get());
+    }
+  }
+
+  for (ActiveClient* client : rollover_clients) {
+    if (client->state_ == ActiveClient::State::Active) {
+      moveClientToDraining(*client);
+    }
+  }
+
+  ActiveClient* least_loaded = nullptr;
+  for (const ActiveClientPtr& client : active_clients_) {
+    if (least_loaded == nullptr ||
+        client->client_->numActiveRequests() < least_loaded->client_->numActiveRequests()) {
+      least_loaded = client.get();
+    }
+  }
+
+  // Open another connection once the least loaded one is 3/4 of the way to the stream limit, so
+  // that it is likely connected by the time the others are full. Without a configured limit, the
+  // server's own limit is unknown, so a common one is assumed rather than never opening another.
+  const uint64_t max_concurrent_streams =
+      host_->cluster().http2Settings().max_concurrent_streams_;
+  uint64_t new_client_stream_limit = max_concurrent_streams;
+  if (max_concurrent_streams == Http2Settings::DEFAULT_MAX_CONCURRENT_STREAMS) {
+    new_client_stream_limit = DEFAULT_NEW_CLIENT_STREAM_LIMIT;
+  }
+  const uint64_t new_client_threshold = new_client_stream_limit - new_client_stream_limit / 4;
+  if (active_clients_.size() < max_active_clients_ &&
+      (least_loaded == nullptr ||
+       least_loaded->client_->numActiveRequests() >= new_client_threshold)) {
+    ActiveClientPtr client(new ActiveClient(*this));
+    client->moveIntoList(std::move(client), active_clients_);
+    least_loaded = active_clients_.front().get();
   }
 
-  if (!primary_client_) {
-    primary_client_.reset(new ActiveClient(*this));
+  ASSERT(least_loaded != nullptr);
+  if (least_loaded->client_->numActiveRequests() >= max_concurrent_streams) {
+    return nullptr;
   }
 
+  return least_loaded;
+}
+
+ConnectionPool::Cancellable* ConnPoolImpl::newStream(Http::StreamDecoder& response_decoder,
+                                                     ConnectionPool::Callbacks& callbacks) {
+  ASSERT(drained_callbacks_.empty());
+
+  // Check for overflow before choosing a client, which may open a new connection.
   if (!host_->cluster().resourceManager(priority_).requests().canCreate()) {
     ENVOY_LOG(debug, "max requests overflow");
     callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::Overflow, nullptr);
     host_->cluster().stats().upstream_rq_pending_overflow_.inc();
-  } else {
-    ENVOY_CONN_LOG(debug, "creating stream", *primary_client_->client_);
-    primary_client_->total_streams_++;
-    host_->stats().rq_total_.inc();
-    host_->stats().rq_active_.inc();
-    host_->cluster().stats().upstream_rq_total_.inc();
-    host_->cluster().stats().upstream_rq_active_.inc();
-    host_->cluster().resourceManager(priority_).requests().inc();
-    callbacks.onPoolReady(primary_client_->client_->newStream(response_decoder),
-                          primary_client_->real_host_description_);
+    return nullptr;
+  }
+
+  ActiveClient* client = chooseClient();
+  if (client != nullptr) {
+    attachRequestToClient(*client, response_decoder, callbacks);
+    return nullptr;
+  }
+
+  if (!host_->cluster().resourceManager(priority_).pendingRequests().canCreate()) {
+    ENVOY_LOG(debug, "max pending requests overflow");
+    callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::Overflow, nullptr);
+    host_->cluster().stats().upstream_rq_pending_overflow_.inc();
+    return nullptr;
   }
 
-  return nullptr;
+  ENVOY_LOG(debug, "queueing request due to all connections being at max concurrent streams");
+  PendingRequestPtr pending_request(new PendingRequest(*this, response_decoder, callbacks));
+  pending_request->moveIntoList(std::move(pending_request), pending_requests_);
+  return pending_requests_.front().get();
 }
 
 void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEvent event) {
@@ -121,19 +193,22 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
       }
     }
 
-    if (&client == primary_client_.get()) {
-      ENVOY_CONN_LOG(debug, "destroying primary client", *client.client_);
-      dispatcher_.deferredDelete(std::move(primary_client_));
-    } else {
-      ENVOY_CONN_LOG(debug, "destroying draining client", *client.client_);
-      dispatcher_.deferredDelete(std::move(draining_client_));
-    }
+    ENVOY_CONN_LOG(debug, "destroying {} client", *client.client_,
+                   client.state_ == ActiveClient::State::Active ? "active" : "draining");
+    ASSERT(client.state_ != ActiveClient::State::Closed);
+    std::list<ActiveClientPtr>& list =
+        client.state_ == ActiveClient::State::Active ? active_clients_ : draining_clients_;
+    client.state_ = ActiveClient::State::Closed;
+    dispatcher_.deferredDelete(client.removeFromList(list));
 
     if (client.connect_timer_) {
       host_->cluster().stats().upstream_cx_connect_fail_.inc();
       host_->stats().cx_connect_fail_.inc();
     }
 
+    // Requests waiting for stream capacity can use a replacement connection.
+    processPendingRequests();
+
     if (client.closed_with_active_rq_) {
       checkForDrained();
     }
@@ -149,25 +224,16 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
   }
 }
 
-void ConnPoolImpl::movePrimaryClientToDraining() {
-  ENVOY_CONN_LOG(debug, "moving primary to draining", *primary_client_->client_);
-  if (draining_client_) {
-    // This should pretty much never happen, but is possible if we start draining and then get
-    // a goaway for example. In this case just kill the current draining connection. It's not
-    // worth keeping a list.
-    draining_client_->client_->close();
-  }
-
-  ASSERT(!draining_client_);
-  if (primary_client_->client_->numActiveRequests() == 0) {
-    // If we are making a new connection and the primary does not have any active requests just
-    // close it now.
-    primary_client_->client_->close();
+void ConnPoolImpl::moveClientToDraining(ActiveClient& client) {
+  ENVOY_CONN_LOG(debug, "moving to draining", *client.client_);
+  ASSERT(client.state_ == ActiveClient::State::Active);
+  if (client.client_->numActiveRequests() == 0) {
+    // If the client does not have any active requests just close it now.
+    client.client_->close();
   } else {
-    draining_client_ = std::move(primary_client_);
+    client.state_ = ActiveClient::State::Draining;
+    client.moveBetweenLists(active_clients_, draining_clients_);
   }
-
-  ASSERT(!primary_client_);
 }
 
 void ConnPoolImpl::onConnectTimeout(ActiveClient& client) {
@@ -179,18 +245,26 @@ void ConnPoolImpl::onConnectTimeout(ActiveClient& client) {
 void ConnPoolImpl::onGoAway(ActiveClient& client) {
   ENVOY_CONN_LOG(debug, "remote goaway", *client.client_);
   host_->cluster().stats().upstream_cx_close_notify_.inc();
-  if (&client == primary_client_.get()) {
-    movePrimaryClientToDraining();
+  if (client.state_ == ActiveClient::State::Active) {
+    moveClientToDraining(client);
+    processPendingRequests();
   }
 }
 
+void ConnPoolImpl::onPendingRequestCancel(PendingRequest& request) {
+  ENVOY_LOG(debug, "cancelling pending request");
+  request.removeFromList(pending_requests_);
+  host_->cluster().stats().upstream_rq_cancelled_.inc();
+  checkForDrained();
+}
+
 void ConnPoolImpl::onStreamDestroy(ActiveClient& client) {
   ENVOY_CONN_LOG(debug, "destroying stream: {} remaining", *client.client_,
                  client.client_->numActiveRequests());
   host_->stats().rq_active_.dec();
   host_->cluster().stats().upstream_rq_active_.dec();
   host_->cluster().resourceManager(priority_).requests().dec();
-  if (&client == draining_client_.get() && client.client_->numActiveRequests() == 0) {
+  if (client.state_ == ActiveClient::State::Draining && client.client_->numActiveRequests() == 0) {
     // Close out the draining client if we no long have active requests.
     client.client_->close();
   }
@@ -199,6 +273,7 @@ void ConnPoolImpl::onStreamDestroy(ActiveClient& client) {
   // wait until the connection has been fully drained of streams and then check in the connection
   // event callback.
   if (!client.closed_with_active_rq_) {
+    processPendingRequests();
     checkForDrained();
   }
 }
@@ -215,6 +290,20 @@ void ConnPoolImpl::onStreamReset(ActiveClient& client, Http::StreamResetReason r
   }
 }
 
+void ConnPoolImpl::processPendingRequests() {
+  while (!pending_requests_.empty()) {
+    ActiveClient* client = chooseClient();
+    if (client == nullptr) {
+      return;
+    }
+
+    // Pending requests are pushed onto the front, so pull from the back.
+    ENVOY_CONN_LOG(debug, "attaching to next request", *client->client_);
+    PendingRequestPtr request = pending_requests_.back()->removeFromList(pending_requests_);
+    attachRequestToClient(*client, request->decoder_, request->callbacks_);
+  }
+}
+
 ConnPoolImpl::ActiveClient::ActiveClient(ConnPoolImpl& parent)
     : parent_(parent),
       connect_timer_(parent_.dispatcher_.createTimer([this]() -> void { onConnectTimeout(); })) {
@@ -250,6 +339,19 @@ ConnPoolImpl::ActiveClient::~ActiveClient() {
   conn_length_->complete();
 }
 
+ConnPoolImpl::PendingRequest::PendingRequest(ConnPoolImpl& parent, StreamDecoder& decoder,
+                                             ConnectionPool::Callbacks& callbacks)
+    : parent_(parent), decoder_(decoder), callbacks_(callbacks) {
+  parent_.host_->cluster().stats().upstream_rq_pending_total_.inc();
+  parent_.host_->cluster().stats().upstream_rq_pending_active_.inc();
+  parent_.host_->cluster().resourceManager(parent_.priority_).pendingRequests().inc();
+}
+
+ConnPoolImpl::PendingRequest::~PendingRequest() {
+  parent_.host_->cluster().stats().upstream_rq_pending_active_.dec();
+  parent_.host_->cluster().resourceManager(parent_.priority_).pendingRequests().dec();
+}
+
 CodecClientPtr ProdConnPoolImpl::createCodecClient(Upstream::Host::CreateConnectionData& data) {
   CodecClientPtr codec{new CodecClientProd(CodecClient::Type::HTTP2, std::move(data.connection_),
                                            data.host_description_)};
@@ -10,6 +10,7 @@
 #include "envoy/stats/timespan.h"
 #include "envoy/upstream/upstream.h"
 
+#include "common/common/linked_object.h"
 #include "common/http/codec_client.h"
 
 namespace Envoy {
@@ -18,14 +19,20 @@ namespace Http2 {
 
 /**
  * Implementation of a "connection pool" for HTTP/2. This mainly handles stats as well as
- * shifting to a new connection if we reach max streams on the primary. This is a base class
+ * shifting to a new connection if we reach max streams on a connection. This is a base class
  * used for both the prod implementation as well as the testing one.
+ *
+ * The pool keeps up to max_active_clients connections that accept new streams. Each new stream
+ * goes to the connection with the fewest active streams. Another connection is opened once every
+ * open one is close to the cluster's max concurrent streams setting, and streams are queued only
+ * when every connection is at that limit and no more connections can be opened.
  */
 class ConnPoolImpl : Logger::Loggable<Logger::Id::pool>, public ConnectionPool::Instance {
 public:
   ConnPoolImpl(Event::Dispatcher& dispatcher, Upstream::HostConstSharedPtr host,
                Upstream::ResourcePriority priority,
-               const Network::ConnectionSocket::OptionsSharedPtr& options);
+               const Network::ConnectionSocket::OptionsSharedPtr& options,
+               uint32_t max_active_clients);
   ~ConnPoolImpl();
 
   // Http::ConnectionPool::Instance
@@ -36,10 +43,17 @@ public:
                                          ConnectionPool::Callbacks& callbacks) override;
 
 protected:
-  struct ActiveClient : public Network::ConnectionCallbacks,
+  struct ActiveClient : LinkedObject<ActiveClient>,
+                        public Network::ConnectionCallbacks,
                         public CodecClientCallbacks,
                         public Event::DeferredDeletable,
                         public Http::ConnectionCallbacks {
+    enum class State {
+      Active,   // In active_clients_, new streams can be created on the connection.
+      Draining, // In draining_clients_, waiting for the remaining streams to finish.
+      Closed    // Removed from the pool and pending deletion.
+    };
+
     ActiveClient(ConnPoolImpl& parent);
     ~ActiveClient();
 
@@ -67,29 +81,56 @@ protected:
     uint64_t total_streams_{};
     Event::TimerPtr connect_timer_;
     Stats::TimespanPtr conn_length_;
+    State state_{State::Active};
     bool closed_with_active_rq_{};
   };
 
   typedef std::unique_ptr<ActiveClient> ActiveClientPtr;
 
+  struct PendingRequest : LinkedObject<PendingRequest>, public ConnectionPool::Cancellable {
+    PendingRequest(ConnPoolImpl& parent, StreamDecoder& decoder,
+                   ConnectionPool::Callbacks& callbacks);
+    ~PendingRequest();
+
+    // Cancellable
+    void cancel() override { parent_.onPendingRequestCancel(*this); }
+
+    ConnPoolImpl& parent_;
+    StreamDecoder& decoder_;
+    ConnectionPool::Callbacks& callbacks_;
+  };
+
+  typedef std::unique_ptr<PendingRequest> PendingRequestPtr;
+
+  void attachRequestToClient(ActiveClient& client, StreamDecoder& response_decoder,
+                             ConnectionPool::Callbacks& callbacks);
   void checkForDrained();
+  ActiveClient* chooseClient();
   virtual CodecClientPtr createCodecClient(Upstream::Host::CreateConnectionData& data) PURE;
   virtual uint32_t maxTotalStreams() PURE;
-  void movePrimaryClientToDraining();
+  void moveClientToDraining(ActiveClient& client);
   void onConnectionEvent(ActiveClient& client, Network::ConnectionEvent event);
   void onConnectTimeout(ActiveClient& client);
   void onGoAway(ActiveClient& client);
+  void onPendingRequestCancel(PendingRequest& request);
   void onStreamDestroy(ActiveClient& client);
   void onStreamReset(ActiveClient& client, Http::StreamResetReason reason);
+  void processPendingRequests();
+
+  // The stream limit used to decide when to open another connection if the cluster does not set
+  // max_concurrent_streams. Servers commonly advertise 100, the minimum RFC 7540 recommends.
+  static const uint64_t DEFAULT_NEW_CLIENT_STREAM_LIMIT = 100;
 
   Stats::TimespanPtr conn_connect_ms_;
   Event::Dispatcher& dispatcher_;
   Upstream::HostConstSharedPtr host_;
-  ActiveClientPtr primary_client_;
-  ActiveClientPtr draining_client_;
+  std::list<ActiveClientPtr> active_clients_;
+  std::list<ActiveClientPtr> draining_clients_;
+  std::list<PendingRequestPtr> pending_requests_;
   std::list<DrainedCb> drained_callbacks_;
   Upstream::ResourcePriority priority_;
   const Network::ConnectionSocket::OptionsSharedPtr socket_options_;
+  const uint32_t max_active_clients_;
 };
 
 /**
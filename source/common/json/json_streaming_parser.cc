@@ -0,0 +1,406 @@
+#include "common/json/json_streaming_parser.h"
+
+#include <cstdlib>
+#include <string>
+
+#include "envoy/json/json_object.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+
+namespace Envoy {
+namespace Json {
+
+StreamingParser::StreamingParser(StreamingParserCallbacks& callbacks, uint32_t max_depth)
+    : callbacks_(callbacks), max_depth_(max_depth) {}
+
+void StreamingParser::parse(const char* data, uint64_t size) {
+  for (uint64_t i = 0; i < size; i++) {
+    parseChar(data[i]);
+    offset_++;
+  }
+}
+
+void StreamingParser::finish() {
+  if (token_ == Token::Number &&
+      (number_ == Number::Zero || number_ == Number::Integer || number_ == Number::Fraction ||
+       number_ == Number::Exponent)) {
+    onNumberEnd();
+  }
+
+  if (token_ != Token::None || expect_ != Expect::Done) {
+    throwError("unexpected end of document");
+  }
+}
+
+void StreamingParser::parseChar(char c) {
+  switch (token_) {
+  case Token::String:
+    parseStringChar(c);
+    return;
+  case Token::Escape:
+    parseEscapeChar(c);
+    return;
+  case Token::Unicode:
+    parseUnicodeChar(c);
+    return;
+  case Token::Number:
+    if (parseNumberChar(c)) {
+      return;
+    }
+    // The character ends the number, and is parsed as the next token.
+    onNumberEnd();
+    break;
+  case Token::Literal:
+    parseLiteralChar(c);
+    return;
+  case Token::None:
+    break;
+  }
+
+  if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+    return;
+  }
+
+  switch (expect_) {
+  case Expect::Value:
+    parseValue(c);
+    break;
+  case Expect::ValueOrArrayEnd:
+    if (c == ']') {
+      endContainer();
+    } else {
+      parseValue(c);
+    }
+    break;
+  case Expect::KeyOrObjectEnd:
+    if (c == '}') {
+      endContainer();
+      break;
+    }
+    FALLTHRU;
+  case Expect::Key:
+    if (c != '"') {
+      throwError("expected a key");
+    }
+    token_ = Token::String;
+    key_ = true;
+    value_.clear();
+    break;
+  case Expect::Colon:
+    if (c != ':') {
+      throwError("expected ':'");
+    }
+    expect_ = Expect::Value;
+    break;
+  case Expect::CommaOrEnd:
+    ASSERT(!stack_.empty());
+    if (c == ',') {
+      expect_ = stack_.back() ? Expect::Key : Expect::Value;
+    } else if (c == (stack_.back() ? '}' : ']')) {
+      endContainer();
+    } else {
+      throwError(stack_.back() ? "expected ',' or '}'" : "expected ',' or ']'");
+    }
+    break;
+  case Expect::Done:
+    throwError("unexpected data after the end of the document");
+  }
+}
+
+void StreamingParser::parseValue(char c) {
+  switch (c) {
+  case '{':
+    startContainer(true);
+    break;
+  case '[':
+    startContainer(false);
+    break;
+  case '"':
+    token_ = Token::String;
+    key_ = false;
+    value_.clear();
+    break;
+  case 't':
+    token_ = Token::Literal;
+    literal_start_ = c;
+    literal_ = "rue";
+    break;
+  case 'f':
+    token_ = Token::Literal;
+    literal_start_ = c;
+    literal_ = "alse";
+    break;
+  case 'n':
+    token_ = Token::Literal;
+    literal_start_ = c;
+    literal_ = "ull";
+    break;
+  default:
+    if (c != '-' && (c < '0' || c > '9')) {
+      throwError(fmt::format("unexpected character '{}'", c));
+    }
+    token_ = Token::Number;
+    number_ = Number::Start;
+    value_.clear();
+    parseNumberChar(c);
+  }
+}
+
+void StreamingParser::startContainer(bool object) {
+  stack_.push_back(object);
+  if (reporting()) {
+    if (object) {
+      callbacks_.onStartObject();
+    } else {
+      callbacks_.onStartArray();
+    }
+  }
+  expect_ = object ? Expect::KeyOrObjectEnd : Expect::ValueOrArrayEnd;
+}
+
+void StreamingParser::endContainer() {
+  if (reporting()) {
+    if (stack_.back()) {
+      callbacks_.onEndObject();
+    } else {
+      callbacks_.onEndArray();
+    }
+  }
+  stack_.pop_back();
+  onValueEnd();
+}
+
+void StreamingParser::parseStringChar(char c) {
+  if (high_surrogate_ != 0 && c != '\\') {
+    throwError("invalid unicode surrogate");
+  }
+
+  if (c == '"') {
+    onStringEnd();
+  } else if (c == '\\') {
+    token_ = Token::Escape;
+  } else if (static_cast<unsigned char>(c) < 0x20) {
+    throwError("invalid control character in string");
+  } else if (reporting()) {
+    value_.push_back(c);
+  }
+}
+
+void StreamingParser::parseEscapeChar(char c) {
+  token_ = Token::String;
+  if (c == 'u') {
+    token_ = Token::Unicode;
+    unicode_digits_ = 0;
+    unicode_value_ = 0;
+    return;
+  }
+
+  if (high_surrogate_ != 0) {
+    throwError("invalid unicode surrogate");
+  }
+
+  switch (c) {
+  case '"':
+  case '\\':
+  case '/':
+    break;
+  case 'b':
+    c = '\b';
+    break;
+  case 'f':
+    c = '\f';
+    break;
+  case 'n':
+    c = '\n';
+    break;
+  case 'r':
+    c = '\r';
+    break;
+  case 't':
+    c = '\t';
+    break;
+  default:
+    throwError("invalid escape");
+  }
+
+  if (reporting()) {
+    value_.push_back(c);
+  }
+}
+
+void StreamingParser::parseUnicodeChar(char c) {
+  uint32_t digit;
+  if (c >= '0' && c <= '9') {
+    digit = c - '0';
+  } else if (c >= 'a' && c <= 'f') {
+    digit = c - 'a' + 10;
+  } else if (c >= 'A' && c <= 'F') {
+    digit = c - 'A' + 10;
+  } else {
+    throwError("invalid unicode escape");
+  }
+
+  unicode_value_ = unicode_value_ * 16 + digit;
+  if (++unicode_digits_ < 4) {
+    return;
+  }
+
+  token_ = Token::String;
+  if (unicode_value_ >= 0xD800 && unicode_value_ <= 0xDBFF) {
+    if (high_surrogate_ != 0) {
+      throwError("invalid unicode surrogate");
+    }
+    high_surrogate_ = unicode_value_;
+  } else if (unicode_value_ >= 0xDC00 && unicode_value_ <= 0xDFFF) {
+    if (high_surrogate_ == 0) {
+      throwError("invalid unicode surrogate");
+    }
+    appendCodePoint(0x10000 + ((high_surrogate_ - 0xD800) << 10) + (unicode_value_ - 0xDC00));
+    high_surrogate_ = 0;
+  } else {
+    if (high_surrogate_ != 0) {
+      throwError("invalid unicode surrogate");
+    }
+    appendCodePoint(unicode_value_);
+  }
+}
+
+bool StreamingParser::parseNumberChar(char c) {
+  const bool digit = c >= '0' && c <= '9';
+  switch (number_) {
+  case Number::Start:
+    if (c == '-') {
+      number_ = Number::Sign;
+    } else {
+      number_ = c == '0' ? Number::Zero : Number::Integer;
+    }
+    break;
+  case Number::Sign:
+    if (!digit) {
+      throwError("invalid number");
+    }
+    number_ = c == '0' ? Number::Zero : Number::Integer;
+    break;
+  case Number::Zero:
+  case Number::Integer:
+    if (c == '.') {
+      number_ = Number::FractionStart;
+    } else if (c == 'e' || c == 'E') {
+      number_ = Number::ExponentStart;
+    } else if (!digit || number_ == Number::Zero) {
+      return false;
+    }
+    break;
+  case Number::FractionStart:
+  case Number::Fraction:
+    if (digit) {
+      number_ = Number::Fraction;
+    } else if (number_ == Number::FractionStart) {
+      throwError("invalid number");
+    } else if (c == 'e' || c == 'E') {
+      number_ = Number::ExponentStart;
+    } else {
+      return false;
+    }
+    break;
+  case Number::ExponentStart:
+    if (c == '+' || c == '-') {
+      number_ = Number::ExponentSign;
+      break;
+    }
+    FALLTHRU;
+  case Number::ExponentSign:
+  case Number::Exponent:
+    if (digit) {
+      number_ = Number::Exponent;
+    } else if (number_ != Number::Exponent) {
+      throwError("invalid number");
+    } else {
+      return false;
+    }
+    break;
+  }
+
+  if (reporting()) {
+    value_.push_back(c);
+  }
+  return true;
+}
+
+void StreamingParser::parseLiteralChar(char c) {
+  if (c != *literal_) {
+    throwError("invalid literal");
+  }
+
+  if (*++literal_ != '\0') {
+    return;
+  }
+
+  token_ = Token::None;
+  if (reporting()) {
+    if (literal_start_ == 'n') {
+      callbacks_.onNull();
+    } else {
+      callbacks_.onBool(literal_start_ == 't');
+    }
+  }
+  onValueEnd();
+}
+
+void StreamingParser::onStringEnd() {
+  token_ = Token::None;
+  if (key_) {
+    if (reporting()) {
+      callbacks_.onKey(value_);
+    }
+    expect_ = Expect::Colon;
+  } else {
+    if (reporting()) {
+      callbacks_.onString(value_);
+    }
+    onValueEnd();
+  }
+}
+
+void StreamingParser::onNumberEnd() {
+  token_ = Token::None;
+  if (reporting()) {
+    callbacks_.onNumber(std::strtod(value_.c_str(), nullptr));
+  }
+  onValueEnd();
+}
+
+void StreamingParser::onValueEnd() {
+  expect_ = stack_.empty() ? Expect::Done : Expect::CommaOrEnd;
+}
+
+void StreamingParser::appendCodePoint(uint32_t code_point) {
+  if (!reporting()) {
+    return;
+  }
+
+  if (code_point < 0x80) {
+    value_.push_back(code_point);
+  } else if (code_point < 0x800) {
+    value_.push_back(0xC0 | (code_point >> 6));
+    value_.push_back(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    value_.push_back(0xE0 | (code_point >> 12));
+    value_.push_back(0x80 | ((code_point >> 6) & 0x3F));
+    value_.push_back(0x80 | (code_point & 0x3F));
+  } else {
+    value_.push_back(0xF0 | (code_point >> 18));
+    value_.push_back(0x80 | ((code_point >> 12) & 0x3F));
+    value_.push_back(0x80 | ((code_point >> 6) & 0x3F));
+    value_.push_back(0x80 | (code_point & 0x3F));
+  }
+}
+
+void StreamingParser::throwError(const std::string& message) const {
+  throw Exception(
+      fmt::format("JSON supplied is not valid. Error(offset {}): {}", offset_, message));
+}
+
+} // namespace Json
+} // namespace Envoy
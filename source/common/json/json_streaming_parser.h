@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Json {
+
+/**
+ * Callbacks for the values found by a StreamingParser, in document order.
+ */
+class StreamingParserCallbacks {
+public:
+  virtual ~StreamingParserCallbacks() {}
+
+  virtual void onStartObject() PURE;
+
+  /**
+   * Called for each key of an object, before its value.
+   * @param key supplies the unescaped key.
+   */
+  virtual void onKey(const std::string& key) PURE;
+
+  virtual void onEndObject() PURE;
+  virtual void onStartArray() PURE;
+  virtual void onEndArray() PURE;
+
+  /**
+   * @param value supplies the unescaped string.
+   */
+  virtual void onString(const std::string& value) PURE;
+
+  virtual void onNumber(double value) PURE;
+  virtual void onBool(bool value) PURE;
+  virtual void onNull() PURE;
+};
+
+/**
+ * Incremental JSON parser. The document is pushed in as many chunks as it arrives in, and the
+ * parser keeps its state between chunks, so a document split over several buffers does not need to
+ * be copied together first. Unlike Json::Factory, the parser does not build any objects: it reports
+ * the values to StreamingParserCallbacks as they are parsed.
+ *
+ * Only the values down to max_depth levels of nesting are reported (the top level object or array
+ * is level 1, so its keys and values are reported if max_depth >= 1). Deeper values are still
+ * validated, but are skipped without being copied.
+ */
+class StreamingParser {
+public:
+  StreamingParser(StreamingParserCallbacks& callbacks, uint32_t max_depth);
+
+  /**
+   * Parse the next chunk of the document.
+   * @param data supplies the chunk.
+   * @param size supplies the size of the chunk.
+   * @throw Json::Exception if the document is not valid JSON.
+   */
+  void parse(const char* data, uint64_t size);
+
+  /**
+   * Signal the end of the document.
+   * @throw Json::Exception if the document is incomplete.
+   */
+  void finish();
+
+private:
+  enum class Expect { Value, ValueOrArrayEnd, KeyOrObjectEnd, Key, Colon, CommaOrEnd, Done };
+  enum class Token { None, String, Escape, Unicode, Number, Literal };
+  enum class Number {
+    Start,
+    Sign,
+    Zero,
+    Integer,
+    FractionStart,
+    Fraction,
+    ExponentStart,
+    ExponentSign,
+    Exponent
+  };
+
+  void parseChar(char c);
+  void parseValue(char c);
+  void startContainer(bool object);
+  void endContainer();
+  void parseStringChar(char c);
+  void parseEscapeChar(char c);
+  void parseUnicodeChar(char c);
+  bool parseNumberChar(char c);
+  void parseLiteralChar(char c);
+  void onStringEnd();
+  void onNumberEnd();
+  void onValueEnd();
+  void appendCodePoint(uint32_t code_point);
+  bool reporting() const { return stack_.size() <= max_depth_; }
+  [[noreturn]] void throwError(const std::string& message) const;
+
+  StreamingParserCallbacks& callbacks_;
+  const uint32_t max_depth_;
+  uint64_t offset_{};
+  Expect expect_{Expect::Value};
+  Token token_{Token::None};
+  // The open containers, true for an object and false for an array.
+  std::vector<bool> stack_;
+  // The text of the string or number being parsed, if it is reported.
+  std::string value_;
+  bool key_{};
+  Number number_{};
+  // The rest of the true, false or null literal being parsed.
+  const char* literal_{};
+  char literal_start_{};
+  uint32_t unicode_digits_{};
+  uint32_t unicode_value_{};
+  uint32_t high_surrogate_{};
+};
+
+} // namespace Json
+} // namespace Envoy
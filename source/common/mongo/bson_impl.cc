@@ -1,8 +1,11 @@
 #include "common/mongo/bson_impl.h"
 
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "common/common/assert.h"
 #include "common/common/byte_order.h"
@@ -13,6 +16,54 @@
 namespace Envoy {
 namespace Bson {
 
+namespace {
+
+// An empty document is its length and the terminating null byte.
+const int32_t MinDocumentSize = sizeof(int32_t) + 1;
+
+int32_t readInt32(const char* data) {
+  int32_t val;
+  std::memcpy(&val, data, sizeof(int32_t));
+  return le32toh(val);
+}
+
+int32_t readInt32(const char* data, uint32_t size) {
+  if (size < sizeof(int32_t)) {
+    throw EnvoyException("invalid buffer size");
+  }
+
+  return readInt32(data);
+}
+
+int64_t readInt64(const char* data) {
+  int64_t val;
+  std::memcpy(&val, data, sizeof(int64_t));
+  return le64toh(val);
+}
+
+double readDouble(const char* data) {
+  // See BufferHelper::removeDouble().
+  union {
+    int64_t i;
+    double d;
+  } memory;
+
+  static_assert(sizeof(memory.i) == sizeof(memory.d), "invalid type size");
+  memory.i = readInt64(data);
+  return memory.d;
+}
+
+// Check a length read from a document against the bytes that remain in it.
+uint32_t checkLength(int32_t length, int32_t min_length, uint32_t remaining) {
+  if (length < min_length || static_cast<uint32_t>(length) > remaining) {
+    throw EnvoyException("invalid BSON length");
+  }
+
+  return length;
+}
+
+} // namespace
+
 int32_t BufferHelper::peakInt32(Buffer::Instance& data) {
   if (data.length() < sizeof(int32_t)) {
     throw EnvoyException("invalid buffer size");
@@ -53,7 +104,7 @@ std::string BufferHelper::removeCString(Buffer::Instance& data) {
   }
 
   char* start = reinterpret_cast<char*>(data.linearize(index + 1));
-  std::string ret(start);
+  std::string ret(start, index);
   data.drain(index + 1);
   return ret;
 }
@@ -354,130 +405,239 @@ std::string FieldImpl::toString() const {
   NOT_REACHED;
 }
 
-void DocumentImpl::fromBuffer(Buffer::Instance& data) {
-  uint64_t original_buffer_length = data.length();
-  int32_t message_length = BufferHelper::removeInt32(data);
-  if (static_cast<uint64_t>(message_length) > original_buffer_length) {
+DocumentSharedPtr DocumentImpl::create(Buffer::Instance& data) {
+  int32_t message_length = BufferHelper::peakInt32(data);
+  if (message_length < MinDocumentSize || static_cast<uint64_t>(message_length) > data.length()) {
     throw EnvoyException("invalid BSON message length");
   }
 
-  ENVOY_LOG(trace, "BSON document length: {} data length: {}", message_length,
-            original_buffer_length);
+  ENVOY_LOG(trace, "BSON document length: {} data length: {}", message_length, data.length());
+  std::shared_ptr<std::string> raw(new std::string(message_length, 0));
+  data.copyOut(0, message_length, &(*raw)[0]);
+  data.drain(message_length);
+  return DocumentSharedPtr{new DocumentImpl(raw, 0, message_length, false)};
+}
 
-  while (true) {
-    uint64_t document_bytes_remaining = data.length() - (original_buffer_length - message_length);
-    ENVOY_LOG(trace, "BSON document bytes remaining: {}", document_bytes_remaining);
-    if (document_bytes_remaining == 1) {
-      uint8_t last_byte = BufferHelper::removeByte(data);
-      if (last_byte != 0) {
-        throw EnvoyException("invalid document");
-      }
+DocumentImpl::DocumentImpl(RawDocumentSharedPtr raw, uint32_t offset, uint32_t size,
+                           bool validated)
+    : raw_(raw), raw_offset_(offset), raw_size_(size) {
+  parseFields(*raw_, raw_offset_, raw_size_, &lazy_fields_, !validated);
+}
 
-      return;
+void DocumentImpl::parseFields(const std::string& raw, uint32_t offset, uint32_t size,
+                               std::vector<LazyField>* fields, bool validate_sub_documents) {
+  ASSERT(size >= static_cast<uint32_t>(MinDocumentSize) && offset + size <= raw.size());
+  const char* data = raw.data();
+
+  // The last byte of the document terminates it.
+  const uint32_t end = offset + size - 1;
+  uint32_t current = offset + sizeof(int32_t);
+  while (current < end) {
+    const uint8_t element_type = data[current++];
+    const char* key_end = static_cast<const char*>(memchr(data + current, 0, end - current));
+    if (key_end == nullptr) {
+      throw EnvoyException("invalid CString");
     }
 
-    uint8_t element_type = BufferHelper::removeByte(data);
-    std::string key = BufferHelper::removeCString(data);
-    ENVOY_LOG(trace, "BSON element type: {:#x} key: {}", element_type, key);
+    const uint32_t key_offset = current;
+    const uint32_t key_size = key_end - (data + current);
+    current += key_size + 1;
+    const uint32_t remaining = end - current;
+    const char* value = data + current;
+    uint32_t value_size;
     switch (static_cast<Field::Type>(element_type)) {
-    case Field::Type::DOUBLE: {
-      double value = BufferHelper::removeDouble(data);
-      ENVOY_LOG(trace, "BSON double: {}", value);
-      addDouble(key, value);
+    case Field::Type::DOUBLE:
+    case Field::Type::DATETIME:
+    case Field::Type::TIMESTAMP:
+    case Field::Type::INT64: {
+      value_size = sizeof(int64_t);
       break;
     }
 
     case Field::Type::STRING: {
-      std::string value = BufferHelper::removeString(data);
-      ENVOY_LOG(trace, "BSON string: {}", value);
-      addString(key, std::move(value));
-      break;
-    }
-
-    case Field::Type::DOCUMENT: {
-      ENVOY_LOG(trace, "BSON document");
-      addDocument(key, DocumentImpl::create(data));
+      // A string is followed by a null byte that is included in its length.
+      value_size = sizeof(int32_t) + checkLength(readInt32(value, remaining), 1, remaining);
       break;
     }
 
+    case Field::Type::DOCUMENT:
     case Field::Type::ARRAY: {
-      ENVOY_LOG(trace, "BSON array");
-      addArray(key, DocumentImpl::create(data));
+      value_size = checkLength(readInt32(value, remaining), MinDocumentSize, remaining);
+      if (validate_sub_documents) {
+        parseFields(raw, current, value_size, nullptr, true);
+      }
       break;
     }
 
     case Field::Type::BINARY: {
-      std::string value = BufferHelper::removeBinary(data);
-      ENVOY_LOG(trace, "BSON binary: {}", value);
-      addBinary(key, std::move(value));
+      // The length does not include the subtype byte.
+      value_size = sizeof(int32_t) + 1 + checkLength(readInt32(value, remaining), 0, remaining);
       break;
     }
 
     case Field::Type::OBJECT_ID: {
-      Field::ObjectId value;
-      BufferHelper::removeBytes(data, &value[0], value.size());
-      addObjectId(key, std::move(value));
+      value_size = sizeof(Field::ObjectId);
       break;
     }
 
     case Field::Type::BOOLEAN: {
-      bool value = BufferHelper::removeByte(data) != 0;
-      ENVOY_LOG(trace, "BSON boolean: {}", value);
-      addBoolean(key, value);
-      break;
-    }
-
-    case Field::Type::DATETIME: {
-      int64_t value = BufferHelper::removeInt64(data);
-      ENVOY_LOG(trace, "BSON datetime: {}", value);
-      addDatetime(key, value);
+      value_size = 1;
       break;
     }
 
     case Field::Type::NULL_VALUE: {
-      ENVOY_LOG(trace, "BSON null value");
-      addNull(key);
+      value_size = 0;
       break;
     }
 
     case Field::Type::REGEX: {
-      Field::Regex value;
-      value.pattern_ = BufferHelper::removeCString(data);
-      value.options_ = BufferHelper::removeCString(data);
-      ENVOY_LOG(trace, "BSON regex pattern: {} options: {}", value.pattern_, value.options_);
-      addRegex(key, std::move(value));
+      // A pattern and options CString.
+      const char* pattern_end = static_cast<const char*>(memchr(value, 0, remaining));
+      if (pattern_end == nullptr) {
+        throw EnvoyException("invalid CString");
+      }
+
+      const char* options = pattern_end + 1;
+      const char* options_end =
+          static_cast<const char*>(memchr(options, 0, value + remaining - options));
+      if (options_end == nullptr) {
+        throw EnvoyException("invalid CString");
+      }
+
+      value_size = options_end + 1 - value;
       break;
     }
 
     case Field::Type::INT32: {
-      int32_t value = BufferHelper::removeInt32(data);
-      ENVOY_LOG(trace, "BSON int32: {}", value);
-      addInt32(key, value);
+      value_size = sizeof(int32_t);
       break;
     }
 
-    case Field::Type::TIMESTAMP: {
-      int64_t value = BufferHelper::removeInt64(data);
-      ENVOY_LOG(trace, "BSON timestamp: {}", value);
-      addTimestamp(key, value);
-      break;
+    default:
+      throw EnvoyException(fmt::format("invalid BSON element type: {:#x} key: {}", element_type,
+                                       std::string(data + key_offset, key_size)));
     }
 
-    case Field::Type::INT64: {
-      int64_t value = BufferHelper::removeInt64(data);
-      ENVOY_LOG(trace, "BSON int64: {}", value);
-      addInt64(key, value);
-      break;
+    if (value_size > remaining) {
+      throw EnvoyException("invalid buffer size");
     }
 
-    default:
-      throw EnvoyException(
-          fmt::format("invalid BSON element type: {:#x} key: {}", element_type, key));
+    if (fields != nullptr) {
+      fields->push_back({static_cast<Field::Type>(element_type), key_offset, key_size, current,
+                         nullptr});
     }
+
+    current += value_size;
+  }
+
+  if (data[end] != 0) {
+    throw EnvoyException("invalid document");
+  }
+}
+
+FieldPtr DocumentImpl::createField(const LazyField& field) const {
+  const char* value = raw_->data() + field.value_offset_;
+  const std::string key(raw_->data() + field.key_offset_, field.key_size_);
+
+  // The lengths and sizes of values, including the whole of sub-documents, were validated when the
+  // top level document was parsed.
+  switch (field.type_) {
+  case Field::Type::DOUBLE: {
+    return FieldPtr{new FieldImpl(key, readDouble(value))};
+  }
+
+  case Field::Type::STRING: {
+    return FieldPtr{new FieldImpl(Field::Type::STRING, key,
+                                  std::string(value + sizeof(int32_t), readInt32(value) - 1))};
+  }
+
+  case Field::Type::DOCUMENT:
+  case Field::Type::ARRAY: {
+    return FieldPtr{new FieldImpl(
+        field.type_, key,
+        DocumentSharedPtr{new DocumentImpl(raw_, field.value_offset_, readInt32(value), true)})};
+  }
+
+  case Field::Type::BINARY: {
+    // Skip the subtype, which is not stored for now.
+    return FieldPtr{new FieldImpl(Field::Type::BINARY, key,
+                                  std::string(value + sizeof(int32_t) + 1, readInt32(value)))};
+  }
+
+  case Field::Type::OBJECT_ID: {
+    Field::ObjectId object_id;
+    std::memcpy(&object_id[0], value, object_id.size());
+    return FieldPtr{new FieldImpl(key, std::move(object_id))};
+  }
+
+  case Field::Type::BOOLEAN: {
+    return FieldPtr{new FieldImpl(key, value[0] != 0)};
+  }
+
+  case Field::Type::DATETIME:
+  case Field::Type::TIMESTAMP:
+  case Field::Type::INT64: {
+    return FieldPtr{new FieldImpl(field.type_, key, readInt64(value))};
+  }
+
+  case Field::Type::NULL_VALUE: {
+    return FieldPtr{new FieldImpl(key)};
+  }
+
+  case Field::Type::REGEX: {
+    Field::Regex regex;
+    regex.pattern_ = value;
+    regex.options_ = value + regex.pattern_.size() + 1;
+    return FieldPtr{new FieldImpl(key, std::move(regex))};
+  }
+
+  case Field::Type::INT32: {
+    return FieldPtr{new FieldImpl(key, readInt32(value))};
+  }
+  }
+
+  NOT_REACHED;
+}
+
+const Field& DocumentImpl::lazyField(LazyField& field) const {
+  if (!field.field_) {
+    field.field_ = createField(field);
   }
+
+  return *field.field_;
+}
+
+bool DocumentImpl::lazyFieldKeyEquals(const LazyField& field, const std::string& name) const {
+  return field.key_size_ == name.size() &&
+         std::memcmp(raw_->data() + field.key_offset_, name.data(), name.size()) == 0;
+}
+
+void DocumentImpl::materialize() const {
+  for (LazyField& field : lazy_fields_) {
+    fields_.emplace_back(field.field_ ? std::move(field.field_) : createField(field));
+  }
+
+  lazy_fields_.clear();
+}
+
+DocumentSharedPtr DocumentImpl::addField(FieldImpl* field) {
+  // The document no longer matches its bytes.
+  materialize();
+  raw_.reset();
+  fields_.emplace_back(field);
+  return shared_from_this();
+}
+
+const std::list<FieldPtr>& DocumentImpl::values() const {
+  materialize();
+  return fields_;
 }
 
 int32_t DocumentImpl::byteSize() const {
+  if (raw_) {
+    return raw_size_;
+  }
+
   // Minimum size is 5.
   int32_t total_size = sizeof(int32_t) + 1;
   for (const FieldPtr& field : fields_) {
@@ -488,6 +648,11 @@ int32_t DocumentImpl::byteSize() const {
 }
 
 void DocumentImpl::encode(Buffer::Instance& output) const {
+  if (raw_) {
+    output.add(raw_->data() + raw_offset_, raw_size_);
+    return;
+  }
+
   BufferHelper::writeInt32(output, byteSize());
   for (const FieldPtr& field : fields_) {
     field->encode(output);
@@ -518,7 +683,7 @@ std::string DocumentImpl::toString() const {
   out << "{";
 
   bool first = true;
-  for (const FieldPtr& field : fields_) {
+  for (const FieldPtr& field : values()) {
     if (!first) {
       out << ", ";
     }
@@ -532,6 +697,12 @@ std::string DocumentImpl::toString() const {
 }
 
 const Field* DocumentImpl::find(const std::string& name) const {
+  for (LazyField& field : lazy_fields_) {
+    if (lazyFieldKeyEquals(field, name)) {
+      return &lazyField(field);
+    }
+  }
+
   for (const FieldPtr& field : fields_) {
     if (field->key() == name) {
       return field.get();
@@ -542,6 +713,12 @@ const Field* DocumentImpl::find(const std::string& name) const {
 }
 
 const Field* DocumentImpl::find(const std::string& name, Field::Type type) const {
+  for (LazyField& field : lazy_fields_) {
+    if (field.type_ == type && lazyFieldKeyEquals(field, name)) {
+      return &lazyField(field);
+    }
+  }
+
   for (const FieldPtr& field : fields_) {
     if (field->key() == name && field->type() == type) {
       return field.get();
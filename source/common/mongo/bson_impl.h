@@ -3,6 +3,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/buffer/buffer.h"
 #include "envoy/common/exception.h"
@@ -168,81 +169,71 @@ private:
   Value value_;
 };
 
+/**
+ * A BSON document. A document that is read from a buffer keeps a copy of its bytes and an index of
+ * the offsets of its fields, and only creates the fields that are looked up with find(). All of the
+ * fields are created the first time values() is called. Sub-documents are read from the same bytes
+ * when their field is created. A document that has not been modified is encoded by copying its
+ * bytes.
+ */
 class DocumentImpl : public Document,
                      Logger::Loggable<Logger::Id::mongo>,
                      public std::enable_shared_from_this<DocumentImpl> {
 public:
   static DocumentSharedPtr create() { return DocumentSharedPtr{new DocumentImpl()}; }
-  static DocumentSharedPtr create(Buffer::Instance& data) {
-    std::shared_ptr<DocumentImpl> new_doc{new DocumentImpl()};
-    new_doc->fromBuffer(data);
-    return new_doc;
-  }
+  static DocumentSharedPtr create(Buffer::Instance& data);
 
   // Mongo::Document
   DocumentSharedPtr addDouble(const std::string& key, double value) override {
-    fields_.emplace_back(new FieldImpl(key, value));
-    return shared_from_this();
+    return addField(new FieldImpl(key, value));
   }
 
   DocumentSharedPtr addString(const std::string& key, std::string&& value) override {
-    fields_.emplace_back(new FieldImpl(Field::Type::STRING, key, std::move(value)));
-    return shared_from_this();
+    return addField(new FieldImpl(Field::Type::STRING, key, std::move(value)));
   }
 
   DocumentSharedPtr addDocument(const std::string& key, DocumentSharedPtr value) override {
-    fields_.emplace_back(new FieldImpl(Field::Type::DOCUMENT, key, value));
-    return shared_from_this();
+    return addField(new FieldImpl(Field::Type::DOCUMENT, key, value));
   }
 
   DocumentSharedPtr addArray(const std::string& key, DocumentSharedPtr value) override {
-    fields_.emplace_back(new FieldImpl(Field::Type::ARRAY, key, value));
-    return shared_from_this();
+    return addField(new FieldImpl(Field::Type::ARRAY, key, value));
   }
 
   DocumentSharedPtr addBinary(const std::string& key, std::string&& value) override {
-    fields_.emplace_back(new FieldImpl(Field::Type::BINARY, key, std::move(value)));
-    return shared_from_this();
+    return addField(new FieldImpl(Field::Type::BINARY, key, std::move(value)));
   }
 
   DocumentSharedPtr addObjectId(const std::string& key, Field::ObjectId&& value) override {
-    fields_.emplace_back(new FieldImpl(key, std::move(value)));
-    return shared_from_this();
+    return addField(new FieldImpl(key, std::move(value)));
   }
 
   DocumentSharedPtr addBoolean(const std::string& key, bool value) override {
-    fields_.emplace_back(new FieldImpl(key, value));
-    return shared_from_this();
+    return addField(new FieldImpl(key, value));
   }
 
   DocumentSharedPtr addDatetime(const std::string& key, int64_t value) override {
-    fields_.emplace_back(new FieldImpl(Field::Type::DATETIME, key, value));
-    return shared_from_this();
+    return addField(new FieldImpl(Field::Type::DATETIME, key, value));
   }
 
   DocumentSharedPtr addNull(const std::string& key) override {
-    fields_.emplace_back(new FieldImpl(key));
-    return shared_from_this();
+    return addField(new FieldImpl(key));
   }
 
   DocumentSharedPtr addRegex(const std::string& key, Field::Regex&& value) override {
-    fields_.emplace_back(new FieldImpl(key, std::move(value)));
-    return shared_from_this();
+    return addField(new FieldImpl(key, std::move(value)));
   }
 
   DocumentSharedPtr addInt32(const std::string& key, int32_t value) override {
-    fields_.emplace_back(new FieldImpl(key, value));
-    return shared_from_this();
+    return addField(new FieldImpl(key, value));
   }
 
   DocumentSharedPtr addTimestamp(const std::string& key, int64_t value) override {
-    fields_.emplace_back(new FieldImpl(Field::Type::TIMESTAMP, key, value));
-    return shared_from_this();
+    return addField(new FieldImpl(Field::Type::TIMESTAMP, key, value));
   }
 
   DocumentSharedPtr addInt64(const std::string& key, int64_t value) override {
-    fields_.emplace_back(new FieldImpl(Field::Type::INT64, key, value));
-    return shared_from_this();
+    return addField(new FieldImpl(Field::Type::INT64, key, value));
   }
 
   bool operator==(const Document& rhs) const override;
@@ -251,14 +242,58 @@ public:
   const Field* find(const std::string& name) const override;
   const Field* find(const std::string& name, Field::Type type) const override;
   std::string toString() const override;
-  const std::list<FieldPtr>& values() const override { return fields_; }
+  const std::list<FieldPtr>& values() const override;
 
 private:
+  /**
+   * The location of a field in the bytes of a document read from a buffer, and the field once it
+   * has been created.
+   */
+  struct LazyField {
+    Field::Type type_;
+    uint32_t key_offset_;
+    uint32_t key_size_;
+    uint32_t value_offset_;
+    FieldPtr field_;
+  };
+
+  typedef std::shared_ptr<const std::string> RawDocumentSharedPtr;
+
   DocumentImpl() {}
+  /**
+   * Index the fields of a document read from a buffer.
+   * @param validated supplies whether the document was already validated as part of its parent,
+   *        in which case its sub-documents are not walked again.
+   */
+  DocumentImpl(RawDocumentSharedPtr raw, uint32_t offset, uint32_t size, bool validated);
 
-  void fromBuffer(Buffer::Instance& data);
+  DocumentSharedPtr addField(FieldImpl* field);
+  FieldPtr createField(const LazyField& field) const;
+  const Field& lazyField(LazyField& field) const;
+  bool lazyFieldKeyEquals(const LazyField& field, const std::string& name) const;
+  void materialize() const;
 
-  std::list<FieldPtr> fields_;
+  /**
+   * Validate a document and optionally index its fields. Sub-documents are never indexed.
+   * @param raw supplies the bytes that contain the document.
+   * @param offset supplies the offset of the document in raw.
+   * @param size supplies the size of the document.
+   * @param fields supplies where to add the fields of the document, or nullptr to only validate it.
+   * @param validate_sub_documents supplies whether to recursively validate sub-documents. Only the
+   *        top level document needs to, so that every byte of a message is validated once.
+   */
+  static void parseFields(const std::string& raw, uint32_t offset, uint32_t size,
+                          std::vector<LazyField>* fields, bool validate_sub_documents);
+
+  // The bytes of a document read from a buffer, which are shared with its sub-documents. Null for
+  // documents that were built or modified with add*().
+  RawDocumentSharedPtr raw_;
+  uint32_t raw_offset_{};
+  uint32_t raw_size_{};
+  // Only one of these holds the fields of the document: lazy_fields_ until the fields are created
+  // by values() and fields_ after that.
+  mutable std::vector<LazyField> lazy_fields_;
+  mutable std::list<FieldPtr> fields_;
 };
 
 } // namespace Bson
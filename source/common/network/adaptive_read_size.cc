@@ -0,0 +1,28 @@
+#include "common/network/adaptive_read_size.h"
+
+#include <algorithm>
+
+namespace Envoy {
+namespace Network {
+
+constexpr uint64_t AdaptiveReadSize::MIN_READ_SIZE;
+constexpr uint64_t AdaptiveReadSize::INITIAL_READ_SIZE;
+constexpr uint64_t AdaptiveReadSize::MAX_READ_SIZE;
+
+uint64_t AdaptiveReadSize::readSize(uint64_t buffer_limit) const {
+  if (buffer_limit == 0) {
+    return read_size_;
+  }
+  return std::max(std::min(read_size_, buffer_limit), MIN_READ_SIZE);
+}
+
+void AdaptiveReadSize::onReadEvent(uint64_t bytes_read) {
+  if (bytes_read >= read_size_) {
+    read_size_ = std::min(read_size_ * 2, MAX_READ_SIZE);
+  } else if (bytes_read < read_size_ / 4) {
+    read_size_ = std::max(read_size_ / 2, MIN_READ_SIZE);
+  }
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * Per connection size of the reads done by a transport socket. The size doubles after every read
+ * event that read at least the current size, so that bulk transfers take fewer and larger reads.
+ * It halves after every read event that read less than a quarter of it, so that mostly idle or
+ * chatty connections do not reserve large read buffers.
+ */
+class AdaptiveReadSize {
+public:
+  static constexpr uint64_t MIN_READ_SIZE = 4096;
+  static constexpr uint64_t INITIAL_READ_SIZE = 16384;
+  static constexpr uint64_t MAX_READ_SIZE = 262144;
+
+  /**
+   * @param buffer_limit supplies the connection's buffer limit, or 0 if there is none. A non-zero
+   *        limit caps the read size (but never below MIN_READ_SIZE).
+   * @return the number of bytes to read in the next read call.
+   */
+  uint64_t readSize(uint64_t buffer_limit) const;
+
+  /**
+   * Update the read size at the end of a read event.
+   * @param bytes_read supplies the total number of bytes read during the event.
+   */
+  void onReadEvent(uint64_t bytes_read);
+
+private:
+  uint64_t read_size_{INITIAL_READ_SIZE};
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -138,6 +138,7 @@ void ConnectionImpl::closeSocket(ConnectionEvent close_type) {
   updateReadBufferStats(0, 0);
   updateWriteBufferStats(0, 0);
   connection_stats_.reset();
+  setBufferMemoryAccount(nullptr);
 
   file_event_.reset();
   socket_->close();
@@ -328,6 +329,7 @@ void ConnectionImpl::write(Buffer::Instance& data, bool end_stream) {
     // we never change existing write_buffer_ chain elements between calls to SSL_write(). That code
     // might need to change if we ever copy here.
     write_buffer_->move(data);
+    updateBufferMemoryAccount();
 
     // Activating a write event before the socket is connected has the side-effect of tricking
     // doWriteReady into thinking the socket is connected. On OS X, the underlying write may fail
@@ -364,6 +366,29 @@ void ConnectionImpl::setBufferLimits(uint32_t limit) {
   }
 }
 
+void ConnectionImpl::setBufferMemoryAccount(Buffer::MemoryAccount* account) {
+  if (buffer_memory_account_ != nullptr && buffer_memory_account_bytes_ > 0) {
+    buffer_memory_account_->credit(buffer_memory_account_bytes_);
+  }
+  buffer_memory_account_ = account;
+  buffer_memory_account_bytes_ = 0;
+  updateBufferMemoryAccount();
+}
+
+void ConnectionImpl::updateBufferMemoryAccount() {
+  if (buffer_memory_account_ == nullptr) {
+    return;
+  }
+
+  const uint64_t new_bytes = read_buffer_.length() + write_buffer_->length();
+  if (new_bytes > buffer_memory_account_bytes_) {
+    buffer_memory_account_->charge(new_bytes - buffer_memory_account_bytes_);
+  } else if (new_bytes < buffer_memory_account_bytes_) {
+    buffer_memory_account_->credit(buffer_memory_account_bytes_ - new_bytes);
+  }
+  buffer_memory_account_bytes_ = new_bytes;
+}
+
 void ConnectionImpl::onLowWatermark() {
   ENVOY_CONN_LOG(debug, "onBelowWriteBufferLowWatermark", *this);
   ASSERT(above_high_watermark_);
@@ -443,6 +468,10 @@ void ConnectionImpl::onReadReady() {
     onRead(new_buffer_size);
   }
 
+  // The filters have consumed what they could of the read buffer. This does nothing if they closed
+  // the connection.
+  updateBufferMemoryAccount();
+
   // The read callback may have already closed the connection.
   if (result.action_ == PostIoAction::Close || bothSidesHalfClosed()) {
     ENVOY_CONN_LOG(debug, "remote close", *this);
@@ -480,6 +509,7 @@ void ConnectionImpl::onWriteReady() {
   ASSERT(!result.end_stream_read_); // The interface guarantees that only read operations set this.
   uint64_t new_buffer_size = write_buffer_->length();
   updateWriteBufferStats(result.bytes_processed_, new_buffer_size);
+  updateBufferMemoryAccount();
 
   if (result.action_ == PostIoAction::Close) {
     // It is possible (though unlikely) for the connection to have already been closed during the
@@ -83,6 +83,7 @@ public:
   void write(Buffer::Instance& data, bool end_stream) override;
   void setBufferLimits(uint32_t limit) override;
   uint32_t bufferLimit() const override { return read_buffer_limit_; }
+  void setBufferMemoryAccount(Buffer::MemoryAccount* account) override;
   bool localAddressRestored() const override { return socket_->localAddressRestored(); }
   bool aboveHighWatermark() const override { return above_high_watermark_; }
   const ConnectionSocket::OptionsSharedPtr& socketOptions() const override {
@@ -134,6 +135,7 @@ protected:
 private:
   void onFileEvent(uint32_t events);
   void onRead(uint64_t read_buffer_size);
+  void updateBufferMemoryAccount();
   void onReadReady();
   void onWriteReady();
   void updateReadBufferStats(uint64_t num_read, uint64_t new_size);
@@ -161,6 +163,9 @@ private:
   uint64_t last_read_buffer_size_{};
   uint64_t last_write_buffer_size_{};
   std::unique_ptr<ConnectionStats> connection_stats_;
+  Buffer::MemoryAccount* buffer_memory_account_{};
+  // The number of bytes currently charged to buffer_memory_account_.
+  uint64_t buffer_memory_account_bytes_{};
   // Tracks the number of times reads have been disabled. If N different components call
   // readDisabled(true) this allows the connection to only resume reads when readDisabled(false)
   // has been called N times.
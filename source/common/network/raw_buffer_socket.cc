@@ -15,13 +15,9 @@ IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
   PostIoAction action = PostIoAction::KeepOpen;
   uint64_t bytes_read = 0;
   bool end_stream = false;
+  const uint64_t read_size = read_size_.readSize(callbacks_->connection().bufferLimit());
   do {
-    // 16K read is arbitrary. IIRC, libevent will currently clamp this to 4K. libevent will also
-    // use an ioctl() before every read to figure out how much data there is to read.
-    //
-    // TODO(mattklein123) PERF: Tune the read size and figure out a way of getting rid of the
-    // ioctl(). The extra syscall is not worth it.
-    int rc = buffer.read(callbacks_->fd(), 16384);
+    int rc = buffer.read(callbacks_->fd(), read_size);
     ENVOY_CONN_LOG(trace, "read returns: {}", callbacks_->connection(), rc);
 
     if (rc == 0) {
@@ -45,6 +41,7 @@ IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
     }
   } while (true);
 
+  read_size_.onReadEvent(bytes_read);
   return {action, bytes_read, end_stream};
 }
 
@@ -4,6 +4,7 @@
 #include "envoy/network/transport_socket.h"
 
 #include "common/common/logger.h"
+#include "common/network/adaptive_read_size.h"
 
 namespace Envoy {
 namespace Network {
@@ -23,6 +24,7 @@ public:
 
 private:
   TransportSocketCallbacks* callbacks_{};
+  AdaptiveReadSize read_size_;
   bool shutdown_{};
 };
 
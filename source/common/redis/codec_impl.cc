@@ -1,9 +1,12 @@
 #include "common/redis/codec_impl.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
 #include "common/common/utility.h"
@@ -11,6 +14,30 @@
 namespace Envoy {
 namespace Redis {
 
+namespace {
+
+/**
+ * A fragment that references a slice of a buffered bulk string. It holds a reference to the
+ * buffer, which keeps the slice alive until the fragment is drained from the buffer it was added
+ * to.
+ */
+class BulkStringFragment : public Buffer::BufferFragment {
+public:
+  BulkStringFragment(const Buffer::RawSlice& slice, const std::shared_ptr<Buffer::Instance>& buffer)
+      : slice_(slice), buffer_(buffer) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return slice_.mem_; }
+  size_t size() const override { return slice_.len_; }
+  void done() override { delete this; }
+
+private:
+  const Buffer::RawSlice slice_;
+  const std::shared_ptr<Buffer::Instance> buffer_;
+};
+
+} // namespace
+
 std::string RespValue::toString() const {
   switch (type_) {
   case RespType::Array: {
@@ -26,6 +53,12 @@ std::string RespValue::toString() const {
   case RespType::SimpleString:
   case RespType::BulkString:
   case RespType::Error:
+    if (buffer_) {
+      // Format a copy of the bytes so that the value keeps its buffer.
+      std::string string(buffer_->length(), 0);
+      buffer_->copyOut(0, buffer_->length(), &string[0]);
+      return fmt::format("\"{}\"", string);
+    }
     return fmt::format("\"{}\"", asString());
   case RespType::Null:
     return "null";
@@ -49,15 +82,27 @@ const std::vector<RespValue>& RespValue::asArray() const {
 std::string& RespValue::asString() {
   ASSERT(type_ == RespType::BulkString || type_ == RespType::Error ||
          type_ == RespType::SimpleString);
+  unbuffer();
   return string_;
 }
 
 const std::string& RespValue::asString() const {
   ASSERT(type_ == RespType::BulkString || type_ == RespType::Error ||
          type_ == RespType::SimpleString);
+  unbuffer();
   return string_;
 }
 
+std::shared_ptr<Buffer::Instance>& RespValue::asBuffer() {
+  ASSERT(type_ == RespType::BulkString);
+  return buffer_;
+}
+
+const std::shared_ptr<Buffer::Instance>& RespValue::asBuffer() const {
+  ASSERT(type_ == RespType::BulkString);
+  return buffer_;
+}
+
 int64_t& RespValue::asInteger() {
   ASSERT(type_ == RespType::Integer);
   return integer_;
@@ -68,7 +113,18 @@ int64_t RespValue::asInteger() const {
   return integer_;
 }
 
+void RespValue::unbuffer() const {
+  if (buffer_) {
+    ASSERT(string_.empty());
+    string_.resize(buffer_->length());
+    buffer_->copyOut(0, buffer_->length(), &string_[0]);
+    buffer_.reset();
+  }
+}
+
 void RespValue::cleanup() {
+  buffer_.reset();
+
   // Need to manually delete because of the union.
   switch (type_) {
   case RespType::Array: {
@@ -112,21 +168,41 @@ void RespValue::type(RespType type) {
 }
 
 void DecoderImpl::decode(Buffer::Instance& data) {
-  uint64_t num_slices = data.getRawSlices(nullptr, 0);
-  Buffer::RawSlice slices[num_slices];
-  data.getRawSlices(slices, num_slices);
-  for (const Buffer::RawSlice& slice : slices) {
-    parseSlice(slice);
-  }
+  while (data.length() > 0) {
+    if (state_ == State::BulkStringBuffer) {
+      // Whole slices of the data are moved into the value's buffer without copying their bytes.
+      const uint64_t length = std::min(pending_integer_.integer_, data.length());
+      pending_value_stack_.front().value_->asBuffer()->move(data, length);
+      pending_integer_.integer_ -= length;
+      if (pending_integer_.integer_ == 0) {
+        ENVOY_LOG(trace, "parse slice: BulkStringBuffer complete");
+        state_ = State::CR;
+      }
+
+      continue;
+    }
+
+    uint64_t num_slices = data.getRawSlices(nullptr, 0);
+    Buffer::RawSlice slices[num_slices];
+    data.getRawSlices(slices, num_slices);
+    uint64_t parsed = 0;
+    for (const Buffer::RawSlice& slice : slices) {
+      const uint64_t slice_parsed = parseSlice(slice);
+      parsed += slice_parsed;
+      if (slice_parsed < slice.len_) {
+        break;
+      }
+    }
 
-  data.drain(data.length());
+    data.drain(parsed);
+  }
 }
 
-void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
+uint64_t DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
   const char* buffer = reinterpret_cast<const char*>(slice.mem_);
   uint64_t remaining = slice.len_;
 
-  while (remaining || state_ == State::ValueComplete) {
+  while ((remaining || state_ == State::ValueComplete) && state_ != State::BulkStringBuffer) {
     ENVOY_LOG(trace, "parse slice: {} remaining", remaining);
     switch (state_) {
     case State::ValueRootStart: {
@@ -240,7 +316,10 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
         state_ = State::ValueComplete;
       } else {
         ASSERT(current_value.value_->type() == RespType::BulkString);
-        if (!pending_integer_.negative_) {
+        if (!pending_integer_.negative_ && pending_integer_.integer_ >= MinBufferedBulkStringSize) {
+          current_value.value_->asBuffer().reset(new Buffer::OwnedImpl());
+          state_ = State::BulkStringBuffer;
+        } else if (!pending_integer_.negative_) {
           // TODO(mattklein123): reserve and define max length since we don't stream currently.
           state_ = State::BulkStringBody;
         } else {
@@ -271,6 +350,10 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
       break;
     }
 
+    case State::BulkStringBuffer: {
+      NOT_REACHED;
+    }
+
     case State::CR: {
       ENVOY_LOG(trace, "parse slice: CR");
       if (buffer[0] != '\r') {
@@ -330,6 +413,8 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
     }
     }
   }
+
+  return slice.len_ - remaining;
 }
 
 void EncoderImpl::encode(const RespValue& value, Buffer::Instance& out) {
@@ -343,7 +428,11 @@ void EncoderImpl::encode(const RespValue& value, Buffer::Instance& out) {
     break;
   }
   case RespType::BulkString: {
-    encodeBulkString(value.asString(), out);
+    if (value.asBuffer()) {
+      encodeBulkStringBuffer(value.asBuffer(), out);
+    } else {
+      encodeBulkString(value.asString(), out);
+    }
     break;
   }
   case RespType::Error: {
@@ -386,6 +475,27 @@ void EncoderImpl::encodeBulkString(const std::string& string, Buffer::Instance&
   out.add("\r\n", 2);
 }
 
+void EncoderImpl::encodeBulkStringBuffer(const std::shared_ptr<Buffer::Instance>& buffer,
+                                         Buffer::Instance& out) {
+  char header[32];
+  char* current = header;
+  *current++ = '$';
+  current += StringUtil::itoa(current, 31, buffer->length());
+  *current++ = '\r';
+  *current++ = '\n';
+  out.add(header, current - header);
+
+  // Reference the slices of the buffer instead of copying them.
+  uint64_t num_slices = buffer->getRawSlices(nullptr, 0);
+  Buffer::RawSlice slices[num_slices];
+  buffer->getRawSlices(slices, num_slices);
+  for (const Buffer::RawSlice& slice : slices) {
+    out.addBufferFragment(*new BulkStringFragment(slice, buffer));
+  }
+
+  out.add("\r\n", 2);
+}
+
 void EncoderImpl::encodeError(const std::string& string, Buffer::Instance& out) {
   out.add("-", 1);
   out.add(string);
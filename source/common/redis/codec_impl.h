@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <forward_list>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -16,6 +17,8 @@ namespace Redis {
  * Decoder implementation of https://redis.io/topics/protocol
  *
  * This implementation buffers when needed and will always consume all bytes passed for decoding.
+ * The bodies of bulk strings of at least MinBufferedBulkStringSize bytes are moved into the value's
+ * buffer (see RespValue::asBuffer()) instead of being copied into its string.
  */
 class DecoderImpl : public Decoder, Logger::Loggable<Logger::Id::redis> {
 public:
@@ -24,6 +27,8 @@ public:
   // Redis::Decoder
   void decode(Buffer::Instance& data) override;
 
+  static const uint64_t MinBufferedBulkStringSize = 16384;
+
 private:
   enum class State {
     ValueRootStart,
@@ -32,6 +37,7 @@ private:
     Integer,
     IntegerLF,
     BulkStringBody,
+    BulkStringBuffer,
     CR,
     LF,
     SimpleString,
@@ -53,7 +59,12 @@ private:
     uint64_t current_array_element_;
   };
 
-  void parseSlice(const Buffer::RawSlice& slice);
+  /**
+   * Parse a slice of the data being decoded.
+   * @return uint64_t the number of bytes parsed. Parsing stops early at the body of a bulk string
+   *         that is moved into a buffer by decode().
+   */
+  uint64_t parseSlice(const Buffer::RawSlice& slice);
 
   DecoderCallbacks& callbacks_;
   State state_{State::ValueRootStart};
@@ -84,6 +95,8 @@ public:
 private:
   void encodeArray(const std::vector<RespValue>& array, Buffer::Instance& out);
   void encodeBulkString(const std::string& string, Buffer::Instance& out);
+  void encodeBulkStringBuffer(const std::shared_ptr<Buffer::Instance>& buffer,
+                              Buffer::Instance& out);
   void encodeError(const std::string& string, Buffer::Instance& out);
   void encodeInteger(int64_t integer, Buffer::Instance& out);
   void encodeSimpleString(const std::string& string, Buffer::Instance& out);
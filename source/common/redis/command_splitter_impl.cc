@@ -154,7 +154,11 @@ void MGETRequest::onChildResponse(RespValuePtr&& value, uint32_t index) {
     FALLTHRU;
   }
   case RespType::BulkString: {
-    pending_response_->asArray()[index].asString().swap(value->asString());
+    if (value->type() == RespType::BulkString && value->asBuffer()) {
+      pending_response_->asArray()[index].asBuffer().swap(value->asBuffer());
+    } else {
+      pending_response_->asArray()[index].asString().swap(value->asString());
+    }
     break;
   }
   case RespType::Null:
@@ -198,7 +202,13 @@ SplitRequestPtr MSETRequest::create(ConnPool::Instance& conn_pool,
     PendingRequest& pending_request = request_ptr->pending_requests_.back();
 
     single_mset.asArray()[1].asString() = incoming_request.asArray()[i].asString();
-    single_mset.asArray()[2].asString() = incoming_request.asArray()[i + 1].asString();
+    // A buffered value is shared with the fragment rather than copied.
+    single_mset.asArray()[2].type(RespType::BulkString);
+    if (incoming_request.asArray()[i + 1].asBuffer()) {
+      single_mset.asArray()[2].asBuffer() = incoming_request.asArray()[i + 1].asBuffer();
+    } else {
+      single_mset.asArray()[2].asString() = incoming_request.asArray()[i + 1].asString();
+    }
 
     ENVOY_LOG(debug, "redis: parallel set: '{}'", single_mset.toString());
     pending_request.handle_ = conn_pool.makeRequest(incoming_request.asArray()[i].asString(),
@@ -1,19 +1,108 @@
 #include "common/redis/conn_pool_impl.h"
 
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "common/common/assert.h"
+#include "common/redis/supported_commands.h"
 
 namespace Envoy {
 namespace Redis {
 namespace ConnPool {
 
+static const std::string RuntimeMaxBufferSizeBeforeFlush = "redis.max_buffer_size_before_flush";
+static const std::string RuntimeClusterSlotsRefreshInterval =
+    "redis.cluster_slots_refresh_interval_ms";
+
+namespace {
+
+// Marks the hash slots that no known shard serves.
+const uint32_t NoShard = std::numeric_limits<uint32_t>::max();
+
+void makeCommand(const std::vector<std::string>& arguments, RespValue& command) {
+  std::vector<RespValue> values(arguments.size());
+  for (size_t i = 0; i < arguments.size(); i++) {
+    values[i].type(RespType::BulkString);
+    values[i].asString() = arguments[i];
+  }
+  command.type(RespType::Array);
+  command.asArray().swap(values);
+}
+
+// A node in a CLUSTER SLOTS reply is an array that starts with the node's IP and port.
+bool validClusterNode(const RespValue& node) {
+  return node.type() == RespType::Array && node.asArray().size() >= 2 &&
+         node.asArray()[0].type() == RespType::BulkString &&
+         node.asArray()[1].type() == RespType::Integer;
+}
+
+// A slot range in a CLUSTER SLOTS reply is an array of the first and last slot, the master and
+// then the replicas.
+bool validClusterSlotRange(const RespValue& slot_range) {
+  if (slot_range.type() != RespType::Array || slot_range.asArray().size() < 3) {
+    return false;
+  }
+  const std::vector<RespValue>& fields = slot_range.asArray();
+  if (fields[0].type() != RespType::Integer || fields[1].type() != RespType::Integer ||
+      fields[0].asInteger() < 0 || fields[0].asInteger() > fields[1].asInteger() ||
+      fields[1].asInteger() >= ClusterSlotUtility::SlotCount) {
+    return false;
+  }
+  for (size_t i = 2; i < fields.size(); i++) {
+    if (!validClusterNode(fields[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The node's address in the format of Network::Address::Instance::asString().
+std::string clusterNodeAddress(const RespValue& node) {
+  const std::string& ip = node.asArray()[0].asString();
+  const int64_t port = node.asArray()[1].asInteger();
+  return ip.find(':') == std::string::npos ? fmt::format("{}:{}", ip, port)
+                                           : fmt::format("[{}]:{}", ip, port);
+}
+
+} // namespace
+
+const uint32_t ClusterSlotUtility::SlotCount;
+
+uint32_t ClusterSlotUtility::hashSlot(const std::string& key) {
+  size_t start = 0;
+  size_t length = key.size();
+  const size_t tag_start = key.find('{');
+  if (tag_start != std::string::npos) {
+    const size_t tag_end = key.find('}', tag_start + 1);
+    if (tag_end != std::string::npos && tag_end != tag_start + 1) {
+      start = tag_start + 1;
+      length = tag_end - start;
+    }
+  }
+
+  // CRC16-CCITT (XMODEM), as specified by Redis Cluster.
+  uint16_t crc = 0;
+  for (size_t i = start; i < start + length; i++) {
+    crc ^= static_cast<uint16_t>(static_cast<uint8_t>(key[i])) << 8;
+    for (uint32_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc % SlotCount;
+}
+
 ConfigImpl::ConfigImpl(
-    const envoy::config::filter::network::redis_proxy::v2::RedisProxy::ConnPoolSettings& config)
-    : op_timeout_(PROTOBUF_GET_MS_REQUIRED(config, op_timeout)) {}
+    const envoy::config::filter::network::redis_proxy::v2::RedisProxy::ConnPoolSettings& config,
+    Runtime::Loader& runtime)
+    : op_timeout_(PROTOBUF_GET_MS_REQUIRED(config, op_timeout)), runtime_(runtime) {}
+
+uint32_t ConfigImpl::maxBufferSizeBeforeFlush() const {
+  return runtime_.snapshot().getInteger(RuntimeMaxBufferSizeBeforeFlush, 0);
+}
 
 ClientPtr ClientImpl::create(Upstream::HostConstSharedPtr host, Event::Dispatcher& dispatcher,
                              EncoderPtr&& encoder, DecoderFactory& decoder_factory,
@@ -31,8 +120,10 @@ ClientPtr ClientImpl::create(Upstream::HostConstSharedPtr host, Event::Dispatche
 
 ClientImpl::ClientImpl(Upstream::HostConstSharedPtr host, Event::Dispatcher& dispatcher,
                        EncoderPtr&& encoder, DecoderFactory& decoder_factory, const Config& config)
-    : host_(host), encoder_(std::move(encoder)), decoder_(decoder_factory.create(*this)),
-      config_(config),
+    : host_(host), dispatcher_(dispatcher), encoder_(std::move(encoder)),
+      decoder_(decoder_factory.create(*this)), config_(config),
+      stats_{ALL_REDIS_CLIENT_STATS(POOL_COUNTER_PREFIX(host->cluster().statsScope(), "redis."),
+                                    POOL_HISTOGRAM_PREFIX(host->cluster().statsScope(), "redis."))},
       connect_or_op_timer_(dispatcher.createTimer([this]() -> void { onConnectOrOpTimeout(); })) {
   host->cluster().stats().upstream_cx_total_.inc();
   host->stats().cx_total_.inc();
@@ -55,7 +146,27 @@ PoolRequest* ClientImpl::makeRequest(const RespValue& request, PoolCallbacks& ca
 
   pending_requests_.emplace_back(*this, callbacks);
   encoder_->encode(request, encoder_buffer_);
-  connection_->write(encoder_buffer_, false);
+
+  const uint32_t max_buffer_size = config_.maxBufferSizeBeforeFlush();
+  if (max_buffer_size == 0 && buffered_requests_ == 0) {
+    connection_->write(encoder_buffer_, false);
+  } else {
+    buffered_requests_++;
+    if (encoder_buffer_.length() >= max_buffer_size) {
+      stats_.batch_flush_buffer_full_.inc();
+      flushBuffer();
+    } else if (buffered_requests_ == 1) {
+      // A zero timeout fires on the next dispatcher loop iteration, after the events that are
+      // already ready, such as downstream reads carrying more pipelined requests, are handled.
+      if (flush_timer_ == nullptr) {
+        flush_timer_ = dispatcher_.createTimer([this]() -> void {
+          stats_.batch_flush_loop_.inc();
+          flushBuffer();
+        });
+      }
+      flush_timer_->enableTimer(std::chrono::milliseconds(0));
+    }
+  }
 
   // Only boost the op timeout if:
   // - We are not already connected. Otherwise, we are governed by the connect timeout and the timer
@@ -70,6 +181,15 @@ PoolRequest* ClientImpl::makeRequest(const RespValue& request, PoolCallbacks& ca
   return &pending_requests_.back();
 }
 
+void ClientImpl::flushBuffer() {
+  if (flush_timer_ != nullptr) {
+    flush_timer_->disableTimer();
+  }
+  stats_.batch_requests_.recordValue(buffered_requests_);
+  buffered_requests_ = 0;
+  connection_->write(encoder_buffer_, false);
+}
+
 void ClientImpl::onConnectOrOpTimeout() {
   putOutlierEvent(Upstream::Outlier::Result::TIMEOUT);
   if (connected_) {
@@ -125,6 +245,11 @@ void ClientImpl::onEvent(Network::ConnectionEvent event) {
     }
 
     connect_or_op_timer_->disableTimer();
+    if (flush_timer_ != nullptr) {
+      flush_timer_->disableTimer();
+    }
+    encoder_buffer_.drain(encoder_buffer_.length());
+    buffered_requests_ = 0;
   } else if (event == Network::ConnectionEvent::Connected) {
     connected_ = true;
     ASSERT(!pending_requests_.empty());
@@ -189,8 +314,16 @@ ClientPtr ClientFactoryImpl::create(Upstream::HostConstSharedPtr host,
 InstanceImpl::InstanceImpl(
     const std::string& cluster_name, Upstream::ClusterManager& cm, ClientFactory& client_factory,
     ThreadLocal::SlotAllocator& tls,
-    const envoy::config::filter::network::redis_proxy::v2::RedisProxy::ConnPoolSettings& config)
-    : cm_(cm), client_factory_(client_factory), tls_(tls.allocateSlot()), config_(config) {
+    const envoy::config::filter::network::redis_proxy::v2::RedisProxy::ConnPoolSettings& config,
+    Runtime::Loader& runtime)
+    : cm_(cm), client_factory_(client_factory), tls_(tls.allocateSlot()), config_(config, runtime),
+      runtime_(runtime) {
+  for (const std::string& command : SupportedCommands::readOnlyCommands()) {
+    read_only_commands_.insert(command);
+  }
+  makeCommand({"CLUSTER", "SLOTS"}, cluster_slots_command_);
+  makeCommand({"READONLY"}, read_only_command_);
+
   tls_->set([this, cluster_name](
                 Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     return std::make_shared<ThreadLocalPool>(*this, dispatcher, cluster_name);
@@ -202,6 +335,14 @@ PoolRequest* InstanceImpl::makeRequest(const std::string& hash_key, const RespVa
   return tls_->getTyped<ThreadLocalPool>().makeRequest(hash_key, value, callbacks);
 }
 
+bool InstanceImpl::isReadOnlyRequest(const RespValue& request) const {
+  if (request.type() != RespType::Array || request.asArray().empty() ||
+      request.asArray()[0].type() != RespType::BulkString) {
+    return false;
+  }
+  return read_only_commands_.count(request.asArray()[0].asString()) > 0;
+}
+
 InstanceImpl::ThreadLocalPool::ThreadLocalPool(InstanceImpl& parent, Event::Dispatcher& dispatcher,
                                                const std::string& cluster_name)
     : parent_(parent), dispatcher_(dispatcher), cluster_(parent_.cm_.get(cluster_name)) {
@@ -219,6 +360,9 @@ InstanceImpl::ThreadLocalPool::ThreadLocalPool(InstanceImpl& parent, Event::Disp
 
 InstanceImpl::ThreadLocalPool::~ThreadLocalPool() {
   local_host_set_member_update_cb_handle_->remove();
+  if (cluster_slots_request_ != nullptr) {
+    cluster_slots_request_->cancel();
+  }
   while (!client_map_.empty()) {
     client_map_.begin()->second->redis_client_->close();
   }
@@ -226,6 +370,15 @@ InstanceImpl::ThreadLocalPool::~ThreadLocalPool() {
 
 void InstanceImpl::ThreadLocalPool::onHostsRemoved(
     const std::vector<Upstream::HostSharedPtr>& hosts_removed) {
+  if (!hosts_removed.empty() && !slot_shards_.empty()) {
+    // The slot table may refer to removed hosts. Load balance until it is refreshed.
+    cluster_shards_.clear();
+    slot_shards_.clear();
+    if (cluster_slots_request_ == nullptr) {
+      cluster_slots_timer_->enableTimer(std::chrono::milliseconds(0));
+    }
+  }
+
   for (const auto& host : hosts_removed) {
     auto it = client_map_.find(host);
     if (it != client_map_.end()) {
@@ -239,12 +392,35 @@ void InstanceImpl::ThreadLocalPool::onHostsRemoved(
 PoolRequest* InstanceImpl::ThreadLocalPool::makeRequest(const std::string& hash_key,
                                                         const RespValue& request,
                                                         PoolCallbacks& callbacks) {
-  LbContextImpl lb_context(hash_key);
-  Upstream::HostConstSharedPtr host = cluster_->loadBalancer().chooseHost(&lb_context);
+  if (!cluster_slots_started_) {
+    startClusterSlots();
+  }
+
+  bool replica = false;
+  Upstream::HostConstSharedPtr host;
+  if (!slot_shards_.empty()) {
+    host = chooseClusterHost(hash_key, request, replica);
+  }
   if (!host) {
-    return nullptr;
+    LbContextImpl lb_context(hash_key);
+    host = cluster_->loadBalancer().chooseHost(&lb_context);
+    if (!host) {
+      return nullptr;
+    }
+  }
+
+  ThreadLocalActiveClient& client = getOrCreateClient(host);
+  if (replica && !client.read_only_) {
+    // Requests are pipelined in order, so READONLY takes effect before the request.
+    client.redis_client_->makeRequest(parent_.read_only_command_, read_only_callbacks_);
+    client.read_only_ = true;
   }
 
+  return client.redis_client_->makeRequest(request, callbacks);
+}
+
+InstanceImpl::ThreadLocalActiveClient&
+InstanceImpl::ThreadLocalPool::getOrCreateClient(const Upstream::HostConstSharedPtr& host) {
   ThreadLocalActiveClientPtr& client = client_map_[host];
   if (!client) {
     client.reset(new ThreadLocalActiveClient(*this));
@@ -253,7 +429,123 @@ PoolRequest* InstanceImpl::ThreadLocalPool::makeRequest(const std::string& hash_
     client->redis_client_->addConnectionCallbacks(*client);
   }
 
-  return client->redis_client_->makeRequest(request, callbacks);
+  return *client;
+}
+
+Upstream::HostConstSharedPtr
+InstanceImpl::ThreadLocalPool::chooseClusterHost(const std::string& hash_key,
+                                                 const RespValue& request, bool& replica) {
+  const uint32_t shard_index = slot_shards_[ClusterSlotUtility::hashSlot(hash_key)];
+  if (shard_index == NoShard) {
+    return nullptr;
+  }
+
+  const ClusterShard& shard = cluster_shards_[shard_index];
+  if (shard.replicas_.empty() || !parent_.isReadOnlyRequest(request)) {
+    return shard.master_;
+  }
+
+  const Upstream::HostConstSharedPtr* least_active = nullptr;
+  for (const auto& host : shard.replicas_) {
+    if (host->healthy() &&
+        (least_active == nullptr ||
+         host->stats().rq_active_.value() < (*least_active)->stats().rq_active_.value())) {
+      least_active = &host;
+    }
+  }
+  if (least_active == nullptr) {
+    return shard.master_;
+  }
+
+  replica = true;
+  return *least_active;
+}
+
+void InstanceImpl::ThreadLocalPool::startClusterSlots() {
+  // Discovery is only enabled if the refresh interval is set when the pool serves its first
+  // request. Changing it later only changes or stops the refresh. MOVED and ASK replies are not
+  // handled either, and go back to the client as is until the next refresh.
+  cluster_slots_started_ = true;
+  if (parent_.runtime_.snapshot().getInteger(RuntimeClusterSlotsRefreshInterval, 0) > 0) {
+    cluster_slots_timer_ = dispatcher_.createTimer([this]() -> void { refreshClusterSlots(); });
+    cluster_slots_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+}
+
+void InstanceImpl::ThreadLocalPool::refreshClusterSlots() {
+  Upstream::HostConstSharedPtr host = cluster_->loadBalancer().chooseHost(nullptr);
+  if (host) {
+    cluster_slots_request_ = getOrCreateClient(host).redis_client_->makeRequest(
+        parent_.cluster_slots_command_, cluster_slots_callbacks_);
+  }
+  if (cluster_slots_request_ == nullptr) {
+    scheduleClusterSlotsRefresh();
+  }
+}
+
+void InstanceImpl::ThreadLocalPool::onClusterSlots(RespValuePtr&& value) {
+  cluster_slots_request_ = nullptr;
+  scheduleClusterSlotsRefresh();
+
+  if (value->type() != RespType::Array) {
+    ENVOY_LOG(debug, "redis: unexpected CLUSTER SLOTS reply '{}'", value->toString());
+    return;
+  }
+
+  std::unordered_map<std::string, Upstream::HostConstSharedPtr> hosts;
+  for (const auto& host_set : cluster_->prioritySet().hostSetsPerPriority()) {
+    for (const auto& host : host_set->hosts()) {
+      hosts.emplace(host->address()->asString(), host);
+    }
+  }
+
+  std::vector<ClusterShard> cluster_shards;
+  std::vector<uint32_t> slot_shards(ClusterSlotUtility::SlotCount, NoShard);
+  for (const RespValue& slot_range : value->asArray()) {
+    if (!validClusterSlotRange(slot_range)) {
+      ENVOY_LOG(debug, "redis: invalid CLUSTER SLOTS slot range '{}'", slot_range.toString());
+      return;
+    }
+
+    // Slots of masters that are not in the upstream cluster are load balanced.
+    const std::vector<RespValue>& fields = slot_range.asArray();
+    auto master = hosts.find(clusterNodeAddress(fields[2]));
+    if (master == hosts.end()) {
+      continue;
+    }
+
+    ClusterShard shard{master->second, {}};
+    for (size_t i = 3; i < fields.size(); i++) {
+      auto replica = hosts.find(clusterNodeAddress(fields[i]));
+      if (replica != hosts.end()) {
+        shard.replicas_.push_back(replica->second);
+      }
+    }
+    for (int64_t slot = fields[0].asInteger(); slot <= fields[1].asInteger(); slot++) {
+      slot_shards[slot] = cluster_shards.size();
+    }
+    cluster_shards.push_back(std::move(shard));
+  }
+
+  cluster_shards_.swap(cluster_shards);
+  slot_shards_.swap(slot_shards);
+}
+
+void InstanceImpl::ThreadLocalPool::onClusterSlotsFailure() {
+  cluster_slots_request_ = nullptr;
+  scheduleClusterSlotsRefresh();
+}
+
+void InstanceImpl::ThreadLocalPool::scheduleClusterSlotsRefresh() {
+  const uint64_t refresh_interval =
+      parent_.runtime_.snapshot().getInteger(RuntimeClusterSlotsRefreshInterval, 0);
+  if (refresh_interval == 0) {
+    // Discovery has been disabled, so stop using the slot table.
+    cluster_shards_.clear();
+    slot_shards_.clear();
+    return;
+  }
+  cluster_slots_timer_->enableTimer(std::chrono::milliseconds(refresh_interval));
 }
 
 void InstanceImpl::ThreadLocalActiveClient::onEvent(Network::ConnectionEvent event) {
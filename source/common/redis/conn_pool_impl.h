@@ -10,10 +10,14 @@
 
 #include "envoy/config/filter/network/redis_proxy/v2/redis_proxy.pb.h"
 #include "envoy/redis/conn_pool.h"
+#include "envoy/runtime/runtime.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/thread_local/thread_local.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+#include "common/common/utility.h"
 #include "common/network/filter_impl.h"
 #include "common/protobuf/utility.h"
 #include "common/redis/codec_impl.h"
@@ -25,16 +29,53 @@ namespace ConnPool {
 // TODO(mattklein123): Circuit breaking
 // TODO(rshriram): Fault injection
 
+/**
+ * All redis upstream client stats, which are kept in the upstream cluster's scope. @see
+ * stats_macros.h
+ */
+// clang-format off
+#define ALL_REDIS_CLIENT_STATS(COUNTER, HISTOGRAM)                                                 \
+  COUNTER(batch_flush_buffer_full)                                                                 \
+  COUNTER(batch_flush_loop)                                                                        \
+  HISTOGRAM(batch_requests)
+// clang-format on
+
+/**
+ * Struct definition for all redis upstream client stats. @see stats_macros.h
+ */
+struct RedisClientStats {
+  ALL_REDIS_CLIENT_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * Redis Cluster (https://redis.io/topics/cluster-spec) key hash slots.
+ */
+class ClusterSlotUtility {
+public:
+  static const uint32_t SlotCount = 16384;
+
+  /**
+   * @param key supplies the key.
+   * @return uint32_t the hash slot of the key, which is the CRC16 of the key modulo SlotCount. If
+   *         the key has a non-empty hash tag, the part between its first '{' and the next '}', only
+   *         the tag is hashed.
+   */
+  static uint32_t hashSlot(const std::string& key);
+};
+
 class ConfigImpl : public Config {
 public:
   ConfigImpl(
-      const envoy::config::filter::network::redis_proxy::v2::RedisProxy::ConnPoolSettings& config);
+      const envoy::config::filter::network::redis_proxy::v2::RedisProxy::ConnPoolSettings& config,
+      Runtime::Loader& runtime);
 
   bool disableOutlierEvents() const override { return false; }
   std::chrono::milliseconds opTimeout() const override { return op_timeout_; }
+  uint32_t maxBufferSizeBeforeFlush() const override;
 
 private:
   const std::chrono::milliseconds op_timeout_;
+  Runtime::Loader& runtime_;
 };
 
 class ClientImpl : public Client, public DecoderCallbacks, public Network::ConnectionCallbacks {
@@ -79,6 +120,7 @@ private:
 
   ClientImpl(Upstream::HostConstSharedPtr host, Event::Dispatcher& dispatcher, EncoderPtr&& encoder,
              DecoderFactory& decoder_factory, const Config& config);
+  void flushBuffer();
   void onConnectOrOpTimeout();
   void onData(Buffer::Instance& data);
   void putOutlierEvent(Upstream::Outlier::Result result);
@@ -92,13 +134,19 @@ private:
   void onBelowWriteBufferLowWatermark() override {}
 
   Upstream::HostConstSharedPtr host_;
+  Event::Dispatcher& dispatcher_;
   Network::ClientConnectionPtr connection_;
   EncoderPtr encoder_;
   Buffer::OwnedImpl encoder_buffer_;
   DecoderPtr decoder_;
   const Config& config_;
+  RedisClientStats stats_;
   std::list<PendingRequest> pending_requests_;
   Event::TimerPtr connect_or_op_timer_;
+  // Created on the first buffered request, and enabled while encoder_buffer_ holds requests.
+  Event::TimerPtr flush_timer_;
+  // Number of requests in encoder_buffer_.
+  uint64_t buffered_requests_{};
   bool connected_{};
 };
 
@@ -119,7 +167,8 @@ public:
   InstanceImpl(
       const std::string& cluster_name, Upstream::ClusterManager& cm, ClientFactory& client_factory,
       ThreadLocal::SlotAllocator& tls,
-      const envoy::config::filter::network::redis_proxy::v2::RedisProxy::ConnPoolSettings& config);
+      const envoy::config::filter::network::redis_proxy::v2::RedisProxy::ConnPoolSettings& config,
+      Runtime::Loader& runtime);
 
   // Redis::ConnPool::Instance
   PoolRequest* makeRequest(const std::string& hash_key, const RespValue& request,
@@ -139,23 +188,81 @@ private:
     ThreadLocalPool& parent_;
     Upstream::HostConstSharedPtr host_;
     ClientPtr redis_client_;
+    // Whether READONLY has been sent, which a Redis Cluster replica needs before it serves reads.
+    bool read_only_{};
   };
 
   typedef std::unique_ptr<ThreadLocalActiveClient> ThreadLocalActiveClientPtr;
 
-  struct ThreadLocalPool : public ThreadLocal::ThreadLocalObject {
+  /**
+   * The hosts serving a range of Redis Cluster hash slots.
+   */
+  struct ClusterShard {
+    Upstream::HostConstSharedPtr master_;
+    std::vector<Upstream::HostConstSharedPtr> replicas_;
+  };
+
+  struct ClusterSlotsCallbacks : public PoolCallbacks {
+    ClusterSlotsCallbacks(ThreadLocalPool& parent) : parent_(parent) {}
+
+    // Redis::ConnPool::PoolCallbacks
+    void onResponse(RespValuePtr&& value) override { parent_.onClusterSlots(std::move(value)); }
+    void onFailure() override { parent_.onClusterSlotsFailure(); }
+
+    ThreadLocalPool& parent_;
+  };
+
+  // The reply to READONLY is not needed, and a failure fails the requests behind it as well.
+  struct ReadOnlyCallbacks : public PoolCallbacks {
+    // Redis::ConnPool::PoolCallbacks
+    void onResponse(RespValuePtr&&) override {}
+    void onFailure() override {}
+  };
+
+  struct ThreadLocalPool : public ThreadLocal::ThreadLocalObject,
+                           Logger::Loggable<Logger::Id::redis> {
     ThreadLocalPool(InstanceImpl& parent, Event::Dispatcher& dispatcher,
                     const std::string& cluster_name);
     ~ThreadLocalPool();
     PoolRequest* makeRequest(const std::string& hash_key, const RespValue& request,
                              PoolCallbacks& callbacks);
     void onHostsRemoved(const std::vector<Upstream::HostSharedPtr>& hosts_removed);
+    ThreadLocalActiveClient& getOrCreateClient(const Upstream::HostConstSharedPtr& host);
+
+    /**
+     * Choose a host from the Redis Cluster slot table. Read only requests go to the healthy replica
+     * of the key's shard with the fewest active requests, and other requests, or read only requests
+     * when no replica is healthy, to the shard's master.
+     * @param replica is set to whether the chosen host is a replica.
+     * @return Upstream::HostConstSharedPtr the host, or nullptr if the slot is not in the table.
+     */
+    Upstream::HostConstSharedPtr chooseClusterHost(const std::string& hash_key,
+                                                   const RespValue& request, bool& replica);
+    /**
+     * Start CLUSTER SLOTS discovery if it is enabled. This waits for the first request, so that
+     * pools that never serve requests, such as the main thread's, do not query the cluster.
+     */
+    void startClusterSlots();
+    void refreshClusterSlots();
+    void onClusterSlots(RespValuePtr&& value);
+    void onClusterSlotsFailure();
+    void scheduleClusterSlotsRefresh();
 
     InstanceImpl& parent_;
     Event::Dispatcher& dispatcher_;
     Upstream::ThreadLocalCluster* cluster_;
     std::unordered_map<Upstream::HostConstSharedPtr, ThreadLocalActiveClientPtr> client_map_;
     Common::CallbackHandle* local_host_set_member_update_cb_handle_;
+    ClusterSlotsCallbacks cluster_slots_callbacks_{*this};
+    ReadOnlyCallbacks read_only_callbacks_;
+    bool cluster_slots_started_{};
+    // Only created when CLUSTER SLOTS discovery is enabled.
+    Event::TimerPtr cluster_slots_timer_;
+    PoolRequest* cluster_slots_request_{};
+    std::vector<ClusterShard> cluster_shards_;
+    // The index in cluster_shards_ of the shard of each hash slot. Empty until a CLUSTER SLOTS
+    // reply has been received, in which case all requests are load balanced.
+    std::vector<uint32_t> slot_shards_;
   };
 
   struct LbContextImpl : public Upstream::LoadBalancerContext {
@@ -169,10 +276,17 @@ private:
     const Optional<uint64_t> hash_key_;
   };
 
+  bool isReadOnlyRequest(const RespValue& request) const;
+
   Upstream::ClusterManager& cm_;
   ClientFactory& client_factory_;
   ThreadLocal::SlotPtr tls_;
   ConfigImpl config_;
+  Runtime::Loader& runtime_;
+  // Redis commands are case insensitive, so the set is looked up without lowercasing the command.
+  StringUtil::CaseUnorderedSet read_only_commands_;
+  RespValue cluster_slots_command_;
+  RespValue read_only_command_;
 };
 
 } // namespace ConnPool
@@ -52,6 +52,20 @@ struct SupportedCommands {
    * @return mset command
    */
   static const std::string& mset() { CONSTRUCT_ON_FIRST_USE(std::string, "mset"); }
+
+  /**
+   * @return commands which only read data, and which a replica can serve
+   */
+  static const std::vector<std::string>& readOnlyCommands() {
+    CONSTRUCT_ON_FIRST_USE(
+        std::vector<std::string>, "bitcount", "bitpos", "dump", "exists", "geodist", "geohash",
+        "geopos", "georadius_ro", "georadiusbymember_ro", "get", "getbit", "getrange", "hexists",
+        "hget", "hgetall", "hkeys", "hlen", "hmget", "hscan", "hstrlen", "hvals", "lindex", "llen",
+        "lrange", "mget", "pttl", "scard", "sismember", "smembers", "srandmember", "sscan",
+        "strlen", "ttl", "type", "zcard", "zcount", "zlexcount", "zrange", "zrangebylex",
+        "zrangebyscore", "zrank", "zrevrange", "zrevrangebylex", "zrevrangebyscore", "zrevrank",
+        "zscan", "zscore");
+  }
 };
 
 } // namespace Redis
@@ -5,7 +5,6 @@
 #include <cstdint>
 #include <map>
 #include <memory>
-#include <regex>
 #include <string>
 #include <vector>
 
@@ -233,7 +232,8 @@ RouteEntryImplBase::RouteEntryImplBase(const VirtualHostImpl& vhost,
       https_redirect_(route.redirect().https_redirect()),
       prefix_rewrite_redirect_(route.redirect().prefix_rewrite()),
       strip_query_(route.redirect().strip_query()), retry_policy_(route.route()),
-      rate_limit_policy_(route.route().rate_limits()), shadow_policy_(route.route()),
+      rate_limit_policy_(route.route().rate_limits(), vhost.globalRouteConfig().regexEngine()),
+      shadow_policy_(route.route()),
       priority_(ConfigUtility::parsePriority(route.route().priority())),
       total_cluster_weight_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(route.route().weighted_clusters(), total_weight, 100UL)),
@@ -298,12 +298,13 @@ RouteEntryImplBase::RouteEntryImplBase(const VirtualHostImpl& vhost,
     }
   }
 
+  const Regex::Engine regex_engine = vhost.globalRouteConfig().regexEngine();
   for (const auto& header_map : route.match().headers()) {
-    config_headers_.push_back(header_map);
+    config_headers_.emplace_back(header_map, regex_engine);
   }
 
   for (const auto& query_parameter : route.match().query_parameters()) {
-    config_query_parameters_.push_back(query_parameter);
+    config_query_parameters_.emplace_back(query_parameter, regex_engine);
   }
 
   if (!route.route().hash_policy().empty()) {
@@ -609,13 +610,14 @@ RegexRouteEntryImpl::RegexRouteEntryImpl(const VirtualHostImpl& vhost,
                                          const envoy::api::v2::route::Route& route,
                                          Runtime::Loader& loader)
     : RouteEntryImplBase(vhost, route, loader),
-      regex_(RegexUtil::parseRegex(route.match().regex().c_str())),
+      regex_(Regex::Utility::parseRegex(route.match().regex(),
+                                        vhost.globalRouteConfig().regexEngine())),
       regex_str_(route.match().regex()) {}
 
 void RegexRouteEntryImpl::rewritePathHeader(Http::HeaderMap& headers) const {
   const Http::HeaderString& path = headers.Path()->value();
   const char* query_string_start = Http::Utility::findQueryStringStart(path);
-  ASSERT(std::regex_match(path.c_str(), query_string_start, regex_));
+  ASSERT(regex_->match(absl::string_view(path.c_str(), query_string_start - path.c_str())));
   std::string matched_path(path.c_str(), query_string_start);
 
   finalizePathHeader(headers, matched_path);
@@ -632,7 +634,7 @@ RouteConstSharedPtr RegexRouteEntryImpl::matches(const Http::HeaderMap& headers,
   if (RouteEntryImplBase::matchRoute(headers, random_value)) {
     const Http::HeaderString& path = headers.Path()->value();
     const char* query_string_start = Http::Utility::findQueryStringStart(path);
-    if (std::regex_match(path.c_str(), query_string_start, regex_)) {
+    if (regex_->match(absl::string_view(path.c_str(), query_string_start - path.c_str()))) {
       return clusterEntry(headers, random_value);
     }
   }
@@ -642,7 +644,8 @@ RouteConstSharedPtr RegexRouteEntryImpl::matches(const Http::HeaderMap& headers,
 VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtual_host,
                                  const ConfigImpl& global_route_config, Runtime::Loader& runtime,
                                  Upstream::ClusterManager& cm, bool validate_clusters)
-    : name_(virtual_host.name()), rate_limit_policy_(virtual_host.rate_limits()),
+    : name_(virtual_host.name()),
+      rate_limit_policy_(virtual_host.rate_limits(), global_route_config.regexEngine()),
       global_route_config_(global_route_config),
       request_headers_parser_(HeaderParser::configure(virtual_host.request_headers_to_add())),
       response_headers_parser_(HeaderParser::configure(virtual_host.response_headers_to_add(),
@@ -668,14 +671,20 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
         route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kPath;
     const bool has_regex =
         route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kRegex;
+    const bool case_sensitive =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(route.match(), case_sensitive, true);
+    const uint32_t route_index = routes_.size();
     if (has_prefix) {
       routes_.emplace_back(new PrefixRouteEntryImpl(*this, route, runtime));
+      path_match_index_.addPrefix(route_index, route.match().prefix(), case_sensitive);
     } else if (has_path) {
       routes_.emplace_back(new PathRouteEntryImpl(*this, route, runtime));
+      path_match_index_.addPath(route_index, route.match().path(), case_sensitive);
     } else {
       ASSERT(has_regex);
       UNREFERENCED_PARAMETER(has_regex);
       routes_.emplace_back(new RegexRouteEntryImpl(*this, route, runtime));
+      path_match_index_.addUnindexed(route_index);
     }
 
     if (validate_clusters) {
@@ -690,7 +699,8 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
   }
 
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
-    virtual_clusters_.push_back(VirtualClusterEntry(virtual_cluster));
+    virtual_clusters_.push_back(
+        VirtualClusterEntry(virtual_cluster, global_route_config.regexEngine()));
   }
 
   if (virtual_host.has_cors()) {
@@ -699,14 +709,12 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
 }
 
 VirtualHostImpl::VirtualClusterEntry::VirtualClusterEntry(
-    const envoy::api::v2::route::VirtualCluster& virtual_cluster) {
+    const envoy::api::v2::route::VirtualCluster& virtual_cluster, Regex::Engine regex_engine)
+    : pattern_(Regex::Utility::parseRegex(virtual_cluster.pattern(), regex_engine)),
+      name_(virtual_cluster.name()) {
   if (virtual_cluster.method() != envoy::api::v2::core::RequestMethod::METHOD_UNSPECIFIED) {
     method_ = envoy::api::v2::core::RequestMethod_Name(virtual_cluster.method());
   }
-
-  const std::string pattern = virtual_cluster.pattern();
-  pattern_ = RegexUtil::parseRegex(pattern);
-  name_ = virtual_cluster.name();
 }
 
 const Config& VirtualHostImpl::routeConfig() const { return global_route_config_; }
@@ -768,9 +776,28 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const Http::HeaderMap&
     return SSL_REDIRECT_ROUTE;
   }
 
-  // Check for a route that matches the request.
-  for (const RouteEntryImplBaseConstSharedPtr& route : routes_) {
-    RouteConstSharedPtr route_entry = route->matches(headers, random_value);
+  if (!headers.Path()) {
+    // Without a path only non-path criteria can reject a route, so fall back to evaluating every
+    // route in order.
+    for (const RouteEntryImplBaseConstSharedPtr& route : routes_) {
+      RouteConstSharedPtr route_entry = route->matches(headers, random_value);
+      if (nullptr != route_entry) {
+        return route_entry;
+      }
+    }
+    return nullptr;
+  }
+
+  // Check for a route that matches the request. The path index narrows the route list down to the
+  // routes whose path criterion can match, which are then fully evaluated in configuration order so
+  // that the first matching route still wins.
+  const Http::HeaderString& path = headers.Path()->value();
+  const char* query_string_start = Http::Utility::findQueryStringStart(path);
+  PathMatchIndex::Candidates candidates = path_match_index_.findCandidates(
+      absl::string_view(path.c_str(), path.size()), query_string_start - path.c_str());
+  uint32_t index;
+  while (candidates.next(index)) {
+    RouteConstSharedPtr route_entry = routes_[index]->matches(headers, random_value);
     if (nullptr != route_entry) {
       return route_entry;
     }
@@ -822,7 +849,9 @@ VirtualHostImpl::virtualClusterFromEntries(const Http::HeaderMap& headers) const
     bool method_matches =
         !entry.method_.valid() || headers.Method()->value().c_str() == entry.method_.value();
 
-    if (method_matches && std::regex_match(headers.Path()->value().c_str(), entry.pattern_)) {
+    if (method_matches &&
+        entry.pattern_->match(
+            absl::string_view(headers.Path()->value().c_str(), headers.Path()->value().size()))) {
       return &entry;
     }
   }
@@ -834,9 +863,15 @@ VirtualHostImpl::virtualClusterFromEntries(const Http::HeaderMap& headers) const
   return nullptr;
 }
 
+Regex::Engine ConfigImpl::runtimeRegexEngine(Runtime::Loader& runtime) {
+  return runtime.snapshot().getInteger("router.use_re2", 0) != 0 ? Regex::Engine::Re2
+                                                                  : Regex::Engine::StdRegex;
+}
+
 ConfigImpl::ConfigImpl(const envoy::api::v2::RouteConfiguration& config, Runtime::Loader& runtime,
                        Upstream::ClusterManager& cm, bool validate_clusters_default)
-    : name_(config.name()) {
+    : name_(config.name()),
+      regex_engine_(runtimeRegexEngine(runtime)) {
   route_matcher_.reset(new RouteMatcher(
       config, *this, runtime, cm,
       PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default)));
@@ -5,7 +5,6 @@
 #include <list>
 #include <map>
 #include <memory>
-#include <regex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -13,6 +12,7 @@
 #include "envoy/api/v2/rds.pb.h"
 #include "envoy/api/v2/route/route.pb.h"
 #include "envoy/common/optional.h"
+#include "envoy/common/regex.h"
 #include "envoy/router/router.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/upstream/cluster_manager.h"
@@ -20,6 +20,7 @@
 #include "common/router/config_utility.h"
 #include "common/router/header_formatter.h"
 #include "common/router/header_parser.h"
+#include "common/router/path_match_index.h"
 #include "common/router/router_ratelimit.h"
 
 namespace Envoy {
@@ -123,12 +124,13 @@ private:
   enum class SslRequirements { NONE, EXTERNAL_ONLY, ALL };
 
   struct VirtualClusterEntry : public VirtualCluster {
-    VirtualClusterEntry(const envoy::api::v2::route::VirtualCluster& virtual_cluster);
+    VirtualClusterEntry(const envoy::api::v2::route::VirtualCluster& virtual_cluster,
+                        Regex::Engine regex_engine);
 
     // Router::VirtualCluster
     const std::string& name() const override { return name_; }
 
-    std::regex pattern_;
+    Regex::CompiledMatcherPtr pattern_;
     Optional<std::string> method_;
     std::string name_;
   };
@@ -145,6 +147,7 @@ private:
 
   const std::string name_;
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  PathMatchIndex path_match_index_;
   std::vector<VirtualClusterEntry> virtual_clusters_;
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
@@ -592,7 +595,7 @@ public:
   void rewritePathHeader(Http::HeaderMap& headers) const override;
 
 private:
-  const std::regex regex_;
+  const Regex::CompiledMatcherPtr regex_;
   const std::string regex_str_;
 };
 
@@ -638,6 +641,19 @@ public:
   const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; };
   const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; };
 
+  /**
+   * @return the engine used to compile route, virtual cluster, header and query parameter regexes.
+   *         RE2 is selected by setting the runtime key router.use_re2 to a non-zero value when the
+   *         route configuration is loaded.
+   */
+  Regex::Engine regexEngine() const { return regex_engine_; }
+
+  /**
+   * @return the regex engine currently selected by the router.use_re2 runtime key. Other
+   *         configuration with header matchers, such as the fault filter, uses it when loaded.
+   */
+  static Regex::Engine runtimeRegexEngine(Runtime::Loader& runtime);
+
   // Router::Config
   RouteConstSharedPtr route(const Http::HeaderMap& headers, uint64_t random_value) const override {
     return route_matcher_->route(headers, random_value);
@@ -655,6 +671,7 @@ private:
   HeaderParserPtr request_headers_parser_;
   HeaderParserPtr response_headers_parser_;
   const std::string name_;
+  const Regex::Engine regex_engine_;
 };
 
 /**
@@ -1,16 +1,17 @@
 #pragma once
 
-#include <regex>
 #include <string>
 #include <vector>
 
 #include "envoy/api/v2/route/route.pb.h"
 #include "envoy/common/optional.h"
+#include "envoy/common/regex.h"
 #include "envoy/http/codes.h"
 #include "envoy/json/json_object.h"
 #include "envoy/upstream/resource_manager.h"
 
 #include "common/common/empty_string.h"
+#include "common/common/regex.h"
 #include "common/common/utility.h"
 #include "common/config/rds_json.h"
 #include "common/http/headers.h"
@@ -29,10 +30,11 @@ public:
     // An empty header value allows for matching to be only based on header presence.
     // Regex is an opt-in. Unless explicitly mentioned, the header values will be used for
     // exact string matching.
-    HeaderData(const envoy::api::v2::route::HeaderMatcher& config)
+    HeaderData(const envoy::api::v2::route::HeaderMatcher& config,
+               Regex::Engine regex_engine = Regex::Engine::StdRegex)
         : name_(config.name()), value_(config.value()),
           is_regex_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, regex, false)),
-          regex_pattern_(is_regex_ ? RegexUtil::parseRegex(value_) : std::regex()) {}
+          regex_pattern_(is_regex_ ? Regex::Utility::parseRegex(value_, regex_engine) : nullptr) {}
     HeaderData(const Json::Object& config)
         : HeaderData([&config] {
             envoy::api::v2::route::HeaderMatcher header_matcher;
@@ -43,7 +45,7 @@ public:
     const Http::LowerCaseString name_;
     const std::string value_;
     const bool is_regex_;
-    const std::regex regex_pattern_;
+    Regex::CompiledMatcherPtr regex_pattern_;
   };
 
   // A QueryParameterMatcher specifies one "name" or "name=value" element
@@ -51,10 +53,11 @@ public:
   // equivalent of the QueryParameterMatcher proto in the RDS v2 API.
   class QueryParameterMatcher {
   public:
-    QueryParameterMatcher(const envoy::api::v2::route::QueryParameterMatcher& config)
+    QueryParameterMatcher(const envoy::api::v2::route::QueryParameterMatcher& config,
+                          Regex::Engine regex_engine = Regex::Engine::StdRegex)
         : name_(config.name()), value_(config.value()),
           is_regex_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, regex, false)),
-          regex_pattern_(is_regex_ ? RegexUtil::parseRegex(value_) : std::regex()) {}
+          regex_pattern_(is_regex_ ? Regex::Utility::parseRegex(value_, regex_engine) : nullptr) {}
 
     /**
      * Check if the query parameters for a request contain a match for this
@@ -68,7 +71,7 @@ public:
     const std::string name_;
     const std::string value_;
     const bool is_regex_;
-    const std::regex regex_pattern_;
+    Regex::CompiledMatcherPtr regex_pattern_;
   };
 
   /**
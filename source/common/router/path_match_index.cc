@@ -0,0 +1,135 @@
+#include "common/router/path_match_index.h"
+
+#include <cctype>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Router {
+
+namespace {
+
+char toLower(char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); }
+
+} // namespace
+
+bool PathMatchIndex::Candidates::next(uint32_t& index) {
+  size_t min_list = MaxLists;
+  for (size_t i = 0; i < lists_; i++) {
+    if (begins_[i] != ends_[i] && (min_list == MaxLists || *begins_[i] < *begins_[min_list])) {
+      min_list = i;
+    }
+  }
+
+  if (min_list == MaxLists) {
+    return false;
+  }
+  index = *begins_[min_list]++;
+  return true;
+}
+
+void PathMatchIndex::Candidates::add(const std::vector<uint32_t>& routes) {
+  if (routes.empty()) {
+    return;
+  }
+  ASSERT(lists_ < MaxLists);
+  begins_[lists_] = routes.data();
+  ends_[lists_] = routes.data() + routes.size();
+  lists_++;
+}
+
+PathMatchIndex::TrieNode& PathMatchIndex::insert(TrieNode& root, const std::string& key,
+                                                 bool case_sensitive,
+                                                 const TrieNode** prefix_ancestor) {
+  TrieNode* node = &root;
+  *prefix_ancestor = nullptr;
+  for (char c : key) {
+    if (!node->prefix_routes_.empty()) {
+      *prefix_ancestor = node;
+    }
+    std::unique_ptr<TrieNode>& child = node->children_[case_sensitive ? c : toLower(c)];
+    if (!child) {
+      child.reset(new TrieNode());
+    }
+    node = child.get();
+  }
+  return *node;
+}
+
+void PathMatchIndex::addToPrefixDescendants(TrieNode& node, uint32_t index) {
+  for (auto& child : node.children_) {
+    if (!child.second->prefix_routes_.empty()) {
+      child.second->prefix_routes_.push_back(index);
+    }
+    addToPrefixDescendants(*child.second, index);
+  }
+}
+
+void PathMatchIndex::addPrefix(uint32_t index, const std::string& prefix, bool case_sensitive) {
+  TrieNode& root = case_sensitive ? case_sensitive_root_ : case_insensitive_root_;
+  const TrieNode* prefix_ancestor;
+  TrieNode& node = insert(root, prefix, case_sensitive, &prefix_ancestor);
+  if (node.prefix_routes_.empty() && prefix_ancestor != nullptr) {
+    node.prefix_routes_ = prefix_ancestor->prefix_routes_;
+  }
+  // Routes are added in ascending index order, so appending keeps every list sorted.
+  ASSERT(node.prefix_routes_.empty() || node.prefix_routes_.back() < index);
+  node.prefix_routes_.push_back(index);
+  addToPrefixDescendants(node, index);
+  has_case_insensitive_ |= !case_sensitive;
+}
+
+void PathMatchIndex::addPath(uint32_t index, const std::string& path, bool case_sensitive) {
+  TrieNode& root = case_sensitive ? case_sensitive_root_ : case_insensitive_root_;
+  const TrieNode* prefix_ancestor;
+  insert(root, path, case_sensitive, &prefix_ancestor).path_routes_.push_back(index);
+  has_case_insensitive_ |= !case_sensitive;
+}
+
+void PathMatchIndex::addUnindexed(uint32_t index) { unindexed_routes_.push_back(index); }
+
+void PathMatchIndex::walk(const TrieNode& root, absl::string_view path,
+                          size_t path_without_query_size, bool case_sensitive,
+                          Candidates& candidates) {
+  // Prefix routes are compared against the full path (including the query string), while exact
+  // path routes are only compared against the part of the path before the query string. This
+  // mirrors PrefixRouteEntryImpl::matches() and PathRouteEntryImpl::matches(). The deepest prefix
+  // node on the path holds the routes of all the matching prefixes.
+  const TrieNode* node = &root;
+  const TrieNode* prefix_node = nullptr;
+  for (size_t i = 0;; i++) {
+    if (!node->prefix_routes_.empty()) {
+      prefix_node = node;
+    }
+    if (i == path_without_query_size) {
+      candidates.add(node->path_routes_);
+    }
+    if (i == path.size()) {
+      break;
+    }
+
+    const auto child = node->children_.find(case_sensitive ? path[i] : toLower(path[i]));
+    if (child == node->children_.end()) {
+      break;
+    }
+    node = child->second.get();
+  }
+
+  if (prefix_node != nullptr) {
+    candidates.add(prefix_node->prefix_routes_);
+  }
+}
+
+PathMatchIndex::Candidates PathMatchIndex::findCandidates(absl::string_view path,
+                                                          size_t path_without_query_size) const {
+  Candidates candidates;
+  candidates.add(unindexed_routes_);
+  walk(case_sensitive_root_, path, path_without_query_size, true, candidates);
+  if (has_case_insensitive_) {
+    walk(case_insensitive_root_, path, path_without_query_size, false, candidates);
+  }
+  return candidates;
+}
+
+} // namespace Router
+} // namespace Envoy
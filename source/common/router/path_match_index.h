@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Compiled index over the path match criteria of an ordered list of route entries. Prefix and
+ * exact path routes are inserted into a character trie (one for case sensitive and one for case
+ * insensitive routes) so that the set of routes whose path criterion can possibly match a request
+ * path is found in time proportional to the path length rather than the number of routes. Routes
+ * whose path criterion cannot be indexed (e.g., regex routes) are always returned as candidates.
+ *
+ * Each prefix node also holds the routes of all the prefixes that end at or above it, so a lookup
+ * ends up with at most five sorted lists of candidates, which are merged in route order without
+ * allocating or sorting.
+ *
+ * Routes must be added in ascending index order.
+ *
+ * The index only narrows down candidates by path. Callers must still fully evaluate each candidate
+ * (headers, query parameters, runtime, etc.) in the returned order to preserve first-match
+ * semantics.
+ */
+class PathMatchIndex {
+public:
+  /**
+   * Add a route that matches any path starting with prefix.
+   * @param index supplies the position of the route in the route list.
+   * @param prefix supplies the path prefix.
+   * @param case_sensitive supplies whether the prefix comparison is case sensitive.
+   */
+  void addPrefix(uint32_t index, const std::string& prefix, bool case_sensitive);
+
+  /**
+   * Add a route that matches a path (ignoring the query string) exactly.
+   * @param index supplies the position of the route in the route list.
+   * @param path supplies the exact path.
+   * @param case_sensitive supplies whether the path comparison is case sensitive.
+   */
+  void addPath(uint32_t index, const std::string& path, bool case_sensitive);
+
+  /**
+   * Add a route whose path criterion can not be indexed. It will be a candidate for every path.
+   * @param index supplies the position of the route in the route list.
+   */
+  void addUnindexed(uint32_t index);
+
+  /**
+   * The candidates of a path, iterated in ascending order, i.e. in route list order. Only valid
+   * while the index is not modified.
+   */
+  class Candidates {
+  public:
+    /**
+     * @param index supplies where to store the next candidate route index.
+     * @return false if there are no more candidates.
+     */
+    bool next(uint32_t& index);
+
+  private:
+    friend class PathMatchIndex;
+
+    void add(const std::vector<uint32_t>& routes);
+
+    // The unindexed routes, plus a prefix list and an exact path list from each trie.
+    static const size_t MaxLists = 5;
+    std::array<const uint32_t*, MaxLists> begins_;
+    std::array<const uint32_t*, MaxLists> ends_;
+    size_t lists_{};
+  };
+
+  /**
+   * Find all routes whose path criterion may match a path.
+   * @param path supplies the full request path, including any query string.
+   * @param path_without_query_size supplies the size of the path prefix before the query string.
+   * @return Candidates the candidate route indexes.
+   */
+  Candidates findCandidates(absl::string_view path, size_t path_without_query_size) const;
+
+private:
+  struct TrieNode {
+    std::map<char, std::unique_ptr<TrieNode>> children_;
+    // Routes whose prefix ends at this node or at one of its ancestors. Only set on the nodes at
+    // which a prefix ends.
+    std::vector<uint32_t> prefix_routes_;
+    // Routes whose exact path ends at this node.
+    std::vector<uint32_t> path_routes_;
+  };
+
+  static TrieNode& insert(TrieNode& root, const std::string& key, bool case_sensitive,
+                          const TrieNode** prefix_ancestor);
+  static void addToPrefixDescendants(TrieNode& node, uint32_t index);
+  static void walk(const TrieNode& root, absl::string_view path, size_t path_without_query_size,
+                   bool case_sensitive, Candidates& candidates);
+
+  TrieNode case_sensitive_root_;
+  TrieNode case_insensitive_root_;
+  std::vector<uint32_t> unindexed_routes_;
+  bool has_case_insensitive_{};
+};
+
+} // namespace Router
+} // namespace Envoy
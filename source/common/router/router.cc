@@ -309,7 +309,7 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::HeaderMap& headers, bool e
   ASSERT(headers.Path());
 
   grpc_request_ = Grpc::Common::hasGrpcContentType(headers);
-  upstream_request_.reset(new UpstreamRequest(*this, *conn_pool));
+  upstream_request_ = callbacks_->arena().make<UpstreamRequest>(*this, *conn_pool);
   upstream_request_->encodeHeaders(end_stream);
   if (end_stream) {
     onRequestComplete();
@@ -764,7 +764,7 @@ void Filter::doRetry() {
 
   ASSERT(response_timeout_ || timeout_.global_timeout_.count() == 0);
   ASSERT(!upstream_request_);
-  upstream_request_.reset(new UpstreamRequest(*this, *conn_pool));
+  upstream_request_ = callbacks_->arena().make<UpstreamRequest>(*this, *conn_pool);
   upstream_request_->encodeHeaders(!callbacks_->decodingBuffer() && !downstream_trailers_);
   // It's possible we got immediately reset.
   if (upstream_request_) {
@@ -277,7 +277,7 @@ private:
     bool encode_trailers_ : 1;
   };
 
-  typedef std::unique_ptr<UpstreamRequest> UpstreamRequestPtr;
+  typedef ArenaPtr<UpstreamRequest> UpstreamRequestPtr;
 
   enum class UpstreamResetType { Reset, GlobalTimeout, PerTryTimeout };
 
@@ -64,11 +64,12 @@ bool GenericKeyAction::populateDescriptor(const Router::RouteEntry&,
 }
 
 HeaderValueMatchAction::HeaderValueMatchAction(
-    const envoy::api::v2::route::RateLimit::Action::HeaderValueMatch& action)
+    const envoy::api::v2::route::RateLimit::Action::HeaderValueMatch& action,
+    Regex::Engine regex_engine)
     : descriptor_value_(action.descriptor_value()),
       expect_match_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(action, expect_match, true)) {
   for (const auto& header_matcher : action.headers()) {
-    action_headers_.push_back(header_matcher);
+    action_headers_.emplace_back(header_matcher, regex_engine);
   }
 }
 
@@ -84,7 +85,8 @@ bool HeaderValueMatchAction::populateDescriptor(const Router::RouteEntry&,
   }
 }
 
-RateLimitPolicyEntryImpl::RateLimitPolicyEntryImpl(const envoy::api::v2::route::RateLimit& config)
+RateLimitPolicyEntryImpl::RateLimitPolicyEntryImpl(const envoy::api::v2::route::RateLimit& config,
+                                                   Regex::Engine regex_engine)
     : disable_key_(config.disable_key()),
       stage_(static_cast<uint64_t>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, stage, 0))) {
   for (const auto& action : config.actions()) {
@@ -105,7 +107,7 @@ RateLimitPolicyEntryImpl::RateLimitPolicyEntryImpl(const envoy::api::v2::route::
       actions_.emplace_back(new GenericKeyAction(action.generic_key()));
       break;
     case envoy::api::v2::route::RateLimit::Action::kHeaderValueMatch:
-      actions_.emplace_back(new HeaderValueMatchAction(action.header_value_match()));
+      actions_.emplace_back(new HeaderValueMatchAction(action.header_value_match(), regex_engine));
       break;
     default:
       NOT_REACHED;
@@ -133,11 +135,12 @@ void RateLimitPolicyEntryImpl::populateDescriptors(
 }
 
 RateLimitPolicyImpl::RateLimitPolicyImpl(
-    const Protobuf::RepeatedPtrField<envoy::api::v2::route::RateLimit>& rate_limits)
+    const Protobuf::RepeatedPtrField<envoy::api::v2::route::RateLimit>& rate_limits,
+    Regex::Engine regex_engine)
     : rate_limit_entries_reference_(RateLimitPolicyImpl::MAX_STAGE_NUMBER + 1) {
   for (const auto& rate_limit : rate_limits) {
     std::unique_ptr<RateLimitPolicyEntry> rate_limit_policy_entry(
-        new RateLimitPolicyEntryImpl(rate_limit));
+        new RateLimitPolicyEntryImpl(rate_limit, regex_engine));
     uint64_t stage = rate_limit_policy_entry->stage();
     ASSERT(stage < rate_limit_entries_reference_.size());
     rate_limit_entries_reference_[stage].emplace_back(*rate_limit_policy_entry);
@@ -88,7 +88,8 @@ private:
  */
 class HeaderValueMatchAction : public RateLimitAction {
 public:
-  HeaderValueMatchAction(const envoy::api::v2::route::RateLimit::Action::HeaderValueMatch& action);
+  HeaderValueMatchAction(const envoy::api::v2::route::RateLimit::Action::HeaderValueMatch& action,
+                         Regex::Engine regex_engine = Regex::Engine::StdRegex);
 
   // Router::RateLimitAction
   bool populateDescriptor(const Router::RouteEntry& route, RateLimit::Descriptor& descriptor,
@@ -106,7 +107,8 @@ private:
  */
 class RateLimitPolicyEntryImpl : public RateLimitPolicyEntry {
 public:
-  RateLimitPolicyEntryImpl(const envoy::api::v2::route::RateLimit& config);
+  RateLimitPolicyEntryImpl(const envoy::api::v2::route::RateLimit& config,
+                           Regex::Engine regex_engine = Regex::Engine::StdRegex);
 
   // Router::RateLimitPolicyEntry
   uint64_t stage() const override { return stage_; }
@@ -128,7 +130,8 @@ private:
 class RateLimitPolicyImpl : public RateLimitPolicy {
 public:
   RateLimitPolicyImpl(
-      const Protobuf::RepeatedPtrField<envoy::api::v2::route::RateLimit>& rate_limits);
+      const Protobuf::RepeatedPtrField<envoy::api::v2::route::RateLimit>& rate_limits,
+      Regex::Engine regex_engine = Regex::Engine::StdRegex);
 
   // Router::RateLimitPolicy
   const std::vector<std::reference_wrapper<const RateLimitPolicyEntry>>&
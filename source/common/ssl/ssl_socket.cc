@@ -14,8 +14,11 @@ using Envoy::Network::PostIoAction;
 namespace Envoy {
 namespace Ssl {
 
-SslSocket::SslSocket(Context& ctx, InitialState state)
-    : ctx_(dynamic_cast<Ssl::ContextImpl&>(ctx)), ssl_(ctx_.newSsl()) {
+// How long a connection must not write before its TLS records are small again.
+static const std::chrono::milliseconds IdleRecordSizeReset(1000);
+
+SslSocket::SslSocket(Context& ctx, InitialState state, MonotonicTimeSource& time_source)
+    : ctx_(dynamic_cast<Ssl::ContextImpl&>(ctx)), ssl_(ctx_.newSsl()), time_source_(time_source) {
   if (state == InitialState::Client) {
     SSL_set_connect_state(ssl_.get());
   } else {
@@ -46,12 +49,13 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
   bool end_stream = false;
   PostIoAction action = PostIoAction::KeepOpen;
   uint64_t bytes_read = 0;
+  const uint64_t read_size = read_size_.readSize(callbacks_->connection().bufferLimit());
   while (keep_reading) {
     // We use 2 slices here so that we can use the remainder of an existing buffer chain element
-    // if there is extra space. 16K read is arbitrary and can be tuned later.
+    // if there is extra space.
     Buffer::RawSlice slices[2];
     uint64_t slices_to_commit = 0;
-    uint64_t num_slices = read_buffer.reserve(16384, slices, 2);
+    uint64_t num_slices = read_buffer.reserve(read_size, slices, 2);
     for (uint64_t i = 0; i < num_slices; i++) {
       int rc = SSL_read(ssl_.get(), slices[i].mem_, slices[i].len_);
       ENVOY_CONN_LOG(trace, "ssl read returns: {}", callbacks_->connection(), rc);
@@ -89,6 +93,7 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
     }
   }
 
+  read_size_.onReadEvent(bytes_read);
   return {action, bytes_read, end_stream};
 }
 
@@ -157,7 +162,10 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     bytes_to_write = bytes_to_retry_;
     bytes_to_retry_ = 0;
   } else {
-    bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+    if (write_buffer.length() > 0) {
+      onWriteStart();
+    }
+    bytes_to_write = nextWriteSize(write_buffer);
   }
 
   uint64_t total_bytes_written = 0;
@@ -167,15 +175,19 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
 
     // SSL_write() requires that if a previous call returns SSL_ERROR_WANT_WRITE, we need to call
     // it again with the same parameters. This is done by tracking last write size, but not write
-    // data, since linearize() will return the same undrained data anyway.
+    // data, since linearize() will return the same undrained data anyway. nextWriteSize() only
+    // picks sizes that either fit in the first slice, in which case linearize() returns the slice
+    // without copying, or that cover leading small slices, which linearize() then coalesces into
+    // the first slice so that a retry finds them there.
     ASSERT(bytes_to_write <= write_buffer.length());
     int rc = SSL_write(ssl_.get(), write_buffer.linearize(bytes_to_write), bytes_to_write);
     ENVOY_CONN_LOG(trace, "ssl write returns: {}", callbacks_->connection(), rc);
     if (rc > 0) {
       ASSERT(rc == static_cast<int>(bytes_to_write));
       total_bytes_written += rc;
+      bytes_written_ += rc;
       write_buffer.drain(rc);
-      bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+      bytes_to_write = nextWriteSize(write_buffer);
     } else {
       int err = SSL_get_error(ssl_.get(), rc);
       switch (err) {
@@ -200,6 +212,59 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
   return {PostIoAction::KeepOpen, total_bytes_written, false};
 }
 
+uint64_t SslSocket::nextWriteSize(const Buffer::Instance& write_buffer) const {
+  const uint64_t record_size =
+      bytes_written_ < SMALL_RECORD_BYTES ? SMALL_RECORD_SIZE : MAX_RECORD_SIZE;
+
+  // getRawSlices() can return empty slices, which are skipped.
+  Buffer::RawSlice raw_slices[MAX_COALESCED_SLICES];
+  const uint64_t num_raw_slices =
+      std::min(write_buffer.getRawSlices(raw_slices, MAX_COALESCED_SLICES),
+               static_cast<uint64_t>(MAX_COALESCED_SLICES));
+  Buffer::RawSlice slices[MAX_COALESCED_SLICES];
+  uint64_t num_slices = 0;
+  for (uint64_t i = 0; i < num_raw_slices; i++) {
+    if (raw_slices[i].len_ > 0) {
+      slices[num_slices++] = raw_slices[i];
+    }
+  }
+  if (num_slices == 0) {
+    return 0;
+  }
+
+  // Encrypt straight from the first slice when it holds a whole record, or when it is large enough
+  // that a shorter record costs less than copying.
+  if (slices[0].len_ >= record_size) {
+    return record_size;
+  }
+  if (slices[0].len_ >= MIN_DIRECT_WRITE_SIZE) {
+    return slices[0].len_;
+  }
+
+  // The first slice is a small fragment. Coalesce it with the small slices that follow it, but stop
+  // in front of a large slice so that its data is not copied.
+  uint64_t bytes_to_write = 0;
+  for (uint64_t i = 0; i < num_slices; i++) {
+    if (i > 0 && slices[i].len_ >= MIN_DIRECT_WRITE_SIZE) {
+      break;
+    }
+    bytes_to_write += slices[i].len_;
+    if (bytes_to_write >= record_size) {
+      return record_size;
+    }
+  }
+
+  return bytes_to_write;
+}
+
+void SslSocket::onWriteStart() {
+  const MonotonicTime now = time_source_.currentTime();
+  if (now - last_write_time_ >= IdleRecordSizeReset) {
+    bytes_written_ = 0;
+  }
+  last_write_time_ = now;
+}
+
 void SslSocket::onConnected() { ASSERT(!handshake_complete_); }
 
 void SslSocket::shutdownSsl() {
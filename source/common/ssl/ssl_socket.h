@@ -3,9 +3,12 @@
 #include <cstdint>
 #include <string>
 
+#include "envoy/common/time.h"
 #include "envoy/network/transport_socket.h"
 
 #include "common/common/logger.h"
+#include "common/common/utility.h"
+#include "common/network/adaptive_read_size.h"
 #include "common/ssl/context_impl.h"
 
 #include "openssl/ssl.h"
@@ -19,7 +22,8 @@ class SslSocket : public Network::TransportSocket,
                   public Connection,
                   protected Logger::Loggable<Logger::Id::connection> {
 public:
-  SslSocket(Context& ctx, InitialState state);
+  SslSocket(Context& ctx, InitialState state,
+            MonotonicTimeSource& time_source = ProdMonotonicTimeSource::instance_);
 
   // Ssl::Connection
   bool peerCertificatePresented() const override;
@@ -44,8 +48,30 @@ public:
   SSL* rawSslForTest() { return ssl_.get(); }
 
 private:
+  friend class SslSocketWriteSizeTest;
+
+  // Records are kept to about one TCP segment until the connection has written SMALL_RECORD_BYTES,
+  // so that the peer can decrypt the first bytes of a response without waiting for a 16KiB record
+  // to arrive over several round trips of slow start. Full size records are used after that, until
+  // the connection has not written anything for a second, which restarts slow start.
+  static constexpr uint64_t SMALL_RECORD_SIZE = 1400;
+  static constexpr uint64_t SMALL_RECORD_BYTES = 1024 * 1024;
+  static constexpr uint64_t MAX_RECORD_SIZE = 16384;
+  // Slices at least this large are encrypted in place. Smaller ones are coalesced into one record
+  // with their neighbours, looking at no more than MAX_COALESCED_SLICES slices.
+  static constexpr uint64_t MIN_DIRECT_WRITE_SIZE = 4096;
+  static constexpr uint64_t MAX_COALESCED_SLICES = 16;
+
   Network::PostIoAction doHandshake();
   void drainErrorQueue();
+  /**
+   * @return the number of bytes at the front of write_buffer to encrypt into the next TLS record.
+   */
+  uint64_t nextWriteSize(const Buffer::Instance& write_buffer) const;
+  /**
+   * Go back to small records if the connection has been idle since its last write.
+   */
+  void onWriteStart();
   void shutdownSsl();
   std::string getUriSanFromCertificate(X509* cert);
   std::string getSubjectFromCertificate(X509* cert) const;
@@ -56,6 +82,11 @@ private:
   bool handshake_complete_{};
   bool shutdown_sent_{};
   uint64_t bytes_to_retry_{};
+  // Bytes written since the connection was last idle, which select the record size.
+  uint64_t bytes_written_{};
+  MonotonicTimeSource& time_source_;
+  MonotonicTime last_write_time_{};
+  Network::AdaptiveReadSize read_size_;
   mutable std::string cached_sha_256_peer_certificate_digest_;
   mutable std::string cached_url_encoded_pem_encoded_peer_certificate_;
 };
@@ -0,0 +1,104 @@
+#include "common/stats/histogram_impl.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "common/common/fmt.h"
+#include "common/common/macros.h"
+#include "common/common/utility.h"
+
+namespace Envoy {
+namespace Stats {
+
+void LogLinearHistogram::merge(const LogLinearHistogram& other) {
+  if (other.counts_.size() > counts_.size()) {
+    counts_.resize(other.counts_.size());
+  }
+  for (size_t i = 0; i < other.counts_.size(); i++) {
+    counts_[i] += other.counts_[i];
+  }
+  sample_count_ += other.sample_count_;
+  sample_sum_ += other.sample_sum_;
+}
+
+void LogLinearHistogram::clear() {
+  // Keep the allocated buckets. The same histogram will most likely see the same range of values in
+  // the next interval.
+  std::fill(counts_.begin(), counts_.end(), 0);
+  sample_count_ = 0;
+  sample_sum_ = 0;
+}
+
+uint64_t LogLinearHistogram::bucketLowerBound(uint32_t index) {
+  if (index < 2 * SUB_BUCKET_COUNT) {
+    return index;
+  }
+  const uint32_t shift = index / SUB_BUCKET_COUNT - 1;
+  return static_cast<uint64_t>(index - shift * SUB_BUCKET_COUNT) << shift;
+}
+
+uint64_t LogLinearHistogram::bucketUpperBound(uint32_t index) {
+  if (index < 2 * SUB_BUCKET_COUNT) {
+    return index;
+  }
+  const uint32_t shift = index / SUB_BUCKET_COUNT - 1;
+  // For the very last bucket this wraps around to 2^64 - 1, which is the correct upper bound.
+  return (static_cast<uint64_t>(index - shift * SUB_BUCKET_COUNT + 1) << shift) - 1;
+}
+
+double LogLinearHistogram::quantile(double quantile) const {
+  if (sample_count_ == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  const double rank = std::min(std::max(quantile, 0.0), 1.0) * sample_count_;
+  uint64_t cumulative = 0;
+  uint32_t last_used_index = 0;
+  for (uint32_t i = 0; i < counts_.size(); i++) {
+    if (counts_[i] == 0) {
+      continue;
+    }
+    last_used_index = i;
+    if (cumulative + counts_[i] >= rank) {
+      const double fraction = (rank - cumulative) / counts_[i];
+      const double lower = bucketLowerBound(i);
+      const double upper = bucketUpperBound(i);
+      return lower + fraction * (upper - lower);
+    }
+    cumulative += counts_[i];
+  }
+
+  return bucketUpperBound(last_used_index);
+}
+
+HistogramStatisticsImpl::HistogramStatisticsImpl()
+    : computed_quantiles_(supportedQuantiles().size(), std::numeric_limits<double>::quiet_NaN()) {}
+
+void HistogramStatisticsImpl::refresh(const LogLinearHistogram& histogram) {
+  const std::vector<double>& quantiles = supportedQuantiles();
+  for (size_t i = 0; i < quantiles.size(); i++) {
+    computed_quantiles_[i] = histogram.quantile(quantiles[i]);
+  }
+  sample_count_ = histogram.sampleCount();
+  sample_sum_ = histogram.sampleSum();
+}
+
+const std::vector<double>& HistogramStatisticsImpl::supportedQuantiles() const {
+  CONSTRUCT_ON_FIRST_USE(std::vector<double>, {0.5, 0.9, 0.99, 0.999});
+}
+
+std::string HistogramStatisticsImpl::summary() const {
+  std::vector<std::string> summary;
+  const std::vector<double>& quantiles = supportedQuantiles();
+  summary.reserve(quantiles.size());
+  for (size_t i = 0; i < quantiles.size(); i++) {
+    summary.push_back(fmt::format("P{:g}: {:g}", 100 * quantiles[i], computed_quantiles_[i]));
+  }
+  return StringUtil::join(summary, ", ");
+}
+
+} // namespace Stats
+} // namespace Envoy
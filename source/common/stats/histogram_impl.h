@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/stats/stats.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Log-linear bucketed histogram in the style of HdrHistogram. Values below 2^SUB_BUCKET_BITS are
+ * recorded exactly. Larger values are split into power of two ranges, each of which is split into
+ * 2^SUB_BUCKET_BITS linear sub-buckets, which bounds the relative error of any reported quantile to
+ * 1/2^SUB_BUCKET_BITS (6.25%). The bucket array only grows up to the largest recorded value, so a
+ * histogram of millisecond latencies stays well under 1KB.
+ *
+ * This class is not thread safe. Thread local recording is done by ThreadLocalHistogramImpl in
+ * thread_local_store.h, which hands off complete buffers to the main thread for merging.
+ */
+class LogLinearHistogram {
+public:
+  static const uint32_t SUB_BUCKET_BITS = 4;
+  static const uint32_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+
+  /**
+   * Record a single value.
+   */
+  void recordValue(uint64_t value) {
+    const uint32_t index = bucketIndex(value);
+    if (index >= counts_.size()) {
+      counts_.resize(index + 1);
+    }
+    counts_[index]++;
+    sample_count_++;
+    sample_sum_ += value;
+  }
+
+  /**
+   * Add all the samples of another histogram into this one.
+   */
+  void merge(const LogLinearHistogram& other);
+
+  /**
+   * Remove all samples.
+   */
+  void clear();
+
+  /**
+   * @param quantile supplies the quantile in the range [0, 1].
+   * @return double the estimated value at the quantile, linearly interpolated within the bucket
+   *         containing it, or NaN if the histogram is empty.
+   */
+  double quantile(double quantile) const;
+
+  uint64_t sampleCount() const { return sample_count_; }
+  uint64_t sampleSum() const { return sample_sum_; }
+
+  /**
+   * @return uint32_t the index of the bucket a value is recorded into.
+   */
+  static uint32_t bucketIndex(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+      return value;
+    }
+    const uint32_t shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+    return shift * SUB_BUCKET_COUNT + (value >> shift);
+  }
+
+  /**
+   * @return uint64_t the smallest value recorded into a bucket.
+   */
+  static uint64_t bucketLowerBound(uint32_t index);
+
+  /**
+   * @return uint64_t the largest value recorded into a bucket.
+   */
+  static uint64_t bucketUpperBound(uint32_t index);
+
+private:
+  std::vector<uint64_t> counts_;
+  uint64_t sample_count_{};
+  uint64_t sample_sum_{};
+};
+
+/**
+ * Implementation of HistogramStatistics computed from a LogLinearHistogram.
+ */
+class HistogramStatisticsImpl : public HistogramStatistics {
+public:
+  HistogramStatisticsImpl();
+
+  /**
+   * Recompute the statistics from the histogram.
+   */
+  void refresh(const LogLinearHistogram& histogram);
+
+  // Stats::HistogramStatistics
+  std::string summary() const override;
+  const std::vector<double>& supportedQuantiles() const override;
+  const std::vector<double>& computedQuantiles() const override { return computed_quantiles_; }
+  uint64_t sampleCount() const override { return sample_count_; }
+  uint64_t sampleSum() const override { return sample_sum_; }
+
+private:
+  std::vector<double> computed_quantiles_;
+  uint64_t sample_count_{};
+  uint64_t sample_sum_{};
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -1,8 +1,14 @@
 #include "common/stats/statsd.h"
 
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <string>
+#include <vector>
 
 #include "envoy/common/exception.h"
 #include "envoy/event/dispatcher.h"
@@ -36,24 +42,79 @@ void Writer::write(const std::string& message) {
   ::send(fd_, message.c_str(), message.size(), MSG_DONTWAIT);
 }
 
+void Writer::writeMany(const std::vector<std::string>& messages) {
+#ifdef __linux__
+  const size_t max_batch = std::min<size_t>(messages.size(), UIO_MAXIOV);
+  std::vector<struct mmsghdr> headers(max_batch);
+  std::vector<struct iovec> iovecs(max_batch);
+  size_t sent = 0;
+  while (sent < messages.size()) {
+    const size_t batch = std::min(messages.size() - sent, max_batch);
+    for (size_t i = 0; i < batch; i++) {
+      const std::string& message = messages[sent + i];
+      iovecs[i].iov_base = const_cast<char*>(message.data());
+      iovecs[i].iov_len = message.size();
+      memset(&headers[i], 0, sizeof(headers[i]));
+      headers[i].msg_hdr.msg_iov = &iovecs[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    const int rc = ::sendmmsg(fd_, headers.data(), batch, MSG_DONTWAIT);
+    if (rc <= 0) {
+      // As with write(), stats that cannot be sent right away (e.g., the socket buffer is full)
+      // are dropped.
+      return;
+    }
+    sent += rc;
+  }
+#else
+  for (const std::string& message : messages) {
+    write(message);
+  }
+#endif
+}
+
+const std::string UdpStatsdSink::MAX_PACKET_BYTES_RUNTIME_KEY = "stats.statsd.udp_max_packet_bytes";
+
 UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
-                             Network::Address::InstanceConstSharedPtr address, const bool use_tag)
-    : tls_(tls.allocateSlot()), server_address_(std::move(address)), use_tag_(use_tag) {
+                             Network::Address::InstanceConstSharedPtr address, const bool use_tag,
+                             uint64_t max_packet_bytes)
+    : tls_(tls.allocateSlot()), server_address_(std::move(address)), use_tag_(use_tag),
+      max_packet_bytes_(max_packet_bytes) {
   tls_->set([this](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     return std::make_shared<Writer>(this->server_address_);
   });
 }
 
 void UdpStatsdSink::flushCounter(const Counter& counter, uint64_t delta) {
-  const std::string message(
+  writeFlushed(
       fmt::format("envoy.{}:{}|c{}", getName(counter), delta, buildTagStr(counter.tags())));
-  tls_->getTyped<Writer>().write(message);
 }
 
 void UdpStatsdSink::flushGauge(const Gauge& gauge, uint64_t value) {
-  const std::string message(
-      fmt::format("envoy.{}:{}|g{}", getName(gauge), value, buildTagStr(gauge.tags())));
-  tls_->getTyped<Writer>().write(message);
+  writeFlushed(fmt::format("envoy.{}:{}|g{}", getName(gauge), value, buildTagStr(gauge.tags())));
+}
+
+void UdpStatsdSink::endFlush() {
+  if (!packets_.empty()) {
+    tls_->getTyped<Writer>().writeMany(packets_);
+    packets_.clear();
+  }
+}
+
+void UdpStatsdSink::writeFlushed(const std::string& message) {
+  if (max_packet_bytes_ == 0) {
+    tls_->getTyped<Writer>().write(message);
+    return;
+  }
+
+  // A metric that does not fit in a datagram by itself is still sent, alone.
+  if (!packets_.empty() && packets_.back().size() + 1 + message.size() <= max_packet_bytes_) {
+    packets_.back().push_back('\n');
+    packets_.back().append(message);
+  } else {
+    packets_.push_back(message);
+  }
 }
 
 void UdpStatsdSink::onHistogramComplete(const Histogram& histogram, uint64_t value) {
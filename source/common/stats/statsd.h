@@ -3,6 +3,7 @@
 #include <chrono>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "envoy/local_info/local_info.h"
 #include "envoy/network/connection.h"
@@ -27,6 +28,13 @@ public:
   virtual ~Writer();
 
   virtual void write(const std::string& message);
+
+  /**
+   * Write several messages, each as its own datagram. On Linux this takes a single sendmmsg() call
+   * per batch of up to UIO_MAXIOV datagrams.
+   */
+  virtual void writeMany(const std::vector<std::string>& messages);
+
   // Called in unit test to validate address.
   int getFdForTests() const { return fd_; };
 
@@ -39,22 +47,35 @@ private:
  */
 class UdpStatsdSink : public Sink {
 public:
+  /**
+   * @param max_packet_bytes supplies the maximum size of the datagrams sent during a flush. If it is
+   *        not zero, the counters and gauges of a flush are packed into newline separated datagrams
+   *        of up to this size, which are all sent at the end of the flush. Otherwise each metric is
+   *        sent in its own datagram.
+   */
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, Network::Address::InstanceConstSharedPtr address,
-                const bool use_tag);
+                const bool use_tag, uint64_t max_packet_bytes);
   // For testing.
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, const std::shared_ptr<Writer>& writer,
-                const bool use_tag)
-      : tls_(tls.allocateSlot()), use_tag_(use_tag) {
+                const bool use_tag, uint64_t max_packet_bytes = 0)
+      : tls_(tls.allocateSlot()), use_tag_(use_tag), max_packet_bytes_(max_packet_bytes) {
     tls_->set(
         [writer](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr { return writer; });
   }
 
+  // Runtime key of the max_packet_bytes passed to the sink by the statsd sink factories.
+  static const std::string MAX_PACKET_BYTES_RUNTIME_KEY;
+
   // Stats::Sink
   void beginFlush() override {}
   void flushCounter(const Counter& counter, uint64_t delta) override;
   void flushGauge(const Gauge& gauge, uint64_t value) override;
-  void endFlush() override {}
+  // Histogram values are already written per sample in onHistogramComplete() and aggregated by the
+  // statsd server, so merged histograms are not flushed.
+  void flushHistogram(const ParentHistogram&) override {}
+  void endFlush() override;
   void onHistogramComplete(const Histogram& histogram, uint64_t value) override;
+  bool wantsHistogramValues() const override { return true; }
 
   // Called in unit test to validate writer construction and address.
   int getFdForTests() { return tls_->getTyped<Writer>().getFdForTests(); }
@@ -63,10 +84,14 @@ public:
 private:
   const std::string getName(const Metric& metric);
   const std::string buildTagStr(const std::vector<Tag>& tags);
+  void writeFlushed(const std::string& message);
 
   ThreadLocal::SlotPtr tls_;
   Network::Address::InstanceConstSharedPtr server_address_;
   const bool use_tag_;
+  const uint64_t max_packet_bytes_;
+  // Datagrams built during the current flush. Only used on the main thread.
+  std::vector<std::string> packets_;
 };
 
 /**
@@ -89,6 +114,10 @@ public:
     tls_->getTyped<TlsSink>().flushGauge(gauge.name(), value);
   }
 
+  void flushHistogram(const ParentHistogram&) override {
+    // See UdpStatsdSink::flushHistogram().
+  }
+
   void endFlush() override { tls_->getTyped<TlsSink>().endFlush(true); }
 
   void onHistogramComplete(const Histogram& histogram, uint64_t value) override {
@@ -97,6 +126,8 @@ public:
                                                  std::chrono::milliseconds(value));
   }
 
+  bool wantsHistogramValues() const override { return true; }
+
 private:
   struct TlsSink : public ThreadLocal::ThreadLocalObject, public Network::ConnectionCallbacks {
     TlsSink(TcpStatsdSink& parent, Event::Dispatcher& dispatcher);
@@ -8,6 +8,8 @@
 #include <string>
 #include <unordered_set>
 
+#include "common/common/fmt.h"
+
 namespace Envoy {
 namespace Stats {
 
@@ -61,6 +63,22 @@ std::list<GaugeSharedPtr> ThreadLocalStoreImpl::gauges() const {
   return ret;
 }
 
+std::list<ParentHistogramSharedPtr> ThreadLocalStoreImpl::histograms() const {
+  // Handle de-dup due to overlapping scopes.
+  std::list<ParentHistogramSharedPtr> ret;
+  std::unordered_set<std::string> names;
+  std::unique_lock<std::mutex> lock(lock_);
+  for (ScopeImpl* scope : scopes_) {
+    for (const auto& name_histogram_pair : scope->central_cache_.histograms_) {
+      if (names.insert(name_histogram_pair.first).second) {
+        ret.push_back(name_histogram_pair.second);
+      }
+    }
+  }
+
+  return ret;
+}
+
 void ThreadLocalStoreImpl::initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                                                ThreadLocal::Instance& tls) {
   main_thread_dispatcher_ = &main_thread_dispatcher;
@@ -75,6 +93,33 @@ void ThreadLocalStoreImpl::shutdownThreading() {
   shutting_down_ = true;
 }
 
+void ThreadLocalStoreImpl::mergeHistograms(PostMergeCb merge_complete_cb) {
+  if (!shutting_down_ && tls_) {
+    tls_->runOnAllThreads(
+        [this]() -> void {
+          for (const auto& scope : tls_->getTyped<TlsCache>().scope_cache_) {
+            for (const auto& name_histogram_pair : scope.second.histograms_) {
+              name_histogram_pair.second->beginMerge();
+            }
+          }
+        },
+        [this, merge_complete_cb]() -> void { mergeInternal(merge_complete_cb); });
+  } else {
+    // If threading is not initialized (or we are shutting down) there are no thread local
+    // histograms to swap, so the callback can be called right away.
+    merge_complete_cb();
+  }
+}
+
+void ThreadLocalStoreImpl::mergeInternal(PostMergeCb merge_complete_cb) {
+  if (!shutting_down_) {
+    for (const ParentHistogramSharedPtr& histogram : histograms()) {
+      histogram->merge();
+    }
+    merge_complete_cb();
+  }
+}
+
 void ThreadLocalStoreImpl::releaseScopeCrossThread(ScopeImpl* scope) {
   std::unique_lock<std::mutex> lock(lock_);
   ASSERT(scopes_.count(scope) == 1);
@@ -201,12 +246,14 @@ Gauge& ThreadLocalStoreImpl::ScopeImpl::gauge(const std::string& name) {
 }
 
 Histogram& ThreadLocalStoreImpl::ScopeImpl::histogram(const std::string& name) {
-  // See comments in counter(). There is no super clean way (via templates or otherwise) to
-  // share this code so I'm leaving it largely duplicated for now.
+  // See comments in counter(). The TLS cache points to the central cache entry, which is what is
+  // returned even though values are recorded per thread: long lived stats get their histograms on
+  // the main thread and record into them on the workers, so the thread local histogram can only be
+  // picked when a value is recorded. See tlsHistogram().
   std::string final_name = prefix_ + name;
-  HistogramSharedPtr* tls_ref = nullptr;
+  ParentHistogramImplSharedPtr* tls_ref = nullptr;
   if (!parent_.shutting_down_ && parent_.tls_) {
-    tls_ref = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this].histograms_[final_name];
+    tls_ref = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this].parent_histograms_[final_name];
   }
 
   if (tls_ref && *tls_ref) {
@@ -214,12 +261,12 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogram(const std::string& name) {
   }
 
   std::unique_lock<std::mutex> lock(parent_.lock_);
-  HistogramSharedPtr& central_ref = central_cache_.histograms_[final_name];
+  ParentHistogramImplSharedPtr& central_ref = central_cache_.histograms_[final_name];
   if (!central_ref) {
     std::vector<Tag> tags;
     std::string tag_extracted_name = parent_.getTagsForName(final_name, tags);
-    central_ref.reset(
-        new HistogramImpl(final_name, parent_, std::move(tag_extracted_name), std::move(tags)));
+    central_ref.reset(new ParentHistogramImpl(final_name, parent_, *this,
+                                              std::move(tag_extracted_name), std::move(tags)));
   }
 
   if (tls_ref) {
@@ -229,5 +276,78 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogram(const std::string& name) {
   return *central_ref;
 }
 
+ThreadLocalHistogramImpl*
+ThreadLocalStoreImpl::ScopeImpl::tlsHistogram(ParentHistogramImpl& parent) {
+  if (parent_.shutting_down_ || !parent_.tls_) {
+    return nullptr;
+  }
+
+  // Each thread gets its own ThreadLocalHistogramImpl, which is registered with the parent so that
+  // it can be merged later.
+  TlsHistogramSharedPtr& tls_ref =
+      parent_.tls_->getTyped<TlsCache>().scope_cache_[this].histograms_[parent.name()];
+  if (!tls_ref) {
+    std::vector<Tag> tags = parent.tags();
+    tls_ref = std::make_shared<ThreadLocalHistogramImpl>(
+        parent.name(), std::string(parent.tagExtractedName()), std::move(tags));
+    parent.addTlsHistogram(tls_ref);
+  }
+
+  return tls_ref.get();
+}
+
+void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
+  ASSERT(std::this_thread::get_id() == created_thread_id_);
+  histograms_[current_active_].recordValue(value);
+}
+
+void ThreadLocalHistogramImpl::merge(LogLinearHistogram& target) {
+  LogLinearHistogram& histogram = histograms_[otherHistogramIndex()];
+  target.merge(histogram);
+  histogram.clear();
+}
+
+void ParentHistogramImpl::addTlsHistogram(const TlsHistogramSharedPtr& hist_ptr) {
+  std::unique_lock<std::mutex> lock(merge_lock_);
+  tls_histograms_.emplace_back(hist_ptr);
+}
+
+void ParentHistogramImpl::recordValue(uint64_t value) {
+  // Values are only aggregated when they are recorded via a thread local histogram, which there is
+  // none of before threading is initialized and during shutdown.
+  ThreadLocalHistogramImpl* tls_histogram = tls_scope_.tlsHistogram(*this);
+  if (tls_histogram != nullptr) {
+    tls_histogram->recordValue(value);
+  }
+
+  if (parent_.hasHistogramValueSinks()) {
+    parent_.deliverHistogramToSinks(*this, value);
+  }
+}
+
+void ParentHistogramImpl::merge() {
+  std::unique_lock<std::mutex> lock(merge_lock_);
+  interval_histogram_.clear();
+  for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
+    tls_histogram->merge(interval_histogram_);
+  }
+  used_ = used_ || interval_histogram_.sampleCount() > 0;
+  cumulative_histogram_.merge(interval_histogram_);
+  interval_statistics_.refresh(interval_histogram_);
+  cumulative_statistics_.refresh(cumulative_histogram_);
+}
+
+std::string ParentHistogramImpl::summary() const {
+  std::vector<std::string> summary;
+  const std::vector<double>& supported_quantiles = interval_statistics_.supportedQuantiles();
+  summary.reserve(supported_quantiles.size());
+  for (size_t i = 0; i < supported_quantiles.size(); i++) {
+    summary.push_back(fmt::format("P{:g}({:g},{:g})", 100 * supported_quantiles[i],
+                                  interval_statistics_.computedQuantiles()[i],
+                                  cumulative_statistics_.computedQuantiles()[i]));
+  }
+  return StringUtil::join(summary, " ");
+}
+
 } // namespace Stats
 } // namespace Envoy
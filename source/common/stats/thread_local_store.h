@@ -6,16 +6,123 @@
 #include <list>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/stats/histogram_impl.h"
 #include "common/stats/stats_impl.h"
 
 namespace Envoy {
 namespace Stats {
 
+class ParentHistogramImpl;
+class ThreadLocalStoreImpl;
+
+/**
+ * A histogram that is stored in TLS and used to record values per thread. This holds two
+ * histograms, one to collect the values and other as backup that is used for merge process. The
+ * swap happens during the merge process.
+ */
+class ThreadLocalHistogramImpl : public Histogram, public MetricImpl {
+public:
+  ThreadLocalHistogramImpl(const std::string& name, std::string&& tag_extracted_name,
+                           std::vector<Tag>&& tags)
+      : MetricImpl(name, std::move(tag_extracted_name), std::move(tags)),
+        created_thread_id_(std::this_thread::get_id()) {}
+
+  /**
+   * Called in the beginning of merge process. Swaps the histogram used for collection so that we
+   * do not have to lock the histogram in high throughput TLS writes. Must be called on the thread
+   * that owns the histogram.
+   */
+  void beginMerge() {
+    // This method is called in all threads and in the context of the owning thread.
+    ASSERT(std::this_thread::get_id() == created_thread_id_);
+    current_active_ = otherHistogramIndex();
+  }
+
+  /**
+   * Merges the histogram that is not currently collecting values into target and clears it. Must
+   * be called on the main thread after beginMerge() has run on the owning thread.
+   */
+  void merge(LogLinearHistogram& target);
+
+  // Stats::Histogram
+  void recordValue(uint64_t value) override;
+
+private:
+  uint64_t otherHistogramIndex() const { return 1 - current_active_; }
+
+  uint64_t current_active_{};
+  LogLinearHistogram histograms_[2];
+  const std::thread::id created_thread_id_;
+};
+
+typedef std::shared_ptr<ThreadLocalHistogramImpl> TlsHistogramSharedPtr;
+
+/**
+ * A scope that owns the thread local histograms of its ParentHistogramImpls.
+ */
+class TlsScope : public Scope {
+public:
+  virtual ~TlsScope() {}
+
+  /**
+   * @param parent supplies the histogram to find the calling thread's histogram for.
+   * @return ThreadLocalHistogramImpl* the calling thread's histogram for parent, which is created
+   *         and registered with parent on first use. nullptr if threading is not initialized or is
+   *         shutting down.
+   */
+  virtual ThreadLocalHistogramImpl* tlsHistogram(ParentHistogramImpl& parent) PURE;
+};
+
+/**
+ * Log Linear Histogram implementation that is stored in the main thread. It owns the references
+ * to all of the per thread histograms of a stat and merges them into interval and cumulative
+ * histograms during the stats flush. This is the histogram handed out by the store, so it can be
+ * looked up on one thread and recorded into from any other.
+ */
+class ParentHistogramImpl : public ParentHistogram, public MetricImpl {
+public:
+  ParentHistogramImpl(const std::string& name, ThreadLocalStoreImpl& parent, TlsScope& tls_scope,
+                      std::string&& tag_extracted_name, std::vector<Tag>&& tags)
+      : MetricImpl(name, std::move(tag_extracted_name), std::move(tags)), parent_(parent),
+        tls_scope_(tls_scope) {}
+
+  /**
+   * Register a thread local histogram whose values are merged into this histogram.
+   */
+  void addTlsHistogram(const TlsHistogramSharedPtr& hist_ptr);
+
+  // Stats::Histogram
+  void recordValue(uint64_t value) override;
+
+  // Stats::ParentHistogram
+  void merge() override;
+  const HistogramStatistics& intervalStatistics() const override { return interval_statistics_; }
+  const HistogramStatistics& cumulativeStatistics() const override {
+    return cumulative_statistics_;
+  }
+  std::string summary() const override;
+  bool used() const override { return used_; }
+
+private:
+  ThreadLocalStoreImpl& parent_;
+  TlsScope& tls_scope_;
+  std::list<TlsHistogramSharedPtr> tls_histograms_;
+  LogLinearHistogram interval_histogram_;
+  LogLinearHistogram cumulative_histogram_;
+  HistogramStatisticsImpl interval_statistics_;
+  HistogramStatisticsImpl cumulative_statistics_;
+  mutable std::mutex merge_lock_;
+  bool used_{};
+};
+
+typedef std::shared_ptr<ParentHistogramImpl> ParentHistogramImplSharedPtr;
+
 /**
  * Store implementation with thread local caching. This implementation supports the following
  * features:
@@ -38,8 +145,15 @@ namespace Stats {
  *         with the same address, and a cache flush operation could race and delete cache data
  *         for the new scope. This is extremely unlikely, and if it happens the cache will be
  *         repopulated on the next access.
- * - Since it's possible to have overlapping scopes, we de-dup stats when counters() or gauges() is
- *   called since these are very uncommon operations.
+ * - Since it's possible to have overlapping scopes, we de-dup stats when counters(), gauges() or
+ *   histograms() is called since these are very uncommon operations.
+ * - Histograms are recorded into a per thread ThreadLocalHistogramImpl without any locking. Each
+ *   histogram in the central cache is a ParentHistogramImpl that references all the thread local
+ *   histograms of the stat. The store hands out the ParentHistogramImpl, which records each value
+ *   into the calling thread's histogram, since long lived stats get their histograms on the main
+ *   thread and record into them on the workers. mergeHistograms() swaps the thread local buffers
+ *   on every thread and then merges the swapped out buffers into the parent on the main thread,
+ *   after which the interval and cumulative quantiles are available.
  * - Though this implementation is designed to work with a fixed shared memory space, it will fall
  *   back to heap allocated stats if needed. NOTE: In this case, overlapping scopes will not share
  *   the same backing store. This is to keep things simple, it could be done in the future if
@@ -64,24 +178,43 @@ public:
   // Stats::Store
   std::list<CounterSharedPtr> counters() const override;
   std::list<GaugeSharedPtr> gauges() const override;
+  std::list<ParentHistogramSharedPtr> histograms() const override;
 
   // Stats::StoreRoot
-  void addSink(Sink& sink) override { timer_sinks_.push_back(sink); }
+  void addSink(Sink& sink) override {
+    if (sink.wantsHistogramValues()) {
+      timer_sinks_.push_back(sink);
+    }
+  }
   void setTagProducer(TagProducerPtr&& tag_producer) override {
     tag_producer_ = std::move(tag_producer);
   }
   void initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                            ThreadLocal::Instance& tls) override;
   void shutdownThreading() override;
+  void mergeHistograms(PostMergeCb merge_complete_cb) override;
+
+  /**
+   * @return bool whether any sink wants histogram values as they are recorded. If not, values are
+   *         only reported through the merged histograms on every flush.
+   */
+  bool hasHistogramValueSinks() const { return !timer_sinks_.empty(); }
 
 private:
   struct TlsCacheEntry {
     std::unordered_map<std::string, CounterSharedPtr> counters_;
     std::unordered_map<std::string, GaugeSharedPtr> gauges_;
-    std::unordered_map<std::string, HistogramSharedPtr> histograms_;
+    std::unordered_map<std::string, ParentHistogramImplSharedPtr> parent_histograms_;
+    std::unordered_map<std::string, TlsHistogramSharedPtr> histograms_;
   };
 
-  struct ScopeImpl : public Scope {
+  struct CentralCacheEntry {
+    std::unordered_map<std::string, CounterSharedPtr> counters_;
+    std::unordered_map<std::string, GaugeSharedPtr> gauges_;
+    std::unordered_map<std::string, ParentHistogramImplSharedPtr> histograms_;
+  };
+
+  struct ScopeImpl : public TlsScope {
     ScopeImpl(ThreadLocalStoreImpl& parent, const std::string& prefix)
         : parent_(parent), prefix_(Utility::sanitizeStatsName(prefix)) {}
     ~ScopeImpl();
@@ -95,9 +228,12 @@ private:
     Gauge& gauge(const std::string& name) override;
     Histogram& histogram(const std::string& name) override;
 
+    // Stats::TlsScope
+    ThreadLocalHistogramImpl* tlsHistogram(ParentHistogramImpl& parent) override;
+
     ThreadLocalStoreImpl& parent_;
     const std::string prefix_;
-    TlsCacheEntry central_cache_;
+    CentralCacheEntry central_cache_;
   };
 
   struct TlsCache : public ThreadLocal::ThreadLocalObject {
@@ -112,6 +248,7 @@ private:
   std::string getTagsForName(const std::string& name, std::vector<Tag>& tags);
   void clearScopeFromCaches(ScopeImpl* scope);
   void releaseScopeCrossThread(ScopeImpl* scope);
+  void mergeInternal(PostMergeCb merge_cb);
   SafeAllocData safeAlloc(const std::string& name);
 
   RawStatDataAllocator& alloc_;
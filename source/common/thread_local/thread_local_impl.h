@@ -35,6 +35,9 @@ private:
     // ThreadLocal::Slot
     ThreadLocalObjectSharedPtr get() override;
     void runOnAllThreads(Event::PostCb cb) override { parent_.runOnAllThreads(cb); }
+    void runOnAllThreads(Event::PostCb cb, Event::PostCb all_threads_complete_cb) override {
+      parent_.runOnAllThreads(cb, all_threads_complete_cb);
+    }
     void set(InitializeCb cb) override;
 
     InstanceImpl& parent_;
@@ -48,6 +51,7 @@ private:
 
   void removeSlot(SlotImpl& slot);
   void runOnAllThreads(Event::PostCb cb);
+  void runOnAllThreads(Event::PostCb cb, Event::PostCb main_callback);
   static void setThreadLocal(uint32_t index, ThreadLocalObjectSharedPtr object);
 
   static thread_local ThreadLocalData thread_local_data_;
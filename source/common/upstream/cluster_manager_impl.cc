@@ -1,5 +1,6 @@
 #include "common/upstream/cluster_manager_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <functional>
@@ -489,23 +490,12 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(const Cluster& primary_clu
                                                       const HostVector& hosts_added,
                                                       const HostVector& hosts_removed) {
   const auto& host_set = primary_cluster.prioritySet().hostSetsPerPriority()[priority];
+  HostSetUpdateConstSharedPtr update =
+      std::make_shared<const HostSetUpdate>(*host_set, hosts_added, hosts_removed);
 
-  HostVectorConstSharedPtr hosts_copy(new HostVector(host_set->hosts()));
-  HostVectorConstSharedPtr healthy_hosts_copy(new HostVector(host_set->healthyHosts()));
-  HostsPerLocalityConstSharedPtr hosts_per_locality_copy = host_set->hostsPerLocality().clone();
-  HostsPerLocalityConstSharedPtr healthy_hosts_per_locality_copy =
-      host_set->healthyHostsPerLocality().clone();
-
-  tls_->runOnAllThreads([
-    this, name = primary_cluster.info()->name(), priority, hosts_copy, healthy_hosts_copy,
-    hosts_per_locality_copy, healthy_hosts_per_locality_copy, hosts_added, hosts_removed
-  ]()
-                            ->void {
-                              ThreadLocalClusterManagerImpl::updateClusterMembership(
-                                  name, priority, hosts_copy, healthy_hosts_copy,
-                                  hosts_per_locality_copy, healthy_hosts_per_locality_copy,
-                                  hosts_added, hosts_removed, *tls_);
-                            });
+  tls_->runOnAllThreads([this, name = primary_cluster.info()->name(), update]() -> void {
+    ThreadLocalClusterManagerImpl::updateClusterMembership(name, *update, *tls_);
+  });
 }
 
 void ClusterManagerImpl::postThreadLocalHealthFailure(const HostSharedPtr& host) {
@@ -630,19 +620,16 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::drainConnPools(
 }
 
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
-    const std::string& name, uint32_t priority, HostVectorConstSharedPtr hosts,
-    HostVectorConstSharedPtr healthy_hosts, HostsPerLocalityConstSharedPtr hosts_per_locality,
-    HostsPerLocalityConstSharedPtr healthy_hosts_per_locality, const HostVector& hosts_added,
-    const HostVector& hosts_removed, ThreadLocal::Slot& tls) {
+    const std::string& name, const HostSetUpdate& update, ThreadLocal::Slot& tls) {
 
   ThreadLocalClusterManagerImpl& config = tls.getTyped<ThreadLocalClusterManagerImpl>();
 
   ASSERT(config.thread_local_clusters_.find(name) != config.thread_local_clusters_.end());
   const auto& cluster_entry = config.thread_local_clusters_[name];
   ENVOY_LOG(debug, "membership update for TLS cluster {}", name);
-  cluster_entry->priority_set_.getOrCreateHostSet(priority).updateHosts(
-      std::move(hosts), std::move(healthy_hosts), std::move(hosts_per_locality),
-      std::move(healthy_hosts_per_locality), hosts_added, hosts_removed);
+  cluster_entry->priority_set_.getOrCreateHostSet(update.priority_)
+      .updateHosts(update.hosts_, update.healthy_hosts_, update.hosts_per_locality_,
+                   update.healthy_hosts_per_locality_, update.hosts_added_, update.hosts_removed_);
 
   // If an LB is thread aware, create a new worker local LB on membership changes.
   if (cluster_entry->lb_factory_ != nullptr) {
@@ -795,8 +782,10 @@ Http::ConnectionPool::InstancePtr ProdClusterManagerFactory::allocateConnPool(
     Http::Protocol protocol, const Network::ConnectionSocket::OptionsSharedPtr& options) {
   if (protocol == Http::Protocol::Http2 &&
       runtime_.snapshot().featureEnabled("upstream.use_http2", 100)) {
-    return Http::ConnectionPool::InstancePtr{
-        new Http::Http2::ProdConnPoolImpl(dispatcher, host, priority, options)};
+    const uint32_t max_active_clients = std::max<uint64_t>(
+        1, runtime_.snapshot().getInteger("upstream.http2.max_connections_per_host", 1));
+    return Http::ConnectionPool::InstancePtr{new Http::Http2::ProdConnPoolImpl(
+        dispatcher, host, priority, options, max_active_clients)};
   } else {
     return Http::ConnectionPool::InstancePtr{
         new Http::Http1::ConnPoolImplProd(dispatcher, host, priority, options)};
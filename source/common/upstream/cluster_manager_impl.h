@@ -190,6 +190,31 @@ public:
   const std::string& localClusterName() const override { return local_cluster_name_; }
 
 private:
+  /**
+   * A membership update of one priority of a primary cluster. The host lists are the primary host
+   * set's own immutable lists, so the update is built once on the main thread without copying
+   * any hosts and every worker shares it through a single reference.
+   */
+  struct HostSetUpdate {
+    HostSetUpdate(const HostSet& host_set, const HostVector& hosts_added,
+                  const HostVector& hosts_removed)
+        : priority_(host_set.priority()), hosts_(host_set.hostsPtr()),
+          healthy_hosts_(host_set.healthyHostsPtr()),
+          hosts_per_locality_(host_set.hostsPerLocalityPtr()),
+          healthy_hosts_per_locality_(host_set.healthyHostsPerLocalityPtr()),
+          hosts_added_(hosts_added), hosts_removed_(hosts_removed) {}
+
+    const uint32_t priority_;
+    const HostVectorConstSharedPtr hosts_;
+    const HostVectorConstSharedPtr healthy_hosts_;
+    const HostsPerLocalityConstSharedPtr hosts_per_locality_;
+    const HostsPerLocalityConstSharedPtr healthy_hosts_per_locality_;
+    const HostVector hosts_added_;
+    const HostVector hosts_removed_;
+  };
+
+  typedef std::shared_ptr<const HostSetUpdate> HostSetUpdateConstSharedPtr;
+
   /**
    * Thread local cached cluster data. Each thread local cluster gets updates from the parent
    * central dynamic cluster (if applicable). It maintains load balancer state and any created
@@ -245,13 +270,8 @@ private:
     ~ThreadLocalClusterManagerImpl();
     void drainConnPools(const HostVector& hosts);
     void drainConnPools(HostSharedPtr old_host, ConnPoolsContainer& container);
-    static void updateClusterMembership(const std::string& name, uint32_t priority,
-                                        HostVectorConstSharedPtr hosts,
-                                        HostVectorConstSharedPtr healthy_hosts,
-                                        HostsPerLocalityConstSharedPtr hosts_per_locality,
-                                        HostsPerLocalityConstSharedPtr healthy_hosts_per_locality,
-                                        const HostVector& hosts_added,
-                                        const HostVector& hosts_removed, ThreadLocal::Slot& tls);
+    static void updateClusterMembership(const std::string& name, const HostSetUpdate& update,
+                                        ThreadLocal::Slot& tls);
     static void onHostHealthFailure(const HostSharedPtr& host, ThreadLocal::Slot& tls);
 
     ClusterManagerImpl& parent_;
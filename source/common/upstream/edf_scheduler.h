@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <queue>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Earliest Deadline First (EDF) scheduler
+ * (https://en.wikipedia.org/wiki/Earliest_deadline_first_scheduling) used for weighted host
+ * selection. Each entry is added with a weight and gets a deadline of 1/weight past the current
+ * time. pick() removes and returns the entry with the earliest deadline, advancing the current
+ * time to it, and the caller adds the entry back with its (possibly new) weight. Over time each
+ * entry is picked in proportion to its weight, interleaved rather than in bursts. pick() and
+ * add() are O(log n).
+ *
+ * Entries are held by weak pointer, so an entry whose object has been destroyed is dropped the next
+ * time it reaches the front of the queue.
+ */
+template <class C> class EdfScheduler {
+public:
+  /**
+   * Remove and return the entry with the earliest deadline.
+   * @return std::shared_ptr<C> the entry, or nullptr if the scheduler is empty.
+   */
+  std::shared_ptr<C> pick() {
+    while (!queue_.empty()) {
+      const EdfEntry& edf_entry = queue_.top();
+      std::shared_ptr<C> ret = edf_entry.entry_.lock();
+      current_time_ = edf_entry.deadline_;
+      queue_.pop();
+      if (ret != nullptr) {
+        return ret;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * Add an entry to the scheduler.
+   * @param weight supplies the entry's weight, which must be greater than 0.
+   * @param entry supplies the entry.
+   */
+  void add(double weight, std::shared_ptr<C> entry) {
+    ASSERT(weight > 0);
+    queue_.push({current_time_ + 1.0 / weight, order_offset_++, entry});
+  }
+
+  /**
+   * @return bool whether the scheduler has no entries.
+   */
+  bool empty() const { return queue_.empty(); }
+
+private:
+  struct EdfEntry {
+    double deadline_;
+    // Breaks deadline ties in insertion order, so that equally weighted entries are picked in
+    // round robin order.
+    uint64_t order_offset_;
+    std::weak_ptr<C> entry_;
+
+    // std::priority_queue is a max heap, so an entry is "less" when it is due later.
+    bool operator<(const EdfEntry& other) const {
+      return deadline_ == other.deadline_ ? order_offset_ > other.order_offset_
+                                          : deadline_ > other.deadline_;
+    }
+  };
+
+  double current_time_{};
+  uint64_t order_offset_{};
+  std::priority_queue<EdfEntry> queue_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
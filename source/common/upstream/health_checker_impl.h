@@ -394,6 +394,7 @@ private:
       // Allow the main HC infra to control timeout.
       return parent_.timeout_ * 2;
     }
+    uint32_t maxBufferSizeBeforeFlush() const override { return 0; }
 
     // Redis::ConnPool::PoolCallbacks
     void onResponse(Redis::RespValuePtr&& value) override;
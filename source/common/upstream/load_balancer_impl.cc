@@ -1,5 +1,6 @@
 #include "common/upstream/load_balancer_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -290,7 +291,7 @@ void ZoneAwareLoadBalancerBase::calculateLocalityPercentage(
   }
 }
 
-const HostVector& ZoneAwareLoadBalancerBase::tryChooseLocalLocalityHosts(const HostSet& host_set) {
+uint32_t ZoneAwareLoadBalancerBase::tryChooseLocalLocalityHosts(const HostSet& host_set) {
   PerPriorityState& state = *per_priority_state_[host_set.priority()];
   ASSERT(state.locality_routing_state_ != LocalityRoutingState::NoLocalityRouting);
 
@@ -302,7 +303,7 @@ const HostVector& ZoneAwareLoadBalancerBase::tryChooseLocalLocalityHosts(const H
   // Try to push all of the requests to the same locality first.
   if (state.locality_routing_state_ == LocalityRoutingState::LocalityDirect) {
     stats_.lb_zone_routing_all_directly_.inc();
-    return host_set.healthyHostsPerLocality().get()[0];
+    return 0;
   }
 
   ASSERT(state.locality_routing_state_ == LocalityRoutingState::LocalityResidual);
@@ -311,7 +312,7 @@ const HostVector& ZoneAwareLoadBalancerBase::tryChooseLocalLocalityHosts(const H
   // push to the local locality, check if we can push to local locality on current iteration.
   if (random_.random() % 10000 < state.local_percent_to_route_) {
     stats_.lb_zone_routing_sampled_.inc();
-    return host_set.healthyHostsPerLocality().get()[0];
+    return 0;
   }
 
   // At this point we must route cross locality as we cannot route to the local locality.
@@ -321,7 +322,7 @@ const HostVector& ZoneAwareLoadBalancerBase::tryChooseLocalLocalityHosts(const H
   // locality percentages. In this case just select random locality.
   if (state.residual_capacity_[number_of_localities - 1] == 0) {
     stats_.lb_zone_no_capacity_left_.inc();
-    return host_set.healthyHostsPerLocality().get()[random_.random() % number_of_localities];
+    return random_.random() % number_of_localities;
   }
 
   // Random sampling to select specific locality for cross locality traffic based on the additional
@@ -332,108 +333,145 @@ const HostVector& ZoneAwareLoadBalancerBase::tryChooseLocalLocalityHosts(const H
   // Linear scan should be faster for smaller N, in most of the scenarios N will be small.
   // TODO(htuch): is there a bug here when threshold == 0? Seems like we pick
   // local locality in that situation. Probably should start iterating at 1.
-  int i = 0;
+  uint32_t i = 0;
   while (threshold > state.residual_capacity_[i]) {
     i++;
   }
 
-  return host_set.healthyHostsPerLocality().get()[i];
+  return i;
 }
 
-const HostVector& ZoneAwareLoadBalancerBase::hostsToUse() {
+ZoneAwareLoadBalancerBase::HostsSource ZoneAwareLoadBalancerBase::hostSourceToUse() {
   const HostSet& host_set = chooseHostSet();
+  HostsSource hosts_source;
+  hosts_source.priority_ = host_set.priority();
 
   // If the selected host set has insufficient healthy hosts, return all hosts.
   if (isGlobalPanic(host_set)) {
     stats_.lb_healthy_panic_.inc();
-    return host_set.hosts();
+    hosts_source.source_type_ = HostsSource::SourceType::AllHosts;
+    return hosts_source;
   }
 
+  hosts_source.source_type_ = HostsSource::SourceType::HealthyHosts;
+
   // If we've latched that we can't do priority-based routing, return healthy hosts for the selected
   // host set.
   if (per_priority_state_[host_set.priority()]->locality_routing_state_ ==
       LocalityRoutingState::NoLocalityRouting) {
-    return host_set.healthyHosts();
+    return hosts_source;
   }
 
   // Determine if the load balancer should do zone based routing for this pick.
   if (!runtime_.snapshot().featureEnabled(RuntimeZoneEnabled, 100)) {
-    return host_set.healthyHosts();
+    return hosts_source;
   }
 
   if (isGlobalPanic(localHostSet())) {
     stats_.lb_local_cluster_not_ok_.inc();
     // If the local Envoy instances are in global panic, do not do locality
     // based routing.
-    return host_set.healthyHosts();
+    return hosts_source;
   }
 
-  return tryChooseLocalLocalityHosts(host_set);
+  hosts_source.source_type_ = HostsSource::SourceType::LocalityHealthyHosts;
+  hosts_source.locality_index_ = tryChooseLocalLocalityHosts(host_set);
+  return hosts_source;
 }
 
-HostConstSharedPtr RoundRobinLoadBalancer::chooseHost(LoadBalancerContext*) {
-  const HostVector& hosts_to_use = hostsToUse();
-  if (hosts_to_use.empty()) {
-    return nullptr;
+const HostVector&
+ZoneAwareLoadBalancerBase::hostSourceToHosts(const HostsSource& hosts_source) const {
+  const HostSet& host_set = *priority_set_.hostSetsPerPriority()[hosts_source.priority_];
+  switch (hosts_source.source_type_) {
+  case HostsSource::SourceType::AllHosts:
+    return host_set.hosts();
+  case HostsSource::SourceType::HealthyHosts:
+    return host_set.healthyHosts();
+  case HostsSource::SourceType::LocalityHealthyHosts:
+    return host_set.healthyHostsPerLocality().get()[hosts_source.locality_index_];
   }
-
-  return hosts_to_use[rr_index_++ % hosts_to_use.size()];
+  NOT_REACHED;
 }
 
-LeastRequestLoadBalancer::LeastRequestLoadBalancer(
+EdfLoadBalancerBase::EdfLoadBalancerBase(
     const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterStats& stats,
     Runtime::Loader& runtime, Runtime::RandomGenerator& random,
     const envoy::api::v2::Cluster::CommonLbConfig& common_config)
     : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
                                 common_config) {
+  // We fully recompute the schedulers of a host set on every update of it, which is consistent
+  // with how the other LB state is refreshed.
   priority_set.addMemberUpdateCb(
-      [this](uint32_t, const HostVector&, const HostVector& hosts_removed) -> void {
-        if (last_host_) {
-          for (const HostSharedPtr& host : hosts_removed) {
-            if (host == last_host_) {
-              hits_left_ = 0;
-              last_host_.reset();
-
-              break;
-            }
-          }
-        }
+      [this](uint32_t priority, const HostVector&, const HostVector&) -> void {
+        refresh(priority);
       });
 }
 
-HostConstSharedPtr LeastRequestLoadBalancer::chooseHost(LoadBalancerContext*) {
-  bool is_weight_imbalanced = stats_.max_host_weight_.value() != 1;
-  bool is_weight_enabled = runtime_.snapshot().getInteger("upstream.weight_enabled", 1UL) != 0;
+void EdfLoadBalancerBase::initialize() {
+  for (uint32_t priority = 0; priority < priority_set_.hostSetsPerPriority().size(); ++priority) {
+    refresh(priority);
+  }
+}
 
-  if (is_weight_imbalanced && hits_left_ > 0 && is_weight_enabled) {
-    --hits_left_;
+void EdfLoadBalancerBase::refresh(uint32_t priority) {
+  const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts) {
+    // Drop any existing scheduler for the source.
+    scheduler_.erase(source);
+    if (hosts.empty()) {
+      return;
+    }
+    // When all weights are equal the unweighted pick is already balanced and needs no state.
+    const uint32_t weight = hosts[0]->weight();
+    if (std::all_of(hosts.begin(), hosts.end(),
+                    [weight](const HostSharedPtr& host) { return host->weight() == weight; })) {
+      return;
+    }
+    auto& scheduler = scheduler_[source];
+    scheduler.reset(new EdfScheduler<const Host>());
+    for (const auto& host : hosts) {
+      scheduler->add(hostWeight(*host), host);
+    }
+  };
+
+  const HostSet& host_set = *priority_set_.hostSetsPerPriority()[priority];
+  add_hosts_source(HostsSource(priority, HostsSource::SourceType::AllHosts), host_set.hosts());
+  add_hosts_source(HostsSource(priority, HostsSource::SourceType::HealthyHosts),
+                   host_set.healthyHosts());
+  const auto& healthy_hosts_per_locality = host_set.healthyHostsPerLocality().get();
+  for (uint32_t locality_index = 0; locality_index < healthy_hosts_per_locality.size();
+       ++locality_index) {
+    add_hosts_source(
+        HostsSource(priority, HostsSource::SourceType::LocalityHealthyHosts, locality_index),
+        healthy_hosts_per_locality[locality_index]);
+  }
+}
 
-    return last_host_;
-  } else {
-    // To avoid hit stale last_host_ when all hosts become weight balanced.
-    hits_left_ = 0;
-    last_host_.reset();
+HostConstSharedPtr EdfLoadBalancerBase::chooseHostFromSource() {
+  const HostsSource hosts_source = hostSourceToUse();
+  auto scheduler = scheduler_.find(hosts_source);
+  if (scheduler != scheduler_.end()) {
+    HostConstSharedPtr host = scheduler->second->pick();
+    if (host != nullptr) {
+      scheduler->second->add(hostWeight(*host), host);
+      return host;
+    }
   }
 
-  const HostVector& hosts_to_use = hostsToUse();
+  const HostVector& hosts_to_use = hostSourceToHosts(hosts_source);
   if (hosts_to_use.empty()) {
     return nullptr;
   }
+  return unweightedHostPick(hosts_to_use, hosts_source);
+}
 
-  // Make weighed random if we have hosts with non 1 weights.
-  if (is_weight_imbalanced & is_weight_enabled) {
-    last_host_ = hosts_to_use[random_.random() % hosts_to_use.size()];
-    hits_left_ = last_host_->weight() - 1;
-
-    return last_host_;
+HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector& hosts_to_use,
+                                                                const HostsSource&) {
+  HostSharedPtr host1 = hosts_to_use[random_.random() % hosts_to_use.size()];
+  HostSharedPtr host2 = hosts_to_use[random_.random() % hosts_to_use.size()];
+  if (host1->stats().rq_active_.value() < host2->stats().rq_active_.value()) {
+    return host1;
   } else {
-    HostSharedPtr host1 = hosts_to_use[random_.random() % hosts_to_use.size()];
-    HostSharedPtr host2 = hosts_to_use[random_.random() % hosts_to_use.size()];
-    if (host1->stats().rq_active_.value() < host2->stats().rq_active_.value()) {
-      return host1;
-    } else {
-      return host2;
-    }
+    return host2;
   }
 }
 
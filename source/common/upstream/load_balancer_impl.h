@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "envoy/api/v2/cds.pb.h"
@@ -9,6 +11,8 @@
 #include "envoy/upstream/load_balancer.h"
 #include "envoy/upstream/upstream.h"
 
+#include "common/upstream/edf_scheduler.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -63,6 +67,40 @@ protected:
  */
 class ZoneAwareLoadBalancerBase : public LoadBalancerBase {
 protected:
+  /**
+   * Identifies one of the host lists of a host set that hosts can be picked from.
+   */
+  struct HostsSource {
+    enum class SourceType {
+      // All hosts of the host set.
+      AllHosts,
+      // The healthy hosts of the host set.
+      HealthyHosts,
+      // The healthy hosts of one locality of the host set.
+      LocalityHealthyHosts,
+    };
+
+    HostsSource() {}
+    HostsSource(uint32_t priority, SourceType source_type, uint32_t locality_index = 0)
+        : priority_(priority), source_type_(source_type), locality_index_(locality_index) {}
+
+    bool operator==(const HostsSource& other) const {
+      return priority_ == other.priority_ && source_type_ == other.source_type_ &&
+             locality_index_ == other.locality_index_;
+    }
+
+    uint32_t priority_{};
+    SourceType source_type_{SourceType::AllHosts};
+    uint32_t locality_index_{};
+  };
+
+  struct HostsSourceHash {
+    size_t operator()(const HostsSource& hosts_source) const {
+      return (static_cast<size_t>(hosts_source.priority_) << 34) ^
+             (static_cast<size_t>(hosts_source.source_type_) << 32) ^ hosts_source.locality_index_;
+    }
+  };
+
   // Both priority_set and local_priority_set if non-null must have at least one host set.
   ZoneAwareLoadBalancerBase(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
                             ClusterStats& stats, Runtime::Loader& runtime,
@@ -73,7 +111,17 @@ protected:
   /**
    * Pick the host list to use, doing zone aware routing when the hosts are sufficiently healthy.
    */
-  const HostVector& hostsToUse();
+  HostsSource hostSourceToUse();
+
+  /**
+   * @return const HostVector& the host list identified by hosts_source.
+   */
+  const HostVector& hostSourceToHosts(const HostsSource& hosts_source) const;
+
+  /**
+   * Shorthand for hostSourceToHosts(hostSourceToUse()).
+   */
+  const HostVector& hostsToUse() { return hostSourceToHosts(hostSourceToUse()); }
 
 private:
   enum class LocalityRoutingState {
@@ -100,8 +148,9 @@ private:
   /**
    * Try to select upstream hosts from the same locality.
    * @param host_set the last host set returned by chooseHostSet()
+   * @return uint32_t the index of the locality in host_set.healthyHostsPerLocality().
    */
-  const HostVector& tryChooseLocalLocalityHosts(const HostSet& host_set);
+  uint32_t tryChooseLocalLocalityHosts(const HostSet& host_set);
 
   /**
    * @return (number of hosts in a given locality)/(total number of hosts) in ret param.
@@ -137,50 +186,111 @@ private:
 };
 
 /**
- * Implementation of LoadBalancer that performs RR selection across the hosts in the cluster.
+ * Base class for load balancers that pick weighted hosts with an EdfScheduler. A scheduler is
+ * built for every host list that hostSourceToUse() can return when a host set changes, so a pick
+ * costs O(log n) in the number of hosts and the scheduler holds one entry per host whatever its
+ * weight. Host lists whose hosts all have the same weight get no scheduler and are picked from by
+ * unweightedHostPick() instead.
  */
-class RoundRobinLoadBalancer : public LoadBalancer, ZoneAwareLoadBalancerBase {
+class EdfLoadBalancerBase : public ZoneAwareLoadBalancerBase {
+protected:
+  EdfLoadBalancerBase(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
+                      ClusterStats& stats, Runtime::Loader& runtime,
+                      Runtime::RandomGenerator& random,
+                      const envoy::api::v2::Cluster::CommonLbConfig& common_config);
+
+  /**
+   * Build the schedulers for the current host sets. Must be called by the derived class
+   * constructor, as the schedulers depend on hostWeight().
+   */
+  void initialize();
+
+  /**
+   * Pick a host from the host list chosen by hostSourceToUse().
+   * @return HostConstSharedPtr the host, or nullptr if the list is empty.
+   */
+  HostConstSharedPtr chooseHostFromSource();
+
+private:
+  void refresh(uint32_t priority);
+  /**
+   * @return double the weight a host is scheduled with when it is (re)added to a scheduler.
+   */
+  virtual double hostWeight(const Host& host) PURE;
+  /**
+   * Pick a host from a non-empty host list whose hosts all have the same weight.
+   */
+  virtual HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
+                                                const HostsSource& hosts_source) PURE;
+
+  // Scheduler for each host list with unequal host weights.
+  std::unordered_map<HostsSource, std::unique_ptr<EdfScheduler<const Host>>, HostsSourceHash>
+      scheduler_;
+};
+
+/**
+ * Implementation of LoadBalancer that performs RR selection across the hosts in the cluster. Hosts
+ * with different weights are picked by an EDF scheduler in proportion to their weights, holding
+ * one scheduler entry per host.
+ */
+class RoundRobinLoadBalancer : public LoadBalancer, EdfLoadBalancerBase {
 public:
   RoundRobinLoadBalancer(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
                          ClusterStats& stats, Runtime::Loader& runtime,
                          Runtime::RandomGenerator& random,
                          const envoy::api::v2::Cluster::CommonLbConfig& common_config)
-      : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
-                                  common_config) {}
+      : EdfLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
+                            common_config) {
+    initialize();
+  }
 
   // Upstream::LoadBalancer
-  HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
+  HostConstSharedPtr chooseHost(LoadBalancerContext*) override { return chooseHostFromSource(); }
 
 private:
+  // EdfLoadBalancerBase
+  double hostWeight(const Host& host) override { return host.weight(); }
+  HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
+                                        const HostsSource&) override {
+    return hosts_to_use[rr_index_++ % hosts_to_use.size()];
+  }
+
   size_t rr_index_{};
 };
 
 /**
  * Weighted Least Request load balancer.
  *
- * In a normal setup when all hosts have the same weight of 1 it randomly picks up two healthy hosts
+ * In a normal setup when all hosts have the same weight it randomly picks up two healthy hosts
  * and compares number of active requests.
  * Technique is based on http://www.eecs.harvard.edu/~michaelm/postscripts/mythesis.pdf
  *
- * When any of the hosts have non 1 weight, apply random weighted balancing.
- * Randomly pickup the host and send 'weight' number of requests to it.
- * This technique is acceptable for load testing but
- * will not work well in situations where requests take a long time.
- * In that case a different algorithm using a full scan will be required.
+ * When hosts have different weights, hosts are picked by an EDF scheduler in which a host is
+ * rescheduled after each pick with its weight divided by its number of active requests plus one.
+ * Hosts thus receive requests in proportion to their weight while they complete them at the same
+ * rate, and less when they fall behind.
  */
-class LeastRequestLoadBalancer : public LoadBalancer, ZoneAwareLoadBalancerBase {
+class LeastRequestLoadBalancer : public LoadBalancer, EdfLoadBalancerBase {
 public:
   LeastRequestLoadBalancer(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
                            ClusterStats& stats, Runtime::Loader& runtime,
                            Runtime::RandomGenerator& random,
-                           const envoy::api::v2::Cluster::CommonLbConfig& common_config);
+                           const envoy::api::v2::Cluster::CommonLbConfig& common_config)
+      : EdfLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
+                            common_config) {
+    initialize();
+  }
 
   // Upstream::LoadBalancer
-  HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
+  HostConstSharedPtr chooseHost(LoadBalancerContext*) override { return chooseHostFromSource(); }
 
 private:
-  HostSharedPtr last_host_;
-  uint32_t hits_left_{};
+  // EdfLoadBalancerBase
+  double hostWeight(const Host& host) override {
+    return static_cast<double>(host.weight()) / (host.stats().rq_active_.value() + 1);
+  }
+  HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
+                                        const HostsSource& hosts_source) override;
 };
 
 /**
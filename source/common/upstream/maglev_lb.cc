@@ -53,7 +53,7 @@ HostConstSharedPtr MaglevTable::chooseHost(uint64_t hash) const {
     return nullptr;
   }
 
-  return table_[hash % table_size_];
+  return table_[candidateIndex(hash)];
 }
 
 uint64_t MaglevTable::permutation(const TableBuildEntry& entry) {
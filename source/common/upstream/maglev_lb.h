@@ -18,6 +18,10 @@ public:
 
   // ThreadAwareLoadBalancerBase::HashingLoadBalancer
   HostConstSharedPtr chooseHost(uint64_t hash) const override;
+  uint64_t candidateCount() const override { return table_.size(); }
+  // Hosts are interleaved through the table, so the following entries are the next candidates.
+  uint64_t candidateIndex(uint64_t hash) const override { return hash % table_size_; }
+  const HostSharedPtr& candidate(uint64_t index) const override { return table_[index]; }
 
   // Recommended table size in section 5.3 of the paper.
   static const uint64_t DefaultTableSize = 65537;
@@ -51,7 +55,8 @@ public:
 
 private:
   // ThreadAwareLoadBalancerBase
-  HashingLoadBalancerSharedPtr createLoadBalancer(const HostVector& hosts) override {
+  HashingLoadBalancerSharedPtr createLoadBalancer(const HostVector& hosts,
+                                                  const HashingLoadBalancer*) override {
     return std::make_shared<MaglevTable>(hosts, table_size_);
   }
 
@@ -1,7 +1,10 @@
 #include "common/upstream/ring_hash_lb.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "common/common/assert.h"
@@ -12,6 +15,17 @@
 namespace Envoy {
 namespace Upstream {
 
+namespace {
+
+// The radix sort takes 11 bits of the hash per pass, which keeps the counts of a pass in 16KiB and
+// sorts 64 bit hashes in 6 passes.
+constexpr uint32_t RadixBits = 11;
+constexpr uint64_t RadixMask = (1 << RadixBits) - 1;
+// Below this many entries a comparison sort is faster than the radix sort passes.
+constexpr size_t RadixSortMinEntries = 4096;
+
+} // namespace
+
 RingHashLoadBalancer::RingHashLoadBalancer(
     PrioritySet& priority_set, ClusterStats& stats, Runtime::Loader& runtime,
     Runtime::RandomGenerator& random,
@@ -21,28 +35,32 @@ RingHashLoadBalancer::RingHashLoadBalancer(
       config_(config) {}
 
 HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h) const {
-  if (ring_.empty()) {
+  if (hashes_.empty()) {
     return nullptr;
   }
 
+  return candidate(candidateIndex(h));
+}
+
+uint64_t RingHashLoadBalancer::Ring::candidateIndex(uint64_t h) const {
   // Ported from https://github.com/RJ/ketama/blob/master/libketama/ketama.c (ketama_get_server)
   // I've generally kept the variable names to make the code easier to compare.
   // NOTE: The algorithm depends on using signed integers for lowp, midp, and highp. Do not
   //       change them!
   int64_t lowp = 0;
-  int64_t highp = ring_.size();
+  int64_t highp = hashes_.size();
   while (true) {
     int64_t midp = (lowp + highp) / 2;
 
-    if (midp == static_cast<int64_t>(ring_.size())) {
-      return ring_[0].host_;
+    if (midp == static_cast<int64_t>(hashes_.size())) {
+      return 0;
     }
 
-    uint64_t midval = ring_[midp].hash_;
-    uint64_t midval1 = midp == 0 ? 0 : ring_[midp - 1].hash_;
+    uint64_t midval = hashes_[midp];
+    uint64_t midval1 = midp == 0 ? 0 : hashes_[midp - 1];
 
     if (h <= midval && h > midval1) {
-      return ring_[midp].host_;
+      return midp;
     }
 
     if (midval < h) {
@@ -52,13 +70,14 @@ HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h) const {
     }
 
     if (lowp > highp) {
-      return ring_[0].host_;
+      return 0;
     }
   }
 }
 
 RingHashLoadBalancer::Ring::Ring(const Optional<envoy::api::v2::Cluster::RingHashLbConfig>& config,
-                                 const HostVector& hosts) {
+                                 const HostVector& hosts, const Ring* previous)
+    : hosts_(hosts) {
   ENVOY_LOG(trace, "ring hash: building ring");
   if (hosts.empty()) {
     return;
@@ -67,71 +86,174 @@ RingHashLoadBalancer::Ring::Ring(const Optional<envoy::api::v2::Cluster::RingHas
   // Currently we specify the minimum size of the ring, and determine the replication factor
   // based on the number of hosts. It's possible we might want to support more sophisticated
   // configuration in the future.
-  // NOTE: Currently we keep a ring for healthy hosts and unhealthy hosts, and this is done per
-  //       thread. This is the simplest implementation, but it's expensive from a memory
-  //       standpoint and duplicates the regeneration computation. In the future we might want
-  //       to generate the rings centrally and then just RCU them out to each thread. This is
-  //       sufficient for getting started.
+  // NOTE: Currently we keep a ring for healthy hosts and unhealthy hosts. The rings are built on
+  //       the main thread and shared with the workers.
   const uint64_t min_ring_size =
       config.valid() ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.value(), minimum_ring_size, 1024)
                      : 1024;
 
-  uint64_t hashes_per_host = 1;
+  hashes_per_host_ = 1;
   if (hosts.size() < min_ring_size) {
-    hashes_per_host = min_ring_size / hosts.size();
+    hashes_per_host_ = min_ring_size / hosts.size();
     if ((min_ring_size % hosts.size()) != 0) {
-      hashes_per_host++;
+      hashes_per_host_++;
     }
   }
 
-  ENVOY_LOG(info, "ring hash: min_ring_size={} hashes_per_host={}", min_ring_size, hashes_per_host);
-  ring_.reserve(hosts.size() * hashes_per_host);
+  ENVOY_LOG(info, "ring hash: min_ring_size={} hashes_per_host={}", min_ring_size,
+            hashes_per_host_);
 
   const bool use_std_hash =
       config.valid()
           ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.value().deprecated_v1(), use_std_hash, true)
           : true;
 
-  char hash_key_buffer[196];
-  for (const auto& host : hosts) {
-    const std::string& address_string = host->address()->asString();
-    uint64_t offset_start = address_string.size();
-
-    // Currently, we support both IP and UDS addresses. The UDS max path length is ~108 on all Unix
-    // platforms that I know of. Given that, we can use a 196 char buffer which is plenty of room
-    // for UDS, '_', and up to 21 characters for the node ID. To be on the super safe side, there
-    // is a RELEASE_ASSERT here that checks this, in case someone in the future adds some type of
-    // new address that is larger, or runs on a platform where UDS is larger. I don't think it's
-    // worth the defensive coding to deal with the heap allocation case (e.g. via
-    // absl::InlinedVector) at the current time.
-    RELEASE_ASSERT(address_string.size() + 1 + StringUtil::MIN_ITOA_OUT_LEN <=
-                   sizeof(hash_key_buffer));
-    memcpy(hash_key_buffer, address_string.c_str(), offset_start);
-    hash_key_buffer[offset_start++] = '_';
-    for (uint64_t i = 0; i < hashes_per_host; i++) {
-      const uint64_t total_hash_key_len =
-          offset_start +
-          StringUtil::itoa(hash_key_buffer + offset_start, StringUtil::MIN_ITOA_OUT_LEN, i);
-      absl::string_view hash_key(hash_key_buffer, total_hash_key_len);
-
-      // Sadly std::hash provides no mechanism for hashing arbitrary bytes so we must copy here.
-      // xxHash is done wihout copies.
-      const uint64_t hash = use_std_hash ? std::hash<std::string>()(std::string(hash_key))
-                                         : HashUtil::xxHash64(hash_key);
-      ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key.data(), hash);
-      ring_.push_back({hash, host});
-    }
+  // The hashes of a host only depend on its address and the number of hashes per host, so the
+  // entries of the previous ring remain valid for the hosts that are still present.
+  if (previous != nullptr && !previous->hashes_.empty() &&
+      previous->hashes_per_host_ == hashes_per_host_) {
+    buildFromPrevious(*previous, use_std_hash);
+  } else {
+    buildFromScratch(use_std_hash);
   }
 
-  std::sort(ring_.begin(), ring_.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
-    return lhs.hash_ < rhs.hash_;
-  });
 #ifndef NVLOG
-  for (auto entry : ring_) {
-    ENVOY_LOG(trace, "ring hash: host={} hash={}", entry.host_->address()->asString(), entry.hash_);
+  for (uint64_t i = 0; i < hashes_.size(); i++) {
+    ENVOY_LOG(trace, "ring hash: host={} hash={}", hosts_[host_indexes_[i]]->address()->asString(),
+              hashes_[i]);
   }
 #endif
 }
 
+void RingHashLoadBalancer::Ring::addHostEntries(uint32_t host_index, bool use_std_hash,
+                                                RingEntryVector& entries) const {
+  // The hash keys of a host are its address, '_' and the index of the hash. The key is built in
+  // place in a single string, so that neither hash function needs a copy of it.
+  std::string hash_key = hosts_[host_index]->address()->asString();
+  hash_key.push_back('_');
+  const size_t offset_start = hash_key.size();
+  char index_buffer[StringUtil::MIN_ITOA_OUT_LEN];
+  for (uint64_t i = 0; i < hashes_per_host_; i++) {
+    hash_key.resize(offset_start);
+    hash_key.append(index_buffer, StringUtil::itoa(index_buffer, sizeof(index_buffer), i));
+
+    const uint64_t hash =
+        use_std_hash ? std::hash<std::string>()(hash_key) : HashUtil::xxHash64(hash_key);
+    ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key, hash);
+    entries.push_back({hash, host_index});
+  }
+}
+
+void RingHashLoadBalancer::Ring::buildFromScratch(bool use_std_hash) {
+  RingEntryVector entries;
+  entries.reserve(hosts_.size() * hashes_per_host_);
+  for (uint32_t host_index = 0; host_index < hosts_.size(); host_index++) {
+    addHostEntries(host_index, use_std_hash, entries);
+  }
+
+  sortEntries(entries);
+  setEntries(entries);
+}
+
+void RingHashLoadBalancer::Ring::buildFromPrevious(const Ring& previous, bool use_std_hash) {
+  static const uint32_t RemovedHost = std::numeric_limits<uint32_t>::max();
+
+  // Map the host indexes of the previous ring to this ring's. Hosts are matched by identity, as
+  // membership updates keep the host objects of hosts that are still present.
+  std::unordered_map<const Host*, uint32_t> added_hosts;
+  added_hosts.reserve(hosts_.size());
+  for (uint32_t host_index = 0; host_index < hosts_.size(); host_index++) {
+    added_hosts.emplace(hosts_[host_index].get(), host_index);
+  }
+  std::vector<uint32_t> host_index_map(previous.hosts_.size(), RemovedHost);
+  for (uint32_t host_index = 0; host_index < previous.hosts_.size(); host_index++) {
+    auto it = added_hosts.find(previous.hosts_[host_index].get());
+    if (it != added_hosts.end()) {
+      host_index_map[host_index] = it->second;
+      added_hosts.erase(it);
+    }
+  }
+
+  // Only the hosts left in added_hosts need to be hashed. Hash them in host order so that the
+  // ring does not depend on the map's iteration order.
+  std::vector<uint32_t> added_host_indexes;
+  added_host_indexes.reserve(added_hosts.size());
+  for (const auto& added_host : added_hosts) {
+    added_host_indexes.push_back(added_host.second);
+  }
+  std::sort(added_host_indexes.begin(), added_host_indexes.end());
+  RingEntryVector added_entries;
+  added_entries.reserve(added_host_indexes.size() * hashes_per_host_);
+  for (uint32_t host_index : added_host_indexes) {
+    addHostEntries(host_index, use_std_hash, added_entries);
+  }
+  sortEntries(added_entries);
+
+  // Merge the entries of the remaining hosts, which are already sorted, with the added entries.
+  hashes_.reserve(hosts_.size() * hashes_per_host_);
+  host_indexes_.reserve(hosts_.size() * hashes_per_host_);
+  auto added_entry = added_entries.begin();
+  for (uint64_t i = 0; i < previous.hashes_.size(); i++) {
+    const uint32_t host_index = host_index_map[previous.host_indexes_[i]];
+    if (host_index == RemovedHost) {
+      continue;
+    }
+    for (; added_entry != added_entries.end() && added_entry->hash_ < previous.hashes_[i];
+         ++added_entry) {
+      hashes_.push_back(added_entry->hash_);
+      host_indexes_.push_back(added_entry->host_index_);
+    }
+    hashes_.push_back(previous.hashes_[i]);
+    host_indexes_.push_back(host_index);
+  }
+  for (; added_entry != added_entries.end(); ++added_entry) {
+    hashes_.push_back(added_entry->hash_);
+    host_indexes_.push_back(added_entry->host_index_);
+  }
+}
+
+void RingHashLoadBalancer::Ring::setEntries(const RingEntryVector& entries) {
+  hashes_.reserve(entries.size());
+  host_indexes_.reserve(entries.size());
+  for (const RingEntry& entry : entries) {
+    hashes_.push_back(entry.hash_);
+    host_indexes_.push_back(entry.host_index_);
+  }
+}
+
+void RingHashLoadBalancer::sortEntries(RingEntryVector& entries) {
+  if (entries.size() < RadixSortMinEntries) {
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
+                       return lhs.hash_ < rhs.hash_;
+                     });
+    return;
+  }
+
+  RingEntryVector sorted(entries.size());
+  std::vector<uint64_t> offsets(RadixMask + 1);
+  for (uint32_t shift = 0; shift < 64; shift += RadixBits) {
+    std::fill(offsets.begin(), offsets.end(), 0);
+    for (const RingEntry& entry : entries) {
+      offsets[(entry.hash_ >> shift) & RadixMask]++;
+    }
+    // Skip a pass in which every entry has the same digit, as it would not move any entry.
+    if (offsets[(entries[0].hash_ >> shift) & RadixMask] == entries.size()) {
+      continue;
+    }
+
+    uint64_t offset = 0;
+    for (uint64_t& digit_offset : offsets) {
+      const uint64_t count = digit_offset;
+      digit_offset = offset;
+      offset += count;
+    }
+    for (const RingEntry& entry : entries) {
+      sorted[offsets[(entry.hash_ >> shift) & RadixMask]++] = entry;
+    }
+    entries.swap(sorted);
+  }
+}
+
 } // namespace Upstream
 } // namespace Envoy
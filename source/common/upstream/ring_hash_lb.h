@@ -17,7 +17,10 @@ namespace Upstream {
  * In the future it would be nice to support:
  * 1) Weighting.
  * 2) Per-zone rings and optional zone aware routing (not all applications will want this).
- * 3) Max request fallback to support hot shards (not all applications will want this).
+ * Hot shards can be spread with the bounded load option of ThreadAwareLoadBalancerBase.
+ * Rings are built on the main thread and shared read-only with the workers. On a membership
+ * update the previous ring is reused where possible, so that the update only hashes the added
+ * hosts.
  */
 class RingHashLoadBalancer : public ThreadAwareLoadBalancerBase,
                              Logger::Loggable<Logger::Id::upstream> {
@@ -30,23 +33,58 @@ public:
 private:
   struct RingEntry {
     uint64_t hash_;
-    HostConstSharedPtr host_;
+    uint32_t host_index_;
   };
+  typedef std::vector<RingEntry> RingEntryVector;
 
+  /**
+   * The ring keeps the entry hashes apart from the entry hosts, so that the binary search of a
+   * lookup only reads the hashes, and refers to hosts by index into hosts_ rather than holding a
+   * shared pointer per entry, so that building a large ring does not copy a shared pointer per
+   * entry.
+   */
   struct Ring : public HashingLoadBalancer {
+    /**
+     * @param previous supplies the ring previously built for the same priority, or nullptr. When
+     *        it was built with the same number of hashes per host, its entries for hosts that are
+     *        still present are reused and only the entries of added hosts are hashed and sorted.
+     */
     Ring(const Optional<envoy::api::v2::Cluster::RingHashLbConfig>& config,
-         const HostVector& hosts);
+         const HostVector& hosts, const Ring* previous);
 
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
     HostConstSharedPtr chooseHost(uint64_t hash) const override;
+    uint64_t candidateCount() const override { return hashes_.size(); }
+    // The index of the ring entry that owns the hash. Later entries are clockwise on the ring.
+    uint64_t candidateIndex(uint64_t hash) const override;
+    const HostSharedPtr& candidate(uint64_t index) const override {
+      return hosts_[host_indexes_[index]];
+    }
 
-    std::vector<RingEntry> ring_;
+    // Append the entries of hosts_[host_index] to entries.
+    void addHostEntries(uint32_t host_index, bool use_std_hash, RingEntryVector& entries) const;
+    void buildFromScratch(bool use_std_hash);
+    void buildFromPrevious(const Ring& previous, bool use_std_hash);
+    void setEntries(const RingEntryVector& entries);
+
+    const HostVector hosts_;
+    uint64_t hashes_per_host_{};
+    std::vector<uint64_t> hashes_;
+    std::vector<uint32_t> host_indexes_;
   };
   typedef std::shared_ptr<const Ring> RingConstSharedPtr;
 
+  /**
+   * Sort ring entries by hash with an LSD radix sort, which is stable and, for the large number of
+   * uniformly distributed hashes in a ring, much faster than a comparison sort.
+   * @param entries supplies the entries to sort.
+   */
+  static void sortEntries(RingEntryVector& entries);
+
   // ThreadAwareLoadBalancerBase
-  HashingLoadBalancerSharedPtr createLoadBalancer(const HostVector& hosts) override {
-    return std::make_shared<Ring>(config_, hosts);
+  HashingLoadBalancerSharedPtr createLoadBalancer(const HostVector& hosts,
+                                                  const HashingLoadBalancer* previous_lb) override {
+    return std::make_shared<Ring>(config_, hosts, dynamic_cast<const Ring*>(previous_lb));
   }
 
   const Optional<envoy::api::v2::Cluster::RingHashLbConfig>& config_;
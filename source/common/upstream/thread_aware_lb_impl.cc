@@ -1,8 +1,16 @@
 #include "common/upstream/thread_aware_lb_impl.h"
 
+#include <algorithm>
+#include <array>
+#include <string>
+
 namespace Envoy {
 namespace Upstream {
 
+static const std::string RuntimeHashBalanceFactor = "upstream.consistent_hash.balance_factor";
+// The most hosts the bounded load walk checks before it falls back to the hash's own host.
+static const uint64_t MaxBoundedLoadHosts = 16;
+
 void ThreadAwareLoadBalancerBase::initialize() {
   // TODO(mattklein123): In the future, once initialized and the initial LB is built, it would be
   // better to use a background thread for computing LB updates. This has the substantial benefit
@@ -11,15 +19,19 @@ void ThreadAwareLoadBalancerBase::initialize() {
   // complicated initialization as the load balancer would need its own initialized callback. I
   // think the synchronous/asynchronous split is probably the best option.
   priority_set_.addMemberUpdateCb(
-      [this](uint32_t, const HostVector&, const HostVector&) -> void { refresh(); });
+      [this](uint32_t priority, const HostVector&, const HostVector&) -> void {
+        refresh(priority);
+      });
 
-  refresh();
+  refresh(Optional<uint32_t>());
 }
 
-void ThreadAwareLoadBalancerBase::refresh() {
+void ThreadAwareLoadBalancerBase::refresh(const Optional<uint32_t>& updated_priority) {
   auto per_priority_state_vector = std::make_shared<std::vector<PerPriorityStatePtr>>(
       priority_set_.hostSetsPerPriority().size());
   auto per_priority_load = std::make_shared<std::vector<uint32_t>>(per_priority_load_);
+  // Only this thread writes the factory's state, so it can be read here without the lock.
+  const auto previous_state_vector = factory_->per_priority_state_;
 
   // Note that we only compute global panic on host set refresh. Given that the runtime setting will
   // rarely change, this is a reasonable compromise to avoid creating extra LBs when we only
@@ -28,13 +40,24 @@ void ThreadAwareLoadBalancerBase::refresh() {
     const uint32_t priority = host_set->priority();
     (*per_priority_state_vector)[priority].reset(new PerPriorityState);
     const auto& per_priority_state = (*per_priority_state_vector)[priority];
-    if (isGlobalPanic(*host_set)) {
-      per_priority_state->current_lb_ = createLoadBalancer(host_set->hosts());
-      per_priority_state->global_panic_ = true;
-    } else {
-      per_priority_state->current_lb_ = createLoadBalancer(host_set->healthyHosts());
-      per_priority_state->global_panic_ = false;
+    const bool global_panic = isGlobalPanic(*host_set);
+    const HostVector& hosts = global_panic ? host_set->hosts() : host_set->healthyHosts();
+
+    const PerPriorityState* previous_state = nullptr;
+    if (previous_state_vector != nullptr && priority < previous_state_vector->size()) {
+      previous_state = (*previous_state_vector)[priority].get();
     }
+    if (previous_state != nullptr && updated_priority.valid() &&
+        updated_priority.value() != priority && previous_state->global_panic_ == global_panic) {
+      // The hosts of this priority did not change, so neither did its load balancer.
+      *per_priority_state = *previous_state;
+      continue;
+    }
+
+    per_priority_state->current_lb_ = createLoadBalancer(
+        hosts, previous_state != nullptr ? previous_state->current_lb_.get() : nullptr);
+    per_priority_state->host_count_ = hosts.size();
+    per_priority_state->global_panic_ = global_panic;
   }
 
   {
@@ -64,11 +87,67 @@ ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* c
   if (per_priority_state->global_panic_) {
     stats_.lb_healthy_panic_.inc();
   }
-  return per_priority_state->current_lb_->chooseHost(h);
+
+  const uint64_t balance_factor = runtime_.snapshot().getInteger(RuntimeHashBalanceFactor, 0);
+  if (balance_factor == 0) {
+    return per_priority_state->current_lb_->chooseHost(h);
+  }
+  return chooseHostWithBoundedLoad(*per_priority_state, h, balance_factor);
+}
+
+HostConstSharedPtr ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHostWithBoundedLoad(
+    const PerPriorityState& per_priority_state, uint64_t hash, uint64_t balance_factor) {
+  // A factor below 100% would leave no host within the bound.
+  balance_factor = std::max<uint64_t>(balance_factor, 100);
+  const uint64_t host_count = std::max<uint64_t>(per_priority_state.host_count_, 1);
+  // Hosts must stay below ceil(balance_factor% * average). The cluster's active requests are
+  // shared by all priorities, which at worst makes the bound looser for a non-zero priority.
+  const uint64_t total_rq_active = stats_.upstream_rq_active_.value() + 1;
+  const uint64_t max_host_rq_active =
+      (total_rq_active * balance_factor + 100 * host_count - 1) / (100 * host_count);
+
+  const HashingLoadBalancer& lb = *per_priority_state.current_lb_;
+  const uint64_t candidate_count = lb.candidateCount();
+  if (candidate_count == 0) {
+    return nullptr;
+  }
+  const uint64_t first_index = lb.candidateIndex(hash);
+  const HostSharedPtr& first_choice = lb.candidate(first_index);
+  if (first_choice->stats().rq_active_.value() < max_host_rq_active) {
+    return first_choice;
+  }
+  stats_.lb_hash_bounded_load_overflow_.inc();
+
+  // A host may own several consecutive candidates, so the walk steps through the following
+  // candidates and skips the hosts it has already checked. It ends once every host, or
+  // MaxBoundedLoadHosts hosts, have been checked, or the candidates start to repeat.
+  std::array<const Host*, MaxBoundedLoadHosts> checked;
+  checked[0] = first_choice.get();
+  uint64_t checked_count = 1;
+  const uint64_t max_checked = std::min(host_count, MaxBoundedLoadHosts);
+  uint64_t index = first_index;
+  for (uint64_t step = 1; step < candidate_count && checked_count < max_checked; step++) {
+    if (++index == candidate_count) {
+      index = 0;
+    }
+    const HostSharedPtr& host = lb.candidate(index);
+    if (std::find(checked.begin(), checked.begin() + checked_count, host.get()) !=
+        checked.begin() + checked_count) {
+      continue;
+    }
+    if (host->stats().rq_active_.value() < max_host_rq_active) {
+      return host;
+    }
+    stats_.lb_hash_bounded_load_overflow_.inc();
+    checked[checked_count++] = host.get();
+  }
+
+  // Every checked host is at the bound, so fall back to the hash's own host.
+  return first_choice;
 }
 
 LoadBalancerPtr ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::create() {
-  auto lb = std::make_unique<LoadBalancerImpl>(stats_, random_);
+  auto lb = std::make_unique<LoadBalancerImpl>(stats_, runtime_, random_);
 
   // We must protect current_lb_ via a RW lock since it is accessed and written to by multiple
   // threads. All complex processing has already been precalculated however.
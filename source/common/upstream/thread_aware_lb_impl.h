@@ -20,7 +20,32 @@ public:
   class HashingLoadBalancer {
   public:
     virtual ~HashingLoadBalancer() {}
+
+    /**
+     * @param hash supplies the hash of the request.
+     * @return HostConstSharedPtr the host of the hash, or nullptr if there are no hosts.
+     */
     virtual HostConstSharedPtr chooseHost(uint64_t hash) const PURE;
+
+    /**
+     * The candidates are the entries of the ring or table. The candidate at candidateIndex(hash)
+     * is the hash's own host, and the following indexes, wrapping around, are its next candidates
+     * for bounded load balancing. A host may own several candidates.
+     * @return uint64_t the number of candidates, 0 if there are no hosts.
+     */
+    virtual uint64_t candidateCount() const PURE;
+
+    /**
+     * @param hash supplies the hash of the request.
+     * @return uint64_t the index of the hash's own candidate. candidateCount() must not be 0.
+     */
+    virtual uint64_t candidateIndex(uint64_t hash) const PURE;
+
+    /**
+     * @param index supplies a candidate index below candidateCount().
+     * @return const HostSharedPtr& the candidate's host.
+     */
+    virtual const HostSharedPtr& candidate(uint64_t index) const PURE;
   };
   typedef std::shared_ptr<HashingLoadBalancer> HashingLoadBalancerSharedPtr;
 
@@ -33,36 +58,51 @@ protected:
                               Runtime::Loader& runtime, Runtime::RandomGenerator& random,
                               const envoy::api::v2::Cluster::CommonLbConfig& common_config)
       : LoadBalancerBase(priority_set, stats, runtime, random, common_config),
-        factory_(new LoadBalancerFactoryImpl(stats, random)) {}
+        factory_(new LoadBalancerFactoryImpl(stats, runtime, random)) {}
 
 private:
   struct PerPriorityState {
     std::shared_ptr<HashingLoadBalancer> current_lb_;
+    // Number of hosts current_lb_ was built from.
+    uint64_t host_count_{};
     bool global_panic_{};
   };
   typedef std::unique_ptr<PerPriorityState> PerPriorityStatePtr;
 
   struct LoadBalancerImpl : public LoadBalancer {
-    LoadBalancerImpl(ClusterStats& stats, Runtime::RandomGenerator& random)
-        : stats_(stats), random_(random) {}
+    LoadBalancerImpl(ClusterStats& stats, Runtime::Loader& runtime,
+                     Runtime::RandomGenerator& random)
+        : stats_(stats), runtime_(runtime), random_(random) {}
 
     // Upstream::LoadBalancer
     HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
 
+    /**
+     * Consistent hashing with bounded loads (https://arxiv.org/abs/1608.01350): walk the
+     * candidates for the hash until one has fewer active requests than balance_factor percent of
+     * the average, counting the request being routed. Each distinct host is checked once, and at
+     * most MaxBoundedLoadHosts hosts are checked.
+     */
+    HostConstSharedPtr chooseHostWithBoundedLoad(const PerPriorityState& per_priority_state,
+                                                 uint64_t hash, uint64_t balance_factor);
+
     ClusterStats& stats_;
+    Runtime::Loader& runtime_;
     Runtime::RandomGenerator& random_;
     std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_;
     std::shared_ptr<std::vector<uint32_t>> per_priority_load_;
   };
 
   struct LoadBalancerFactoryImpl : public LoadBalancerFactory {
-    LoadBalancerFactoryImpl(ClusterStats& stats, Runtime::RandomGenerator& random)
-        : stats_(stats), random_(random) {}
+    LoadBalancerFactoryImpl(ClusterStats& stats, Runtime::Loader& runtime,
+                            Runtime::RandomGenerator& random)
+        : stats_(stats), runtime_(runtime), random_(random) {}
 
     // Upstream::LoadBalancerFactory
     LoadBalancerPtr create() override;
 
     ClusterStats& stats_;
+    Runtime::Loader& runtime_;
     Runtime::RandomGenerator& random_;
     std::shared_timed_mutex mutex_;
     // TOOD(mattklein123): Added GUARDED_BY(mutex_) to to the following variables. OSX clang
@@ -73,8 +113,23 @@ private:
     std::shared_ptr<std::vector<uint32_t>> per_priority_load_;
   };
 
-  virtual HashingLoadBalancerSharedPtr createLoadBalancer(const HostVector& hosts) PURE;
-  void refresh();
+  /**
+   * Build the hashing load balancer for a host set.
+   * @param hosts supplies the hosts to build from.
+   * @param previous_lb supplies the load balancer previously built for the same priority, or
+   *        nullptr. It may still be in use by workers and must not be modified, but an
+   *        implementation can reuse its work when only a few hosts changed.
+   */
+  virtual HashingLoadBalancerSharedPtr
+  createLoadBalancer(const HostVector& hosts, const HashingLoadBalancer* previous_lb) PURE;
+
+  /**
+   * Rebuild the per priority state published to workers.
+   * @param updated_priority supplies the priority whose hosts changed. The load balancers of
+   *        other priorities are reused unless their panic state changed. If not valid, every
+   *        priority is rebuilt.
+   */
+  void refresh(const Optional<uint32_t>& updated_priority);
 
   std::shared_ptr<LoadBalancerFactoryImpl> factory_;
 };
@@ -522,6 +522,7 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const HostVector& new_hosts,
   // SDS implementation could do the same thing.
   std::unordered_set<std::string> host_addresses;
   HostVector final_hosts;
+  bool weight_changed = false;
   for (const HostSharedPtr& host : new_hosts) {
     if (host_addresses.count(host->address()->asString())) {
       continue;
@@ -537,7 +538,11 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const HostVector& new_hosts,
           max_host_weight = host->weight();
         }
 
-        (*i)->weight(host->weight());
+        // Load balancers that weight hosts need an update to see the new weight.
+        if ((*i)->weight() != host->weight()) {
+          (*i)->weight(host->weight());
+          weight_changed = true;
+        }
         final_hosts.push_back(*i);
         i = current_hosts.erase(i);
         found = true;
@@ -587,7 +592,7 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const HostVector& new_hosts,
     // During the search we moved all of the hosts from hosts_ into final_hosts so just
     // move them back.
     current_hosts = std::move(final_hosts);
-    return false;
+    return weight_changed;
   }
 }
 
@@ -230,6 +230,14 @@ public:
   const HostsPerLocality& healthyHostsPerLocality() const override {
     return *healthy_hosts_per_locality_;
   }
+  HostVectorConstSharedPtr hostsPtr() const override { return hosts_; }
+  HostVectorConstSharedPtr healthyHostsPtr() const override { return healthy_hosts_; }
+  HostsPerLocalityConstSharedPtr hostsPerLocalityPtr() const override {
+    return hosts_per_locality_;
+  }
+  HostsPerLocalityConstSharedPtr healthyHostsPerLocalityPtr() const override {
+    return healthy_hosts_per_locality_;
+  }
   uint32_t priority() const override { return priority_; }
 
 protected:
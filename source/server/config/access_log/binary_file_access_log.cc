@@ -0,0 +1,44 @@
+#include "server/config/access_log/binary_file_access_log.h"
+
+#include "envoy/common/exception.h"
+#include "envoy/config/filter/accesslog/v2/accesslog.pb.validate.h"
+#include "envoy/registry/registry.h"
+#include "envoy/server/filter_config.h"
+
+#include "common/access_log/binary_file_access_log_impl.h"
+#include "common/common/fmt.h"
+#include "common/config/well_known_names.h"
+#include "common/protobuf/protobuf.h"
+
+namespace Envoy {
+namespace Server {
+namespace Configuration {
+
+AccessLog::InstanceSharedPtr BinaryFileAccessLogFactory::createAccessLogInstance(
+    const Protobuf::Message& config, AccessLog::FilterPtr&& filter, FactoryContext& context) {
+  const auto& fal_config =
+      MessageUtil::downcastAndValidate<const envoy::config::filter::accesslog::v2::FileAccessLog&>(
+          config);
+  if (!fal_config.format().empty()) {
+    throw EnvoyException(fmt::format("{} does not support a format", name()));
+  }
+  return AccessLog::InstanceSharedPtr{new AccessLog::BinaryFileAccessLog(
+      fal_config.path(), std::move(filter), context.accessLogManager())};
+}
+
+ProtobufTypes::MessagePtr BinaryFileAccessLogFactory::createEmptyConfigProto() {
+  return ProtobufTypes::MessagePtr{new envoy::config::filter::accesslog::v2::FileAccessLog()};
+}
+
+std::string BinaryFileAccessLogFactory::name() const {
+  return Config::AccessLogNames::get().BINARY_FILE;
+}
+
+/**
+ * Static registration for the binary file access log. @see RegisterFactory.
+ */
+static Registry::RegisterFactory<BinaryFileAccessLogFactory, AccessLogInstanceFactory> register_;
+
+} // namespace Configuration
+} // namespace Server
+} // namespace Envoy
@@ -30,7 +30,8 @@ NetworkFilterFactoryCb RedisProxyFilterConfigFactory::createFilter(
   Redis::ConnPool::InstancePtr conn_pool(
       new Redis::ConnPool::InstanceImpl(filter_config->cluster_name_, context.clusterManager(),
                                         Redis::ConnPool::ClientFactoryImpl::instance_,
-                                        context.threadLocal(), proto_config.settings()));
+                                        context.threadLocal(), proto_config.settings(),
+                                        context.runtime()));
   std::shared_ptr<Redis::CommandSplitter::Instance> splitter(
       new Redis::CommandSplitter::InstanceImpl(std::move(conn_pool), context.scope(),
                                                filter_config->stat_prefix_));
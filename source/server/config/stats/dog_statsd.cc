@@ -21,8 +21,10 @@ Stats::SinkPtr DogStatsdSinkFactory::createStatsSink(const Protobuf::Message& co
   Network::Address::InstanceConstSharedPtr address =
       Network::Address::resolveProtoAddress(sink_config.address());
   ENVOY_LOG(debug, "dog_statsd UDP ip address: {}", address->asString());
-  return Stats::SinkPtr(
-      new Stats::Statsd::UdpStatsdSink(server.threadLocal(), std::move(address), true));
+  const uint64_t max_packet_bytes = server.runtime().snapshot().getInteger(
+      Stats::Statsd::UdpStatsdSink::MAX_PACKET_BYTES_RUNTIME_KEY, 0);
+  return Stats::SinkPtr(new Stats::Statsd::UdpStatsdSink(server.threadLocal(), std::move(address),
+                                                         true, max_packet_bytes));
 }
 
 ProtobufTypes::MessagePtr DogStatsdSinkFactory::createEmptyConfigProto() {
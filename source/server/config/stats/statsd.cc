@@ -24,8 +24,10 @@ Stats::SinkPtr StatsdSinkFactory::createStatsSink(const Protobuf::Message& confi
     Network::Address::InstanceConstSharedPtr address =
         Network::Address::resolveProtoAddress(statsd_sink.address());
     ENVOY_LOG(debug, "statsd UDP ip address: {}", address->asString());
-    return Stats::SinkPtr(
-        new Stats::Statsd::UdpStatsdSink(server.threadLocal(), std::move(address), false));
+    const uint64_t max_packet_bytes = server.runtime().snapshot().getInteger(
+        Stats::Statsd::UdpStatsdSink::MAX_PACKET_BYTES_RUNTIME_KEY, 0);
+    return Stats::SinkPtr(new Stats::Statsd::UdpStatsdSink(
+        server.threadLocal(), std::move(address), false, max_packet_bytes));
     break;
   }
   case envoy::config::metrics::v2::StatsdSink::kTcpClusterName:
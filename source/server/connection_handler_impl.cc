@@ -1,5 +1,8 @@
 #include "server/connection_handler_impl.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
 #include "envoy/network/filter.h"
@@ -11,13 +14,17 @@
 namespace Envoy {
 namespace Server {
 
-ConnectionHandlerImpl::ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher)
+ConnectionHandlerImpl::ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher,
+                                             uint64_t max_buffered_bytes)
     :
 #ifndef NVLOG
       logger_(logger),
 #endif
-      dispatcher_(dispatcher) {
+      dispatcher_(dispatcher), max_buffered_bytes_(max_buffered_bytes) {
   UNREFERENCED_PARAMETER(logger);
+  if (max_buffered_bytes_ > 0) {
+    buffer_overload_timer_ = dispatcher_.createTimer([this]() -> void { onBufferOverload(); });
+  }
 }
 
 void ConnectionHandlerImpl::addListener(Network::ListenerConfig& config) {
@@ -49,9 +56,65 @@ void ConnectionHandlerImpl::stopListeners() {
   }
 }
 
+void ConnectionHandlerImpl::chargeBufferedBytes(uint64_t bytes) {
+  buffered_bytes_ += bytes;
+  if (max_buffered_bytes_ > 0 && buffered_bytes_ > max_buffered_bytes_ &&
+      !buffer_overload_pending_) {
+    // Connections are not closed from inside the buffer operation that went over the limit. That
+    // happens on the next pass of the event loop.
+    buffer_overload_pending_ = true;
+    buffer_overload_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+}
+
+void ConnectionHandlerImpl::creditBufferedBytes(uint64_t bytes) {
+  ASSERT(buffered_bytes_ >= bytes);
+  buffered_bytes_ -= bytes;
+}
+
+void ConnectionHandlerImpl::onBufferOverload() {
+  buffer_overload_pending_ = false;
+  if (buffered_bytes_ <= max_buffered_bytes_) {
+    return;
+  }
+
+  // Collect the connections once and close them largest first from a heap. Closing a connection
+  // does not change the buffered bytes of the others, so the heap stays valid.
+  std::vector<ActiveConnection*> candidates;
+  for (auto& listener : listeners_) {
+    for (auto& connection : listener.second->connections_) {
+      if (connection->buffered_bytes_ > 0) {
+        candidates.push_back(connection.get());
+      }
+    }
+  }
+
+  const auto smaller = [](const ActiveConnection* lhs, const ActiveConnection* rhs) -> bool {
+    return lhs->buffered_bytes_ < rhs->buffered_bytes_;
+  };
+  std::make_heap(candidates.begin(), candidates.end(), smaller);
+  // If the candidates run out, the remaining bytes belong to connections that are already closed.
+  while (buffered_bytes_ > max_buffered_bytes_ && !candidates.empty()) {
+    std::pop_heap(candidates.begin(), candidates.end(), smaller);
+    ActiveConnection* largest = candidates.back();
+    candidates.pop_back();
+
+    ENVOY_CONN_LOG_TO_LOGGER(logger_, debug, "closing connection with {} buffered bytes: worker "
+                             "has {} buffered bytes (limit {})",
+                             *largest->connection_, largest->buffered_bytes_, buffered_bytes_,
+                             max_buffered_bytes_);
+    largest->listener_.stats_.downstream_cx_buffer_overload_reset_.inc();
+    // Closing the connection removes it from its listener and credits its buffered bytes.
+    largest->connection_->close(Network::ConnectionCloseType::NoFlush);
+  }
+}
+
 void ConnectionHandlerImpl::ActiveListener::removeConnection(ActiveConnection& connection) {
   ENVOY_CONN_LOG_TO_LOGGER(parent_.logger_, debug, "adding to cleanup list",
                            *connection.connection_);
+  // A closed connection stops charging its buffers. Whatever is left is credited now, as the
+  // connection is about to be deleted.
+  connection.credit(connection.buffered_bytes_);
   ActiveConnectionPtr removed = connection.removeFromList(connections_);
   parent_.dispatcher_.deferredDelete(std::move(removed));
   ASSERT(parent_.num_connections_ > 0);
@@ -219,6 +282,7 @@ ConnectionHandlerImpl::ActiveConnection::ActiveConnection(ActiveListener& listen
   // to make this configurable.
   connection_->noDelay(true);
   connection_->addConnectionCallbacks(*this);
+  connection_->setBufferMemoryAccount(this);
   listener_.stats_.downstream_cx_total_.inc();
   listener_.stats_.downstream_cx_active_.inc();
 }
@@ -229,6 +293,19 @@ ConnectionHandlerImpl::ActiveConnection::~ActiveConnection() {
   conn_length_->complete();
 }
 
+void ConnectionHandlerImpl::ActiveConnection::charge(uint64_t bytes) {
+  buffered_bytes_ += bytes;
+  listener_.stats_.downstream_cx_buffered_bytes_.add(bytes);
+  listener_.parent_.chargeBufferedBytes(bytes);
+}
+
+void ConnectionHandlerImpl::ActiveConnection::credit(uint64_t bytes) {
+  ASSERT(buffered_bytes_ >= bytes);
+  buffered_bytes_ -= bytes;
+  listener_.stats_.downstream_cx_buffered_bytes_.sub(bytes);
+  listener_.parent_.creditBufferedBytes(bytes);
+}
+
 ListenerStats ConnectionHandlerImpl::generateStats(Stats::Scope& scope) {
   return {ALL_LISTENER_STATS(POOL_COUNTER(scope), POOL_GAUGE(scope), POOL_HISTOGRAM(scope))};
 }
@@ -5,8 +5,10 @@
 #include <list>
 #include <memory>
 
+#include "envoy/buffer/buffer.h"
 #include "envoy/common/time.h"
 #include "envoy/event/deferred_deletable.h"
+#include "envoy/event/timer.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/connection_handler.h"
 #include "envoy/network/filter.h"
@@ -27,7 +29,9 @@ namespace Server {
 #define ALL_LISTENER_STATS(COUNTER, GAUGE, HISTOGRAM)                                              \
   COUNTER  (downstream_cx_total)                                                                   \
   COUNTER  (downstream_cx_destroy)                                                                 \
+  COUNTER  (downstream_cx_buffer_overload_reset)                                                   \
   GAUGE    (downstream_cx_active)                                                                  \
+  GAUGE    (downstream_cx_buffered_bytes)                                                          \
   HISTOGRAM(downstream_cx_length_ms)
 // clang-format on
 
@@ -41,10 +45,15 @@ struct ListenerStats {
 /**
  * Server side connection handler. This is used both by workers as well as the
  * main thread for non-threaded listeners.
+ *
+ * The bytes held in the read and write buffers of every connection are charged to the connection,
+ * its listener and the handler. If max_buffered_bytes is not zero and the handler's total goes over
+ * it, the connections holding the most buffered bytes are closed until the total is back under it.
  */
 class ConnectionHandlerImpl : public Network::ConnectionHandler, NonCopyable {
 public:
-  ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher);
+  ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher,
+                        uint64_t max_buffered_bytes = 0);
 
   // Network::ConnectionHandler
   uint64_t numConnections() override { return num_connections_; }
@@ -64,6 +73,10 @@ private:
   struct ActiveSocket;
   typedef std::unique_ptr<ActiveSocket> ActiveSocketPtr;
 
+  void chargeBufferedBytes(uint64_t bytes);
+  void creditBufferedBytes(uint64_t bytes);
+  void onBufferOverload();
+
   /**
    * Wrapper for an active listener owned by this handler.
    */
@@ -107,10 +120,15 @@ private:
    */
   struct ActiveConnection : LinkedObject<ActiveConnection>,
                             public Event::DeferredDeletable,
-                            public Network::ConnectionCallbacks {
+                            public Network::ConnectionCallbacks,
+                            public Buffer::MemoryAccount {
     ActiveConnection(ActiveListener& listener, Network::ConnectionPtr&& new_connection);
     ~ActiveConnection();
 
+    // Buffer::MemoryAccount
+    void charge(uint64_t bytes) override;
+    void credit(uint64_t bytes) override;
+
     // Network::ConnectionCallbacks
     void onEvent(Network::ConnectionEvent event) override {
       // Any event leads to destruction of the connection.
@@ -125,6 +143,7 @@ private:
     ActiveListener& listener_;
     Network::ConnectionPtr connection_;
     Stats::TimespanPtr conn_length_;
+    uint64_t buffered_bytes_{};
   };
 
   /**
@@ -164,6 +183,10 @@ private:
   spdlog::logger& logger_;
 #endif
   Event::Dispatcher& dispatcher_;
+  const uint64_t max_buffered_bytes_;
+  uint64_t buffered_bytes_{};
+  Event::TimerPtr buffer_overload_timer_;
+  bool buffer_overload_pending_{};
   std::list<std::pair<Network::Address::InstanceConstSharedPtr, ActiveListenerPtr>> listeners_;
   std::atomic<uint64_t> num_connections_{};
 };
@@ -368,8 +368,8 @@ Http::Code AdminImpl::handlerServerInfo(const std::string&, Http::HeaderMap&,
 
 Http::Code AdminImpl::handlerStats(const std::string& url, Http::HeaderMap& response_headers,
                                    Buffer::Instance& response) {
-  // We currently don't support timers locally (only via statsd) so just group all the counters
-  // and gauges together, alpha sort them, and spit them out.
+  // Group all the counters and gauges together, alpha sort them, and spit them out. Histograms are
+  // printed after them as a summary of the quantiles computed during the last stats flush.
   Http::Code rc = Http::Code::OK;
   const Http::Utility::QueryParams params = Http::Utility::parseQueryString(url);
   std::map<std::string, uint64_t> all_stats;
@@ -386,6 +386,16 @@ Http::Code AdminImpl::handlerStats(const std::string& url, Http::HeaderMap& resp
     for (auto stat : all_stats) {
       response.add(fmt::format("{}: {}\n", stat.first, stat.second));
     }
+
+    std::map<std::string, std::string> all_histograms;
+    for (const Stats::ParentHistogramSharedPtr& histogram : server_.stats().histograms()) {
+      if (histogram->used()) {
+        all_histograms.emplace(histogram->name(), histogram->summary());
+      }
+    }
+    for (const auto& histogram : all_histograms) {
+      response.add(fmt::format("{}: {}\n", histogram.first, histogram.second));
+    }
   } else {
     const std::string format_key = params.begin()->first;
     const std::string format_value = params.begin()->second;
@@ -94,6 +94,11 @@ OptionsImpl::OptionsImpl(int argc, char** argv, const HotRestartVersionCb& hot_r
                                              cmd);
   TCLAP::SwitchArg disable_hot_restart("", "disable-hot-restart",
                                        "Disable hot restart functionality", cmd, false);
+  TCLAP::ValueArg<uint64_t> max_worker_buffered_bytes(
+      "", "max-worker-buffered-bytes",
+      "Maximum number of bytes buffered by the connections of a worker before the connections "
+      "buffering the most are closed (0 for no limit)",
+      false, 0, "uint64_t", cmd);
 
   cmd.setExceptionHandling(false);
   try {
@@ -175,5 +180,6 @@ OptionsImpl::OptionsImpl(int argc, char** argv, const HotRestartVersionCb& hot_r
   parent_shutdown_time_ = std::chrono::seconds(parent_shutdown_time_s.getValue());
   max_stats_ = max_stats.getValue();
   max_obj_name_length_ = max_obj_name_len.getValue();
+  max_worker_buffered_bytes_ = max_worker_buffered_bytes.getValue();
 }
 } // namespace Envoy
@@ -50,6 +50,7 @@ public:
   uint64_t maxStats() override { return max_stats_; }
   uint64_t maxObjNameLength() override { return max_obj_name_length_; }
   bool hotRestartDisabled() override { return hot_restart_disabled_; }
+  uint64_t maxWorkerBufferedBytes() override { return max_worker_buffered_bytes_; }
 
 private:
   uint64_t base_id_;
@@ -71,6 +72,7 @@ private:
   uint64_t max_stats_;
   uint64_t max_obj_name_length_;
   bool hot_restart_disabled_;
+  uint64_t max_worker_buffered_bytes_;
 };
 
 /**
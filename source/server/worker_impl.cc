@@ -7,6 +7,7 @@
 #include "envoy/server/configuration.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/common/fmt.h"
 #include "common/common/thread.h"
 
 #include "server/connection_handler_impl.h"
@@ -16,9 +17,10 @@ namespace Server {
 
 WorkerPtr ProdWorkerFactory::createWorker() {
   Event::DispatcherPtr dispatcher(api_.allocateDispatcher());
-  return WorkerPtr{new WorkerImpl(
-      tls_, hooks_, std::move(dispatcher),
-      Network::ConnectionHandlerPtr{new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher)})};
+  dispatcher->initializeStats(stats_scope_, fmt::format("server.worker_{}.", num_workers_++));
+  Network::ConnectionHandlerPtr handler(
+      new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher, max_buffered_bytes_));
+  return WorkerPtr{new WorkerImpl(tls_, hooks_, std::move(dispatcher), std::move(handler))};
 }
 
 WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, TestHooks& hooks,
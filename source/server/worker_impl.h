@@ -8,6 +8,7 @@
 #include "envoy/server/guarddog.h"
 #include "envoy/server/listener_manager.h"
 #include "envoy/server/worker.h"
+#include "envoy/stats/stats.h"
 #include "envoy/thread_local/thread_local.h"
 
 #include "common/common/logger.h"
@@ -20,8 +21,10 @@ namespace Server {
 
 class ProdWorkerFactory : public WorkerFactory, Logger::Loggable<Logger::Id::main> {
 public:
-  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, TestHooks& hooks)
-      : tls_(tls), api_(api), hooks_(hooks) {}
+  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, TestHooks& hooks,
+                    Stats::Scope& stats_scope, uint64_t max_buffered_bytes)
+      : tls_(tls), api_(api), hooks_(hooks), stats_scope_(stats_scope),
+        max_buffered_bytes_(max_buffered_bytes) {}
 
   // Server::WorkerFactory
   WorkerPtr createWorker() override;
@@ -30,6 +33,9 @@ private:
   ThreadLocal::Instance& tls_;
   Api::Api& api_;
   TestHooks& hooks_;
+  Stats::Scope& stats_scope_;
+  const uint64_t max_buffered_bytes_;
+  uint32_t num_workers_{};
 };
 
 /**
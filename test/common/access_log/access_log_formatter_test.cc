@@ -204,6 +204,45 @@ TEST(AccessLogFormatterTest, requestHeaderFormatter) {
   }
 }
 
+TEST(AccessLogFormatterTest, requestHeaderFormatterInlineHeaders) {
+  RequestInfo::MockRequestInfo request_info;
+  Http::TestHeaderMapImpl request_header{
+      {":authority", "example.com"}, {"user-agent", "curl"}, {"x-custom", "custom"}};
+  Http::TestHeaderMapImpl response_header;
+
+  {
+    RequestHeaderFormatter formatter("USER-AGENT", "", Optional<size_t>());
+    EXPECT_EQ("curl", formatter.format(request_header, response_header, request_info));
+  }
+
+  {
+    RequestHeaderFormatter formatter(":authority", "", Optional<size_t>(7));
+    EXPECT_EQ("example", formatter.format(request_header, response_header, request_info));
+  }
+
+  {
+    // The header map stores the legacy host header as :authority, so it is not found by name.
+    RequestHeaderFormatter formatter("host", "", Optional<size_t>());
+    EXPECT_EQ("-", formatter.format(request_header, response_header, request_info));
+  }
+
+  {
+    RequestHeaderFormatter formatter(":path", "x-custom", Optional<size_t>());
+    EXPECT_EQ("custom", formatter.format(request_header, response_header, request_info));
+  }
+}
+
+TEST(AccessLogFormatterTest, formatIntoAppends) {
+  RequestInfo::MockRequestInfo request_info;
+  Http::TestHeaderMapImpl request_header{{":method", "GET"}};
+  Http::TestHeaderMapImpl response_header;
+  FormatterImpl formatter("%REQ(:METHOD)% %REQ(X-REQUEST-ID)%\n");
+
+  std::string output = "prefix ";
+  formatter.formatInto(request_header, response_header, request_info, output);
+  EXPECT_EQ("prefix GET -\n", output);
+}
+
 TEST(AccessLogFormatterTest, responseHeaderFormatter) {
   RequestInfo::MockRequestInfo request_info;
   Http::TestHeaderMapImpl request_header{{":method", "GET"}, {":path", "/"}};
@@ -0,0 +1,97 @@
+#include <string>
+#include <vector>
+
+#include "envoy/config/filter/accesslog/v2/accesslog.pb.h"
+
+#include "common/access_log/binary_file_access_log_impl.h"
+#include "common/protobuf/protobuf.h"
+
+#include "test/mocks/access_log/mocks.h"
+#include "test/mocks/filesystem/mocks.h"
+#include "test/mocks/request_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::_;
+
+namespace Envoy {
+namespace AccessLog {
+namespace {
+
+class BinaryFileAccessLogTest : public testing::Test {
+public:
+  BinaryFileAccessLogTest() {
+    EXPECT_CALL(log_manager_, createAccessLog("/dev/null"));
+    access_log_.reset(new BinaryFileAccessLog("/dev/null", nullptr, log_manager_));
+  }
+
+  // Parse all the length delimited entries in the written data.
+  std::vector<envoy::config::filter::accesslog::v2::HTTPAccessLogEntry>
+  parseEntries(const std::string& data) {
+    std::vector<envoy::config::filter::accesslog::v2::HTTPAccessLogEntry> entries;
+    Protobuf::io::ArrayInputStream array_stream(data.data(), data.size());
+    Protobuf::io::CodedInputStream coded_stream(&array_stream);
+    uint32_t size;
+    while (coded_stream.ReadVarint32(&size)) {
+      const auto limit = coded_stream.PushLimit(size);
+      entries.emplace_back();
+      EXPECT_TRUE(entries.back().ParseFromCodedStream(&coded_stream));
+      EXPECT_TRUE(coded_stream.ConsumedEntireMessage());
+      coded_stream.PopLimit(limit);
+    }
+    return entries;
+  }
+
+  NiceMock<MockAccessLogManager> log_manager_;
+  std::unique_ptr<BinaryFileAccessLog> access_log_;
+};
+
+TEST_F(BinaryFileAccessLogTest, WritesDelimitedEntries) {
+  NiceMock<RequestInfo::MockRequestInfo> request_info;
+  request_info.protocol_ = Http::Protocol::Http11;
+  request_info.response_code_.value(200);
+  request_info.bytes_sent_ = 20;
+  Http::TestHeaderMapImpl request_headers{{":path", "/foo"}, {"user-agent", "curl"}};
+  Http::TestHeaderMapImpl response_headers{{":status", "200"}};
+
+  std::string written;
+  EXPECT_CALL(*log_manager_.file_, write(_))
+      .Times(2)
+      .WillRepeatedly(Invoke([&written](const std::string& data) { written += data; }));
+  access_log_->log(&request_headers, &response_headers, request_info);
+  access_log_->log(nullptr, nullptr, request_info);
+
+  const auto entries = parseEntries(written);
+  ASSERT_EQ(2, entries.size());
+
+  EXPECT_EQ(envoy::config::filter::accesslog::v2::HTTPAccessLogEntry::HTTP11,
+            entries[0].protocol_version());
+  EXPECT_EQ("/foo", entries[0].request().path());
+  EXPECT_EQ("curl", entries[0].request().user_agent());
+  EXPECT_EQ(200, entries[0].response().response_code().value());
+  EXPECT_EQ(20, entries[0].response().response_body_bytes());
+
+  // The per thread entry is cleared between log lines.
+  EXPECT_EQ("", entries[1].request().path());
+  EXPECT_EQ(200, entries[1].response().response_code().value());
+}
+
+TEST_F(BinaryFileAccessLogTest, Filtered) {
+  MockFilter* filter = new MockFilter();
+  EXPECT_CALL(log_manager_, createAccessLog("/dev/null"));
+  access_log_.reset(new BinaryFileAccessLog("/dev/null", FilterPtr{filter}, log_manager_));
+
+  NiceMock<RequestInfo::MockRequestInfo> request_info;
+  EXPECT_CALL(*filter, evaluate(_, _)).WillOnce(Return(false));
+  EXPECT_CALL(*log_manager_.file_, write(_)).Times(0);
+  access_log_->log(nullptr, nullptr, request_info);
+}
+
+} // namespace
+} // namespace AccessLog
+} // namespace Envoy
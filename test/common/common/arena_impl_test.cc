@@ -0,0 +1,103 @@
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "common/common/arena_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+
+namespace {
+
+struct Tracked {
+  Tracked(uint32_t& destroyed) : destroyed_(destroyed) {}
+  ~Tracked() { destroyed_++; }
+
+  uint32_t& destroyed_;
+  std::string value_{"a string that does not fit in the small string buffer"};
+};
+
+struct alignas(64) OverAligned {
+  uint8_t data_[64];
+};
+
+} // namespace
+
+TEST(ArenaImplTest, Make) {
+  uint32_t destroyed = 0;
+  ArenaImpl arena;
+  {
+    ArenaPtr<Tracked> first = arena.make<Tracked>(destroyed);
+    ArenaPtr<Tracked> second = arena.make<Tracked>(destroyed);
+    EXPECT_NE(first.get(), second.get());
+    EXPECT_EQ(&destroyed, &second->destroyed_);
+    first.reset();
+    EXPECT_EQ(1U, destroyed);
+  }
+  EXPECT_EQ(2U, destroyed);
+  EXPECT_EQ(2 * sizeof(Tracked), arena.bytesAllocated());
+}
+
+TEST(ArenaImplTest, Alignment) {
+  ArenaImpl arena;
+  arena.allocate(1, 1);
+  for (size_t alignment : {2, 8, 16, 64, 256}) {
+    void* memory = arena.allocate(3, alignment);
+    EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(memory) % alignment);
+  }
+
+  ArenaPtr<OverAligned> object = arena.make<OverAligned>();
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(object.get()) % 64);
+}
+
+TEST(ArenaImplTest, ManyAndLargeAllocations) {
+  ArenaImpl arena;
+  uint8_t* previous = nullptr;
+  for (uint32_t i = 0; i < 1000; i++) {
+    uint8_t* memory = static_cast<uint8_t*>(arena.allocate(100, 8));
+    memset(memory, i, 100);
+    EXPECT_NE(previous, memory);
+    previous = memory;
+  }
+
+  // Large allocations do not disturb the current block.
+  uint8_t* small1 = static_cast<uint8_t*>(arena.allocate(8, 8));
+  uint8_t* large = static_cast<uint8_t*>(arena.allocate(ArenaImpl::BLOCK_SIZE * 2, 8));
+  memset(large, 0, ArenaImpl::BLOCK_SIZE * 2);
+  uint8_t* small2 = static_cast<uint8_t*>(arena.allocate(8, 8));
+  EXPECT_EQ(small1 + 8, small2);
+}
+
+TEST(ArenaImplTest, BlocksAreCached) {
+  // Run on a fresh thread so that the thread's cache starts empty.
+  std::thread([]() {
+    EXPECT_EQ(0U, ArenaImpl::cachedBlocks());
+    {
+      ArenaImpl arena;
+      arena.allocate(ArenaImpl::BLOCK_SIZE / 8, 8);
+      arena.allocate(ArenaImpl::BLOCK_SIZE * 2, 8);
+    }
+    // Only the standard sized block is cached.
+    EXPECT_EQ(1U, ArenaImpl::cachedBlocks());
+
+    {
+      ArenaImpl arena;
+      arena.allocate(8, 8);
+      EXPECT_EQ(0U, ArenaImpl::cachedBlocks());
+    }
+    EXPECT_EQ(1U, ArenaImpl::cachedBlocks());
+
+    {
+      ArenaImpl arena;
+      // Four of these fit in a block.
+      for (size_t i = 0; i < 4 * (ArenaImpl::MAX_CACHED_BLOCKS + 10); i++) {
+        arena.allocate(ArenaImpl::BLOCK_SIZE / 4, 8);
+      }
+    }
+    EXPECT_EQ(ArenaImpl::MAX_CACHED_BLOCKS, ArenaImpl::cachedBlocks());
+  })
+      .join();
+}
+
+} // namespace Envoy
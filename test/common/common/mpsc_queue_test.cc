@@ -0,0 +1,85 @@
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/common/mpsc_queue.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+
+TEST(MpscQueueTest, Fifo) {
+  MpscQueue<std::unique_ptr<int>> queue;
+  std::unique_ptr<int> value;
+  EXPECT_FALSE(queue.pop(value));
+
+  queue.push(std::make_unique<int>(1));
+  queue.push(std::make_unique<int>(2));
+  EXPECT_TRUE(queue.pop(value));
+  EXPECT_EQ(1, *value);
+
+  queue.push(std::make_unique<int>(3));
+  EXPECT_TRUE(queue.pop(value));
+  EXPECT_EQ(2, *value);
+  EXPECT_TRUE(queue.pop(value));
+  EXPECT_EQ(3, *value);
+  EXPECT_FALSE(queue.pop(value));
+
+  // Elements left in the queue are freed with it.
+  queue.push(std::make_unique<int>(4));
+}
+
+// Pushing past the pool allocates nodes, and the pool nodes are reused once popped.
+TEST(MpscQueueTest, Pool) {
+  MpscQueue<std::unique_ptr<int>> queue(2);
+  std::unique_ptr<int> value;
+  for (int round = 0; round < 3; round++) {
+    for (int i = 0; i < 5; i++) {
+      queue.push(std::make_unique<int>(i));
+    }
+    for (int i = 0; i < 5; i++) {
+      EXPECT_TRUE(queue.pop(value));
+      EXPECT_EQ(i, *value);
+    }
+    EXPECT_FALSE(queue.pop(value));
+  }
+
+  queue.push(std::make_unique<int>(5));
+  queue.push(std::make_unique<int>(6));
+  queue.push(std::make_unique<int>(7));
+}
+
+// The pool is smaller than the number of producers, so they contend on the free nodes and also
+// allocate nodes.
+TEST(MpscQueueTest, ManyProducers) {
+  const int num_producers = 4;
+  const int pushes_per_producer = 10000;
+  MpscQueue<std::pair<int, int>> queue(3);
+
+  std::vector<std::thread> producers;
+  for (int i = 0; i < num_producers; i++) {
+    producers.emplace_back([&queue, i]() {
+      for (int j = 0; j < pushes_per_producer; j++) {
+        queue.push({i, j});
+      }
+    });
+  }
+
+  // Every element is popped once, and the elements of each producer come out in order.
+  std::vector<int> next(num_producers);
+  int num_popped = 0;
+  std::pair<int, int> value;
+  while (num_popped < num_producers * pushes_per_producer) {
+    if (queue.pop(value)) {
+      EXPECT_EQ(next[value.first]++, value.second);
+      num_popped++;
+    }
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_FALSE(queue.pop(value));
+}
+
+} // namespace Envoy
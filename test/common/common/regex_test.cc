@@ -0,0 +1,57 @@
+#include "envoy/common/exception.h"
+
+#include "common/common/regex.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Regex {
+
+class RegexEngineTest : public testing::TestWithParam<Engine> {};
+
+INSTANTIATE_TEST_CASE_P(Engines, RegexEngineTest, testing::Values(Engine::StdRegex, Engine::Re2));
+
+TEST_P(RegexEngineTest, FullMatch) {
+  CompiledMatcherPtr matcher = Utility::parseRegex("/t[io]c", GetParam());
+  EXPECT_TRUE(matcher->match("/tic"));
+  EXPECT_TRUE(matcher->match("/toc"));
+  EXPECT_FALSE(matcher->match("/tac"));
+  EXPECT_FALSE(matcher->match("/tic/"));
+  EXPECT_FALSE(matcher->match("x/tic"));
+}
+
+TEST_P(RegexEngineTest, EmbeddedNulAndSubstring) {
+  CompiledMatcherPtr matcher = Utility::parseRegex("\\d{3}", GetParam());
+  const std::string value("123\0"
+                          "456",
+                          7);
+  EXPECT_TRUE(matcher->match(absl::string_view(value).substr(0, 3)));
+  EXPECT_FALSE(matcher->match(absl::string_view(value).substr(0, 4)));
+  EXPECT_FALSE(matcher->match(value));
+  EXPECT_TRUE(matcher->match(absl::string_view(value).substr(4)));
+
+  CompiledMatcherPtr nul_matcher = Utility::parseRegex("\\d+\\x00\\d+", GetParam());
+  EXPECT_TRUE(nul_matcher->match(value));
+}
+
+TEST_P(RegexEngineTest, InvalidRegex) {
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegex("(+invalid)", GetParam()), EnvoyException,
+                          "Invalid regex '\\(\\+invalid\\)': .+");
+}
+
+TEST(RegexTest, Re2RejectsBackreferences) {
+  EXPECT_NO_THROW(Utility::parseRegex("(a)\\1", Engine::StdRegex));
+  EXPECT_THROW(Utility::parseRegex("(a)\\1", Engine::Re2), EnvoyException);
+}
+
+// A pattern that makes backtracking engines take exponential time is matched in linear time by RE2.
+TEST(RegexTest, Re2PathologicalPattern) {
+  CompiledMatcherPtr matcher = Utility::parseRegex("(a+)+b", Engine::Re2);
+  EXPECT_FALSE(matcher->match(std::string(64, 'a')));
+  EXPECT_TRUE(matcher->match(std::string(64, 'a') + "b"));
+}
+
+} // namespace Regex
+} // namespace Envoy
@@ -51,8 +51,7 @@ TEST_F(DynamoFilterTest, operatorPresent) {
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.Get"}, {"random", "random"}};
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, true));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
 
   Http::TestHeaderMapImpl continue_headers{{":status", "100"}};
   EXPECT_EQ(Http::FilterHeadersStatus::Continue,
@@ -90,8 +89,7 @@ TEST_F(DynamoFilterTest, jsonBodyNotWellFormed) {
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.GetItem"},
                                           {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
 
   Buffer::OwnedImpl buffer;
   buffer.add("test", 4);
@@ -105,8 +103,7 @@ TEST_F(DynamoFilterTest, bothOperationAndTableIncorrect) {
   setup(true);
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version"}, {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, true));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.operation_missing"));
   EXPECT_CALL(stats_, counter("prefix.dynamodb.table_missing"));
@@ -119,15 +116,13 @@ TEST_F(DynamoFilterTest, handleErrorTypeTableMissing) {
   setup(true);
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version"}, {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, true));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.operation_missing"));
   EXPECT_CALL(stats_, counter("prefix.dynamodb.table_missing"));
 
   Http::TestHeaderMapImpl response_headers{{":status", "400"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
   Buffer::InstancePtr error_data(new Buffer::OwnedImpl());
   std::string internal_error =
@@ -137,9 +132,7 @@ TEST_F(DynamoFilterTest, handleErrorTypeTableMissing) {
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*error_data, true));
 
   error_data->add("}", 1);
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer,
-            filter_->encodeData(*error_data, false));
-  EXPECT_CALL(encoder_callbacks_, encodingBuffer()).WillRepeatedly(Return(error_data.get()));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*error_data, false));
   EXPECT_CALL(stats_, counter("prefix.dynamodb.invalid_resp_body"));
   EXPECT_CALL(stats_, counter("prefix.dynamodb.operation_missing"));
   EXPECT_CALL(stats_, counter("prefix.dynamodb.table_missing"));
@@ -151,8 +144,7 @@ TEST_F(DynamoFilterTest, HandleErrorTypeTablePresent) {
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.GetItem"},
                                           {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
 
   Buffer::OwnedImpl buffer;
   std::string buffer_content = "{\"TableName\":\"locations\"}";
@@ -160,8 +152,7 @@ TEST_F(DynamoFilterTest, HandleErrorTypeTablePresent) {
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(buffer, true));
 
   Http::TestHeaderMapImpl response_headers{{":status", "400"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
   Buffer::OwnedImpl error_data;
   std::string internal_error =
@@ -217,8 +208,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTables) {
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.BatchGetItem"},
                                           {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
 
   Buffer::InstancePtr buffer(new Buffer::OwnedImpl());
   std::string buffer_content = R"EOF(
@@ -231,8 +221,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTables) {
 )EOF";
   buffer->add(buffer_content);
 
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(*buffer, false));
-  EXPECT_CALL(decoder_callbacks_, decodingBuffer()).WillRepeatedly(Return(buffer.get()));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(*buffer, false));
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers));
 
   Http::TestHeaderMapImpl response_headers{{":status", "200"}};
@@ -266,8 +255,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesUnprocessedKeys) {
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.BatchGetItem"},
                                           {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
 
   Buffer::InstancePtr buffer(new Buffer::OwnedImpl());
   std::string buffer_content = R"EOF(
@@ -280,8 +268,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesUnprocessedKeys) {
 )EOF";
   buffer->add(buffer_content);
 
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(*buffer, false));
-  EXPECT_CALL(decoder_callbacks_, decodingBuffer()).WillRepeatedly(Return(buffer.get()));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(*buffer, false));
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers));
 
   Http::TestHeaderMapImpl response_headers{{":status", "200"}};
@@ -307,10 +294,8 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesUnprocessedKeys) {
                                    "prefix.dynamodb.operation.BatchGetItem.upstream_rq_time"),
                           _));
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
-  Buffer::OwnedImpl empty_data;
   Buffer::InstancePtr response_data(new Buffer::OwnedImpl());
   std::string response_content = R"EOF(
 {
@@ -324,8 +309,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesUnprocessedKeys) {
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.error.table_1.BatchFailureUnprocessedKeys"));
   EXPECT_CALL(stats_, counter("prefix.dynamodb.error.table_2.BatchFailureUnprocessedKeys"));
-  EXPECT_CALL(encoder_callbacks_, encodingBuffer()).WillRepeatedly(Return(response_data.get()));
-  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(empty_data, true));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*response_data, true));
 }
 
 TEST_F(DynamoFilterTest, BatchMultipleTablesNoUnprocessedKeys) {
@@ -333,8 +317,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesNoUnprocessedKeys) {
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.BatchGetItem"},
                                           {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
 
   Buffer::InstancePtr buffer(new Buffer::OwnedImpl());
   std::string buffer_content = R"EOF(
@@ -347,8 +330,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesNoUnprocessedKeys) {
 )EOF";
   buffer->add(buffer_content);
 
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(*buffer, false));
-  EXPECT_CALL(decoder_callbacks_, decodingBuffer()).WillRepeatedly(Return(buffer.get()));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(*buffer, false));
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers));
 
   Http::TestHeaderMapImpl response_headers{{":status", "200"}};
@@ -374,10 +356,8 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesNoUnprocessedKeys) {
                                    "prefix.dynamodb.operation.BatchGetItem.upstream_rq_time"),
                           _));
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
-  Buffer::OwnedImpl empty_data;
   Buffer::InstancePtr response_data(new Buffer::OwnedImpl());
   std::string response_content = R"EOF(
 {
@@ -387,8 +367,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesNoUnprocessedKeys) {
 )EOF";
   response_data->add(response_content);
 
-  EXPECT_CALL(encoder_callbacks_, encodingBuffer()).WillOnce(Return(response_data.get()));
-  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(empty_data, true));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*response_data, true));
 }
 
 TEST_F(DynamoFilterTest, BatchMultipleTablesInvalidResponseBody) {
@@ -396,8 +375,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesInvalidResponseBody) {
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.BatchGetItem"},
                                           {"random", "random"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
 
   Buffer::InstancePtr buffer(new Buffer::OwnedImpl());
   std::string buffer_content = R"EOF(
@@ -410,8 +388,7 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesInvalidResponseBody) {
 )EOF";
   buffer->add(buffer_content);
 
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(*buffer, false));
-  EXPECT_CALL(decoder_callbacks_, decodingBuffer()).WillRepeatedly(Return(buffer.get()));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(*buffer, false));
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers));
 
   Http::TestHeaderMapImpl response_headers{{":status", "200"}};
@@ -437,10 +414,8 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesInvalidResponseBody) {
                                    "prefix.dynamodb.operation.BatchGetItem.upstream_rq_time"),
                           _));
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
-  Buffer::OwnedImpl empty_data;
   Buffer::InstancePtr response_data(new Buffer::OwnedImpl());
   std::string response_content = R"EOF(
 {
@@ -454,24 +429,68 @@ TEST_F(DynamoFilterTest, BatchMultipleTablesInvalidResponseBody) {
   response_data->add("}", 1);
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.invalid_resp_body"));
-  EXPECT_CALL(encoder_callbacks_, encodingBuffer()).WillOnce(Return(response_data.get()));
-  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(empty_data, true));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*response_data, true));
+}
+
+// The bodies are parsed as they stream through the filter, and are never buffered.
+TEST_F(DynamoFilterTest, BatchUnprocessedKeysStreamed) {
+  setup(true);
+
+  EXPECT_CALL(decoder_callbacks_, decodingBuffer()).Times(0);
+  EXPECT_CALL(encoder_callbacks_, encodingBuffer()).Times(0);
+
+  Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.BatchGetItem"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
+
+  std::string request_content = R"EOF(
+{
+  "RequestItems": {
+    "locations": { "Keys": [ { "Id": { "S": "\"table_2\"" } } ] }
+  }
+}
+)EOF";
+  for (size_t i = 0; i < request_content.size(); i++) {
+    Buffer::OwnedImpl data(request_content.substr(i, 1));
+    EXPECT_EQ(Http::FilterDataStatus::Continue,
+              filter_->decodeData(data, i == request_content.size() - 1));
+  }
+
+  EXPECT_CALL(stats_, counter("prefix.dynamodb.multiple_tables")).Times(0);
+  EXPECT_CALL(stats_, counter("prefix.dynamodb.table.locations.upstream_rq_total"));
+  EXPECT_CALL(stats_, counter("prefix.dynamodb.error.locations.BatchFailureUnprocessedKeys"));
+
+  Http::TestHeaderMapImpl response_headers{{":status", "200"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
+
+  std::string response_content = R"EOF(
+{
+  "Responses": {
+    "locations": [ { "Id": { "S": "1" }, "UnprocessedKeys": { "table_2": {} } } ]
+  },
+  "UnprocessedKeys": {
+    "locations": { "Keys": [ { "Id": { "S": "2" } } ] }
+  }
+}
+)EOF";
+  for (size_t i = 0; i < response_content.size(); i++) {
+    Buffer::OwnedImpl data(response_content.substr(i, 1));
+    EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data, false));
+  }
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->encodeTrailers(response_headers));
 }
 
 TEST_F(DynamoFilterTest, bothOperationAndTableCorrect) {
   setup(true);
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.GetItem"}};
-  Buffer::InstancePtr buffer(new Buffer::OwnedImpl());
+  Buffer::OwnedImpl buffer;
   std::string buffer_content = "{\"TableName\":\"locations\"";
-  buffer->add(buffer_content);
-  EXPECT_CALL(decoder_callbacks_, decodingBuffer()).WillRepeatedly(Return(buffer.get()));
+  buffer.add(buffer_content);
   Buffer::OwnedImpl data;
   data.add("}", 1);
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(data, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(buffer, false));
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(data, true));
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.operation.GetItem.upstream_rq_total_2xx"));
@@ -537,16 +556,14 @@ TEST_F(DynamoFilterTest, PartitionIdStats) {
   setup(true);
 
   Http::TestHeaderMapImpl request_headers{{"x-amz-target", "version.GetItem"}};
-  Buffer::InstancePtr buffer(new Buffer::OwnedImpl());
+  Buffer::OwnedImpl buffer;
   std::string buffer_content = "{\"TableName\":\"locations\"";
-  buffer->add(buffer_content);
-  ON_CALL(decoder_callbacks_, decodingBuffer()).WillByDefault(Return(buffer.get()));
+  buffer.add(buffer_content);
   Buffer::OwnedImpl data;
   data.add("}", 1);
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(data, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(buffer, false));
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(data, true));
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.operation.GetItem.upstream_rq_total_2xx"));
@@ -597,10 +614,8 @@ TEST_F(DynamoFilterTest, PartitionIdStats) {
       .Times(1);
 
   Http::TestHeaderMapImpl response_headers{{":status", "200"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
-  Buffer::OwnedImpl empty_data;
   Buffer::InstancePtr response_data(new Buffer::OwnedImpl());
   std::string response_content = R"EOF(
     {
@@ -615,8 +630,7 @@ TEST_F(DynamoFilterTest, PartitionIdStats) {
 
   response_data->add(response_content);
 
-  EXPECT_CALL(encoder_callbacks_, encodingBuffer()).WillOnce(Return(response_data.get()));
-  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(empty_data, true));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*response_data, true));
 }
 
 TEST_F(DynamoFilterTest, NoPartitionIdStatsForMultipleTables) {
@@ -633,11 +647,9 @@ TEST_F(DynamoFilterTest, NoPartitionIdStatsForMultipleTables) {
 }
 )EOF";
   buffer->add(buffer_content);
-  ON_CALL(decoder_callbacks_, decodingBuffer()).WillByDefault(Return(buffer.get()));
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(*buffer, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(*buffer, false));
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers));
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.multiple_tables"));
@@ -672,10 +684,8 @@ TEST_F(DynamoFilterTest, NoPartitionIdStatsForMultipleTables) {
       .Times(0);
 
   Http::TestHeaderMapImpl response_headers{{":status", "200"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
-  Buffer::OwnedImpl empty_data;
   Buffer::InstancePtr response_data(new Buffer::OwnedImpl());
   std::string response_content = R"EOF(
     {
@@ -690,8 +700,7 @@ TEST_F(DynamoFilterTest, NoPartitionIdStatsForMultipleTables) {
 
   response_data->add(response_content);
 
-  EXPECT_CALL(encoder_callbacks_, encodingBuffer()).WillOnce(Return(response_data.get()));
-  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(empty_data, true));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*response_data, true));
 }
 
 TEST_F(DynamoFilterTest, PartitionIdStatsForSingleTableBatchOperation) {
@@ -707,11 +716,9 @@ TEST_F(DynamoFilterTest, PartitionIdStatsForSingleTableBatchOperation) {
 }
 )EOF";
   buffer->add(buffer_content);
-  ON_CALL(decoder_callbacks_, decodingBuffer()).WillByDefault(Return(buffer.get()));
 
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->decodeHeaders(request_headers, false));
-  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer, filter_->decodeData(*buffer, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(*buffer, false));
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers));
 
   EXPECT_CALL(stats_, counter("prefix.dynamodb.multiple_tables")).Times(0);
@@ -766,10 +773,8 @@ TEST_F(DynamoFilterTest, PartitionIdStatsForSingleTableBatchOperation) {
       .Times(1);
 
   Http::TestHeaderMapImpl response_headers{{":status", "200"}};
-  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
-            filter_->encodeHeaders(response_headers, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
 
-  Buffer::OwnedImpl empty_data;
   Buffer::InstancePtr response_data(new Buffer::OwnedImpl());
   std::string response_content = R"EOF(
     {
@@ -784,8 +789,7 @@ TEST_F(DynamoFilterTest, PartitionIdStatsForSingleTableBatchOperation) {
 
   response_data->add(response_content);
 
-  EXPECT_CALL(encoder_callbacks_, encodingBuffer()).WillOnce(Return(response_data.get()));
-  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(empty_data, true));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(*response_data, true));
 }
 
 } // namespace Dynamo
@@ -1,6 +1,7 @@
 #include <string>
 #include <vector>
 
+#include "common/buffer/buffer_impl.h"
 #include "common/dynamo/dynamo_request_parser.h"
 #include "common/http/header_map_impl.h"
 #include "common/json/json_loader.h"
@@ -261,5 +262,120 @@ TEST(DynamoRequestParser, parsePartitionIds) {
   }
 }
 
+TEST(DynamoBodyParser, Table) {
+  {
+    BodyParser parser;
+    EXPECT_TRUE(parser.empty());
+    parser.parse(Buffer::OwnedImpl("{\"TableName\":\"Pe"));
+    parser.parse(Buffer::OwnedImpl("ts\", \"Key\": {\"TableName\": \"Cats\"}}"));
+    EXPECT_FALSE(parser.empty());
+    EXPECT_TRUE(parser.finish());
+    EXPECT_EQ("Pets", parser.table("GetItem").table_name);
+    EXPECT_EQ("", parser.table("NotSupportedOperation").table_name);
+  }
+
+  {
+    BodyParser parser;
+    parser.parse(Buffer::OwnedImpl(R"EOF(
+    {
+      "RequestItems": {
+        "table_2": { "test1" : "something" },
+        "table_2": { "test2" : "something" }
+      }
+    }
+    )EOF"));
+    EXPECT_TRUE(parser.finish());
+    RequestParser::TableDescriptor table = parser.table("BatchWriteItem");
+    EXPECT_EQ("table_2", table.table_name);
+    EXPECT_TRUE(table.is_single_table);
+  }
+
+  {
+    BodyParser parser;
+    parser.parse(Buffer::OwnedImpl(R"EOF(
+    {
+      "RequestItems": {
+        "table_1": { "RequestItems" : { "table_3": {} } },
+        "table_2": { "test2" : "something" }
+      }
+    }
+    )EOF"));
+    EXPECT_TRUE(parser.finish());
+    RequestParser::TableDescriptor table = parser.table("BatchGetItem");
+    EXPECT_EQ("", table.table_name);
+    EXPECT_FALSE(table.is_single_table);
+  }
+
+  // Fields of the wrong type are ignored.
+  {
+    BodyParser parser;
+    parser.parse(Buffer::OwnedImpl("{\"TableName\": [\"Pets\"], \"RequestItems\": [\"Pets\"]}"));
+    EXPECT_TRUE(parser.finish());
+    EXPECT_EQ("", parser.table("GetItem").table_name);
+    EXPECT_EQ("", parser.table("BatchGetItem").table_name);
+    EXPECT_TRUE(parser.table("BatchGetItem").is_single_table);
+  }
+}
+
+TEST(DynamoBodyParser, Response) {
+  BodyParser parser;
+  std::string json_string = R"EOF(
+    {
+      "__type": "com.amazonaws.dynamodb.v20120810#ResourceNotFoundException",
+      "UnprocessedKeys": {
+        "table_1": { "test1" : "something" },
+        "table_2": { "test2" : "something" }
+      },
+      "ConsumedCapacity": {
+        "Partitions": {
+          "partition_1" : 0.5,
+          "partition_2" : 3.0,
+          "partition_3" : "4.0"
+        }
+      }
+    }
+    )EOF";
+  for (char c : json_string) {
+    parser.parse(Buffer::OwnedImpl(&c, 1));
+  }
+  EXPECT_TRUE(parser.finish());
+
+  EXPECT_EQ("ResourceNotFoundException", parser.errorType());
+  EXPECT_EQ((std::vector<std::string>{"table_1", "table_2"}), parser.unprocessedTables());
+  ASSERT_EQ(2u, parser.partitions().size());
+  EXPECT_EQ("partition_1", parser.partitions()[0].partition_id_);
+  EXPECT_EQ(1u, parser.partitions()[0].capacity_);
+  EXPECT_EQ("partition_2", parser.partitions()[1].partition_id_);
+  EXPECT_EQ(3u, parser.partitions()[1].capacity_);
+}
+
+TEST(DynamoBodyParser, Invalid) {
+  {
+    BodyParser parser;
+    parser.parse(Buffer::OwnedImpl("{\"__type\":\"UnKnownError\"}"));
+    EXPECT_TRUE(parser.finish());
+    EXPECT_EQ("", parser.errorType());
+  }
+
+  {
+    BodyParser parser;
+    parser.parse(Buffer::OwnedImpl("{\"TableName\":\"Pets\"}}"));
+    parser.parse(Buffer::OwnedImpl("{}"));
+    EXPECT_FALSE(parser.finish());
+  }
+
+  {
+    BodyParser parser;
+    parser.parse(Buffer::OwnedImpl("{\"TableName\":\"Pets\""));
+    EXPECT_FALSE(parser.finish());
+  }
+
+  {
+    BodyParser parser;
+    parser.parse(Buffer::OwnedImpl());
+    EXPECT_TRUE(parser.empty());
+  }
+}
+
 } // namespace Dynamo
 } // namespace Envoy
@@ -1,16 +1,20 @@
 #include <condition_variable>
 #include <functional>
 #include <mutex>
+#include <vector>
 
 #include "common/common/thread.h"
 #include "common/event/dispatcher_impl.h"
 
 #include "test/mocks/common.h"
+#include "test/mocks/stats/mocks.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 using testing::InSequence;
+using testing::Property;
+using testing::_;
 
 namespace Envoy {
 namespace Event {
@@ -54,6 +58,24 @@ TEST(DeferredDeleteTest, DeferredDelete) {
   dispatcher.clearDeferredDeleteList();
 }
 
+// Each run of the posted callbacks records how many were queued and how long the first one waited.
+TEST(DispatcherImplStatsTest, PostStats) {
+  Stats::MockIsolatedStatsStore stats_store;
+  DispatcherImpl dispatcher;
+  dispatcher.initializeStats(stats_store, "test.");
+
+  ReadyWatcher watcher;
+  dispatcher.post([&watcher]() -> void { watcher.ready(); });
+  dispatcher.post([&watcher]() -> void { watcher.ready(); });
+
+  EXPECT_CALL(stats_store,
+              deliverHistogramToSinks(Property(&Stats::Metric::name, "test.post_queue_depth"), 2));
+  EXPECT_CALL(stats_store,
+              deliverHistogramToSinks(Property(&Stats::Metric::name, "test.post_latency_us"), _));
+  EXPECT_CALL(watcher, ready()).Times(2);
+  dispatcher.run(Dispatcher::RunType::NonBlock);
+}
+
 class DispatcherImplTest : public ::testing::Test {
 protected:
   DispatcherImplTest() : dispatcher_(std::make_unique<DispatcherImpl>()), work_finished_(false) {
@@ -96,6 +118,41 @@ TEST_F(DispatcherImplTest, Post) {
   cv_.wait(lock, [this]() { return work_finished_; });
 }
 
+TEST_F(DispatcherImplTest, PostFromManyThreads) {
+  const uint32_t num_threads = 4;
+  const uint32_t posts_per_thread = 1000;
+  std::vector<uint32_t> next_post(num_threads);
+  uint32_t num_posts_run = 0;
+  bool in_order = true;
+
+  std::vector<std::unique_ptr<Thread::Thread>> threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads.emplace_back(std::make_unique<Thread::Thread>([&, i]() {
+      for (uint32_t j = 0; j < posts_per_thread; j++) {
+        dispatcher_->post([&, i, j]() {
+          // Posts from one thread run in the order they were made.
+          in_order &= next_post[i]++ == j;
+          if (++num_posts_run == num_threads * posts_per_thread) {
+            {
+              std::lock_guard<std::mutex> lock(mu_);
+              work_finished_ = true;
+            }
+            cv_.notify_one();
+          }
+        });
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread->join();
+  }
+
+  std::unique_lock<std::mutex> lock(mu_);
+  cv_.wait(lock, [this]() { return work_finished_; });
+  EXPECT_TRUE(in_order);
+}
+
 TEST_F(DispatcherImplTest, Timer) {
   TimerPtr timer;
   dispatcher_->post([this, &timer]() {
@@ -30,9 +30,11 @@ namespace Envoy {
 TEST(FileSystemImpl, BadFile) {
   Event::MockDispatcher dispatcher;
   Thread::MutexBasicLockable lock;
+  Filesystem::FlushThread flush_thread;
   Stats::IsolatedStoreImpl store;
   EXPECT_CALL(dispatcher, createTimer_(_));
-  EXPECT_THROW(Filesystem::FileImpl("", dispatcher, lock, store, std::chrono::milliseconds(10000)),
+  EXPECT_THROW(Filesystem::FileImpl("", dispatcher, lock, flush_thread, store,
+                                    std::chrono::milliseconds(10000)),
                EnvoyException);
 }
 
@@ -95,7 +97,9 @@ TEST(FileSystemImpl, flushToLogFilePeriodically) {
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
 
   EXPECT_CALL(os_sys_calls, open_(_, _, _)).WillOnce(Return(5));
-  Filesystem::FileImpl file("", dispatcher, mutex, stats_store, std::chrono::milliseconds(40));
+  Filesystem::FlushThread flush_thread;
+  Filesystem::FileImpl file("", dispatcher, mutex, flush_thread, stats_store,
+                            std::chrono::milliseconds(40));
 
   EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(40)));
   EXPECT_CALL(os_sys_calls, write_(_, _, _))
@@ -148,7 +152,9 @@ TEST(FileSystemImpl, flushToLogFileOnDemand) {
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
 
   EXPECT_CALL(os_sys_calls, open_(_, _, _)).WillOnce(Return(5));
-  Filesystem::FileImpl file("", dispatcher, mutex, stats_store, std::chrono::milliseconds(40));
+  Filesystem::FlushThread flush_thread;
+  Filesystem::FileImpl file("", dispatcher, mutex, flush_thread, stats_store,
+                            std::chrono::milliseconds(40));
 
   EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(40)));
 
@@ -211,6 +217,62 @@ TEST(FileSystemImpl, flushToLogFileOnDemand) {
   }
 }
 
+TEST(FileSystemImpl, filesShareFlushThread) {
+  NiceMock<Event::MockDispatcher> dispatcher;
+  NiceMock<Event::MockTimer>* timer1 = new NiceMock<Event::MockTimer>(&dispatcher);
+  NiceMock<Event::MockTimer>* timer2 = new NiceMock<Event::MockTimer>(&dispatcher);
+
+  Thread::MutexBasicLockable mutex;
+  Stats::IsolatedStoreImpl stats_store;
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+
+  EXPECT_CALL(os_sys_calls, open_(_, _, _)).WillOnce(Return(5)).WillOnce(Return(6));
+  Filesystem::FlushThread flush_thread;
+  Filesystem::FileImpl file1("", dispatcher, mutex, flush_thread, stats_store,
+                             std::chrono::milliseconds(40));
+  Filesystem::FileImpl file2("", dispatcher, mutex, flush_thread, stats_store,
+                             std::chrono::milliseconds(40));
+
+  // Prime both files so that the flushes triggered by the first writes are out of the way.
+  EXPECT_CALL(os_sys_calls, write_(_, _, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([](int, const void*, size_t num_bytes) -> ssize_t {
+        return num_bytes;
+      }));
+  file1.write("prime-it");
+  file2.write("prime-it");
+  {
+    std::unique_lock<Thread::BasicLockable> lock(os_sys_calls.write_mutex_);
+    while (os_sys_calls.num_writes_ != 2) {
+      os_sys_calls.write_event_.wait(os_sys_calls.write_mutex_);
+    }
+  }
+
+  EXPECT_CALL(os_sys_calls, write_(5, _, _))
+      .WillOnce(Invoke([](int, const void* buffer, size_t num_bytes) -> ssize_t {
+        EXPECT_EQ("test1", std::string(reinterpret_cast<const char*>(buffer), num_bytes));
+        return num_bytes;
+      }));
+  EXPECT_CALL(os_sys_calls, write_(6, _, _))
+      .WillOnce(Invoke([](int, const void* buffer, size_t num_bytes) -> ssize_t {
+        EXPECT_EQ("test2", std::string(reinterpret_cast<const char*>(buffer), num_bytes));
+        return num_bytes;
+      }));
+
+  file1.write("test1");
+  file2.write("test2");
+  timer1->callback_();
+  timer2->callback_();
+
+  {
+    std::unique_lock<Thread::BasicLockable> lock(os_sys_calls.write_mutex_);
+    while (os_sys_calls.num_writes_ != 4) {
+      os_sys_calls.write_event_.wait(os_sys_calls.write_mutex_);
+    }
+  }
+}
+
 TEST(FileSystemImpl, reopenFile) {
   NiceMock<Event::MockDispatcher> dispatcher;
   NiceMock<Event::MockTimer>* timer = new NiceMock<Event::MockTimer>(&dispatcher);
@@ -222,7 +284,9 @@ TEST(FileSystemImpl, reopenFile) {
 
   Sequence sq;
   EXPECT_CALL(os_sys_calls, open_(_, _, _)).InSequence(sq).WillOnce(Return(5));
-  Filesystem::FileImpl file("", dispatcher, mutex, stats_store, std::chrono::milliseconds(40));
+  Filesystem::FlushThread flush_thread;
+  Filesystem::FileImpl file("", dispatcher, mutex, flush_thread, stats_store,
+                            std::chrono::milliseconds(40));
 
   EXPECT_CALL(os_sys_calls, write_(_, _, _))
       .InSequence(sq)
@@ -291,7 +355,9 @@ TEST(FilesystemImpl, reopenThrows) {
   Sequence sq;
   EXPECT_CALL(os_sys_calls, open_(_, _, _)).InSequence(sq).WillOnce(Return(5));
 
-  Filesystem::FileImpl file("", dispatcher, mutex, stats_store, std::chrono::milliseconds(40));
+  Filesystem::FlushThread flush_thread;
+  Filesystem::FileImpl file("", dispatcher, mutex, flush_thread, stats_store,
+                            std::chrono::milliseconds(40));
   EXPECT_CALL(os_sys_calls, close(5)).InSequence(sq);
   EXPECT_CALL(os_sys_calls, open_(_, _, _)).InSequence(sq).WillOnce(Return(-1));
 
@@ -327,7 +393,9 @@ TEST(FilesystemImpl, bigDataChunkShouldBeFlushedWithoutTimer) {
   NiceMock<Api::MockOsSysCalls> os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
 
-  Filesystem::FileImpl file("", dispatcher, mutex, stats_store, std::chrono::milliseconds(40));
+  Filesystem::FlushThread flush_thread;
+  Filesystem::FileImpl file("", dispatcher, mutex, flush_thread, stats_store,
+                            std::chrono::milliseconds(40));
 
   EXPECT_CALL(os_sys_calls, write_(_, _, _))
       .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
@@ -0,0 +1,418 @@
+// Benchmarks of the HTTP/1 and HTTP/2 codecs. The codecs are driven entirely in memory: the
+// network connections are mocks whose writes are either discarded or handed straight to the peer
+// codec, so the results only measure the codecs themselves.
+//
+// Besides the time per iteration, every benchmark reports:
+//   ns_per_request: wall time per request/response exchange.
+//   allocs_per_request/alloc_bytes_per_request: heap allocations per exchange. These are only
+//     available when built with tcmalloc.
+//   wire_bytes_per_request: bytes the codecs wrote to the connections per exchange, i.e. the bytes
+//     copied into outgoing buffers.
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/http1/codec_impl.h"
+#include "common/http/http2/codec_impl.h"
+#include "common/stats/stats_impl.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#ifdef TCMALLOC
+#include "gperftools/malloc_hook.h"
+#endif
+
+#include "testing/base/public/benchmark.h"
+
+using testing::Invoke;
+using testing::NiceMock;
+using testing::_;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+// Allocations made on the benchmark thread. Only counted when built with tcmalloc.
+thread_local uint64_t allocations;
+thread_local uint64_t allocated_bytes;
+
+#ifdef TCMALLOC
+void onNewHook(const void*, size_t size) {
+  allocations++;
+  allocated_bytes += size;
+}
+#endif
+
+/**
+ * Measures the requests done by one benchmark run and reports them as per request counters.
+ */
+class RequestStats {
+public:
+  RequestStats()
+      : start_(std::chrono::steady_clock::now()), start_allocations_(allocations),
+        start_allocated_bytes_(allocated_bytes) {}
+
+  void report(benchmark::State& state, uint64_t requests, uint64_t wire_bytes) {
+    const auto elapsed = std::chrono::steady_clock::now() - start_;
+    if (requests == 0) {
+      return;
+    }
+    const double count = requests;
+    state.counters["ns_per_request"] =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / count;
+#ifdef TCMALLOC
+    state.counters["allocs_per_request"] = (allocations - start_allocations_) / count;
+    state.counters["alloc_bytes_per_request"] = (allocated_bytes - start_allocated_bytes_) / count;
+#endif
+    state.counters["wire_bytes_per_request"] = wire_bytes / count;
+    state.SetItemsProcessed(requests);
+  }
+
+private:
+  const std::chrono::steady_clock::time_point start_;
+  const uint64_t start_allocations_;
+  const uint64_t start_allocated_bytes_;
+};
+
+// Headers of a typical browser API request after passing through a front proxy.
+TestHeaderMapImpl requestHeaders(uint64_t body_size) {
+  TestHeaderMapImpl headers{
+      {":method", body_size > 0 ? "POST" : "GET"},
+      {":path", "/api/v1/accounts/1234567/orders?include=items,shipping&page=2"},
+      {":authority", "shop.example.com"},
+      {":scheme", "https"},
+      {"user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+                     "Chrome/64.0.3282.186 Safari/537.36"},
+      {"accept", "application/json, text/plain, */*"},
+      {"accept-encoding", "gzip, deflate, br"},
+      {"accept-language", "en-US,en;q=0.9"},
+      {"referer", "https://shop.example.com/account/orders"},
+      {"cookie", "session=8f1b9a3c2d4e5f60718293a4b5c6d7e8; tracking=GA1.2.1234567890.1519862400; "
+                 "preferences=currency%3DUSD%26lang%3Den"},
+      {"x-forwarded-for", "203.0.113.195, 198.51.100.17"},
+      {"x-forwarded-proto", "https"},
+      {"x-request-id", "2d1c9e6b-8f4a-4b6e-9f3d-7a5c1e0b2f48"}};
+  if (body_size > 0) {
+    headers.addCopy("content-type", "application/json");
+    headers.addCopy("content-length", std::to_string(body_size));
+  }
+  return headers;
+}
+
+TestHeaderMapImpl responseHeaders(uint64_t body_size) {
+  return TestHeaderMapImpl{{":status", "200"},
+                           {"content-type", "application/json"},
+                           {"content-length", std::to_string(body_size)},
+                           {"cache-control", "private, max-age=0, no-cache"},
+                           {"date", "Thu, 01 Mar 2018 00:00:00 GMT"},
+                           {"server", "envoy"},
+                           {"x-envoy-upstream-service-time", "12"},
+                           {"vary", "Accept-Encoding"}};
+}
+
+// Serializes the non pseudo headers of a header map as HTTP/1 header lines.
+std::string http1HeaderLines(const HeaderMap& headers) {
+  std::string lines;
+  headers.iterate(
+      [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+        if (header.key().c_str()[0] != ':') {
+          static_cast<std::string*>(context)->append(
+              fmt::format("{}: {}\r\n", header.key().c_str(), header.value().c_str()));
+        }
+        return HeaderMap::Iterate::Continue;
+      },
+      &lines);
+  return lines + "\r\n";
+}
+
+std::string http1Request(uint64_t body_size) {
+  TestHeaderMapImpl headers = requestHeaders(body_size);
+  return fmt::format("{} {} HTTP/1.1\r\nhost: {}\r\n{}{}", headers.get_(":method"),
+                     headers.get_(":path"), headers.get_(":authority"), http1HeaderLines(headers),
+                     std::string(body_size, 'a'));
+}
+
+std::string http1Response(uint64_t body_size) {
+  return fmt::format("HTTP/1.1 200 OK\r\n{}{}", http1HeaderLines(responseHeaders(body_size)),
+                     std::string(body_size, 'b'));
+}
+
+/**
+ * Server side of the benchmarks. Answers every request with a fixed response as soon as the
+ * request is complete.
+ */
+class Responder : public ServerConnectionCallbacks {
+public:
+  Responder(uint64_t body_size)
+      : response_headers_(responseHeaders(body_size)), response_body_(body_size, 'b') {}
+
+  // Http::ConnectionCallbacks
+  void onGoAway() override {}
+
+  // Http::ServerConnectionCallbacks
+  StreamDecoder& newStream(StreamEncoder& response_encoder) override {
+    ActiveRequest* request = new ActiveRequest(*this, response_encoder);
+    response_encoder.getStream().addCallbacks(*request);
+    return *request;
+  }
+
+  uint64_t responses_{};
+
+private:
+  struct ActiveRequest : public StreamDecoder, public StreamCallbacks {
+    ActiveRequest(Responder& parent, StreamEncoder& encoder) : parent_(parent), encoder_(encoder) {}
+
+    void respond() {
+      encoder_.getStream().removeCallbacks(*this);
+      parent_.responses_++;
+      const bool has_body = !parent_.response_body_.empty();
+      encoder_.encodeHeaders(parent_.response_headers_, !has_body);
+      if (has_body) {
+        Buffer::OwnedImpl body(parent_.response_body_);
+        encoder_.encodeData(body, true);
+      }
+      delete this;
+    }
+
+    // Http::StreamDecoder
+    void decode100ContinueHeaders(HeaderMapPtr&&) override {}
+    void decodeHeaders(HeaderMapPtr&&, bool end_stream) override {
+      if (end_stream) {
+        respond();
+      }
+    }
+    void decodeData(Buffer::Instance&, bool end_stream) override {
+      if (end_stream) {
+        respond();
+      }
+    }
+    void decodeTrailers(HeaderMapPtr&&) override { respond(); }
+
+    // Http::StreamCallbacks
+    void onResetStream(StreamResetReason) override { delete this; }
+    void onAboveWriteBufferHighWatermark() override {}
+    void onBelowWriteBufferLowWatermark() override {}
+
+    Responder& parent_;
+    StreamEncoder& encoder_;
+  };
+
+  const TestHeaderMapImpl response_headers_;
+  const std::string response_body_;
+};
+
+/**
+ * Client side of the benchmarks. Counts the responses that completed.
+ */
+class ResponseCounter : public ConnectionCallbacks, public StreamDecoder {
+public:
+  // Http::ConnectionCallbacks
+  void onGoAway() override {}
+
+  // Http::StreamDecoder
+  void decode100ContinueHeaders(HeaderMapPtr&&) override {}
+  void decodeHeaders(HeaderMapPtr&&, bool end_stream) override {
+    if (end_stream) {
+      responses_++;
+    }
+  }
+  void decodeData(Buffer::Instance&, bool end_stream) override {
+    if (end_stream) {
+      responses_++;
+    }
+  }
+  void decodeTrailers(HeaderMapPtr&&) override { responses_++; }
+
+  uint64_t responses_{};
+};
+
+// Sends requests to the client codec and sends the request bodies if there are any.
+void sendRequest(StreamEncoder& encoder, const HeaderMap& headers, const std::string& body) {
+  encoder.encodeHeaders(headers, body.empty());
+  if (!body.empty()) {
+    Buffer::OwnedImpl data(body);
+    encoder.encodeData(data, true);
+  }
+}
+
+// Counts and discards the bytes a codec writes to its connection.
+void discardWrites(NiceMock<Network::MockConnection>& connection, uint64_t& wire_bytes) {
+  ON_CALL(connection, write(_, _))
+      .WillByDefault(Invoke([&wire_bytes](Buffer::Instance& data, bool) -> void {
+        wire_bytes += data.length();
+        data.drain(data.length());
+      }));
+}
+
+// HTTP/1 server codec decoding requests and encoding the responses. Arguments are the body size of
+// the requests and responses and the number of pipelined requests per dispatch.
+void BM_Http1Server(benchmark::State& state) {
+  const uint64_t body_size = state.range(0);
+  const uint64_t pipeline_depth = state.range(1);
+  std::string input;
+  for (uint64_t i = 0; i < pipeline_depth; i++) {
+    input += http1Request(body_size);
+  }
+
+  uint64_t wire_bytes = 0;
+  NiceMock<Network::MockConnection> connection;
+  discardWrites(connection, wire_bytes);
+  Responder responder(body_size);
+  Http1Settings settings;
+  Http1::ServerConnectionImpl codec(connection, responder, settings);
+
+  RequestStats stats;
+  for (auto _ : state) {
+    Buffer::OwnedImpl buffer(input);
+    while (buffer.length() > 0) {
+      codec.dispatch(buffer);
+    }
+  }
+  RELEASE_ASSERT(responder.responses_ ==
+                 static_cast<uint64_t>(state.iterations()) * pipeline_depth);
+  stats.report(state, responder.responses_, wire_bytes);
+}
+BENCHMARK(BM_Http1Server)
+    ->Args({0, 1})
+    ->Args({0, 16})
+    ->Args({16 * 1024, 1})
+    ->Args({1024 * 1024, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+// HTTP/1 client codec encoding requests and decoding the responses. Arguments are the body size of
+// the requests and responses and the number of pipelined requests per dispatch.
+void BM_Http1Client(benchmark::State& state) {
+  const uint64_t body_size = state.range(0);
+  const uint64_t pipeline_depth = state.range(1);
+  const TestHeaderMapImpl headers = requestHeaders(body_size);
+  const std::string body(body_size, 'a');
+  std::string input;
+  for (uint64_t i = 0; i < pipeline_depth; i++) {
+    input += http1Response(body_size);
+  }
+
+  uint64_t wire_bytes = 0;
+  NiceMock<Network::MockConnection> connection;
+  discardWrites(connection, wire_bytes);
+  ResponseCounter counter;
+  Http1::ClientConnectionImpl codec(connection, counter);
+
+  RequestStats stats;
+  for (auto _ : state) {
+    for (uint64_t i = 0; i < pipeline_depth; i++) {
+      sendRequest(codec.newStream(counter), headers, body);
+    }
+    Buffer::OwnedImpl buffer(input);
+    codec.dispatch(buffer);
+  }
+  RELEASE_ASSERT(counter.responses_ ==
+                 static_cast<uint64_t>(state.iterations()) * pipeline_depth);
+  stats.report(state, counter.responses_, wire_bytes);
+}
+BENCHMARK(BM_Http1Client)
+    ->Args({0, 1})
+    ->Args({0, 16})
+    ->Args({16 * 1024, 1})
+    ->Args({1024 * 1024, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * Hands the bytes written to a connection to the peer codec, without recursing when the peer
+ * writes back while dispatching.
+ */
+class Http2Pipe {
+public:
+  Http2Pipe(NiceMock<Network::MockConnection>& connection, uint64_t& wire_bytes)
+      : wire_bytes_(wire_bytes) {
+    ON_CALL(connection, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) -> void {
+          wire_bytes_ += data.length();
+          buffer_.move(data);
+          if (dispatching_) {
+            return;
+          }
+          dispatching_ = true;
+          while (buffer_.length() > 0) {
+            peer_->dispatch(buffer_);
+          }
+          dispatching_ = false;
+        }));
+  }
+
+  Connection* peer_{};
+
+private:
+  uint64_t& wire_bytes_;
+  Buffer::OwnedImpl buffer_;
+  bool dispatching_{};
+};
+
+// HTTP/2 client and server codecs connected to each other, timing full request/response exchanges.
+// Arguments are the body size of the requests and responses and the number of concurrent streams.
+void BM_Http2RoundTrip(benchmark::State& state) {
+  const uint64_t body_size = state.range(0);
+  const uint64_t concurrent_streams = state.range(1);
+  const TestHeaderMapImpl headers = requestHeaders(body_size);
+  const std::string body(body_size, 'a');
+
+  uint64_t wire_bytes = 0;
+  Stats::IsolatedStoreImpl stats_store;
+  Http2Settings settings;
+  NiceMock<Network::MockConnection> client_connection;
+  NiceMock<Network::MockConnection> server_connection;
+  Http2Pipe client_to_server(client_connection, wire_bytes);
+  Http2Pipe server_to_client(server_connection, wire_bytes);
+  ResponseCounter counter;
+  Responder responder(body_size);
+  Http2::ClientConnectionImpl client(client_connection, counter, stats_store, settings);
+  Http2::ServerConnectionImpl server(server_connection, responder, stats_store, settings);
+  client_to_server.peer_ = &server;
+  server_to_client.peer_ = &client;
+
+  RequestStats stats;
+  for (auto _ : state) {
+    for (uint64_t i = 0; i < concurrent_streams; i++) {
+      sendRequest(client.newStream(counter), headers, body);
+    }
+    // Closed streams are deleted by the event loop, which is not running here.
+    client_connection.dispatcher_.to_delete_.clear();
+    server_connection.dispatcher_.to_delete_.clear();
+  }
+  RELEASE_ASSERT(counter.responses_ ==
+                 static_cast<uint64_t>(state.iterations()) * concurrent_streams);
+  stats.report(state, counter.responses_, wire_bytes);
+}
+BENCHMARK(BM_Http2RoundTrip)
+    ->Args({0, 1})
+    ->Args({0, 16})
+    ->Args({16 * 1024, 1})
+    ->Args({1024 * 1024, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Registry::initialize(spdlog::level::warn, lock);
+
+#ifdef TCMALLOC
+  RELEASE_ASSERT(MallocHook::AddNewHook(&Envoy::Http::onNewHook));
+#endif
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -1,5 +1,8 @@
+#include <algorithm>
 #include <string>
+#include <vector>
 
+#include "common/common/fmt.h"
 #include "common/http/header_map_impl.h"
 
 #include "test/test_common/printers.h"
@@ -603,5 +606,86 @@ TEST(HeaderMapImplTest, Get) {
   }
 }
 
+// Exercise the header list beyond its inline capacity, including the reuse of removed entries.
+TEST(HeaderMapImplTest, ManyHeaders) {
+  TestHeaderMapImpl headers;
+  headers.insertPath().value(std::string("/"));
+  const HeaderEntry* path = headers.Path();
+  for (uint32_t i = 0; i < 100; i++) {
+    headers.addCopy(fmt::format("header{}", i), fmt::format("value{}", i));
+  }
+  EXPECT_EQ(101UL, headers.size());
+
+  // Entries never move, so pointers to them remain valid while the map grows.
+  EXPECT_EQ(path, headers.Path());
+  EXPECT_STREQ("/", headers.Path()->value().c_str());
+  for (uint32_t i = 0; i < 100; i++) {
+    EXPECT_EQ(fmt::format("value{}", i), headers.get_(fmt::format("header{}", i)));
+  }
+
+  // Remove every other header and add new ones in their place.
+  for (uint32_t i = 0; i < 100; i += 2) {
+    headers.remove(LowerCaseString(fmt::format("header{}", i)));
+  }
+  EXPECT_EQ(51UL, headers.size());
+  for (uint32_t i = 100; i < 150; i++) {
+    headers.addCopy(fmt::format("header{}", i), fmt::format("value{}", i));
+  }
+  EXPECT_EQ(101UL, headers.size());
+
+  // Iteration order is insertion order regardless of where entries are stored.
+  std::vector<std::string> keys;
+  headers.iterate(
+      [](const Http::HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+        static_cast<std::vector<std::string>*>(context)->push_back(header.key().c_str());
+        return HeaderMap::Iterate::Continue;
+      },
+      &keys);
+  ASSERT_EQ(101UL, keys.size());
+  EXPECT_EQ(":path", keys[0]);
+  for (uint32_t i = 0; i < 50; i++) {
+    EXPECT_EQ(fmt::format("header{}", 2 * i + 1), keys[i + 1]);
+    EXPECT_EQ(fmt::format("header{}", i + 100), keys[i + 51]);
+  }
+
+  std::vector<std::string> reverse_keys;
+  headers.iterateReverse(
+      [](const Http::HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+        static_cast<std::vector<std::string>*>(context)->push_back(header.key().c_str());
+        return HeaderMap::Iterate::Continue;
+      },
+      &reverse_keys);
+  std::reverse(reverse_keys.begin(), reverse_keys.end());
+  EXPECT_EQ(keys, reverse_keys);
+
+  headers.removePath();
+  EXPECT_EQ(nullptr, headers.Path());
+  EXPECT_EQ(100UL, headers.size());
+}
+
+TEST(HeaderMapImplTest, Move) {
+  TestHeaderMapImpl headers{{":path", "/"}, {"hello", "world"}, {"host", "envoy"}};
+  for (uint32_t i = 0; i < 20; i++) {
+    headers.addCopy(fmt::format("header{}", i), "value");
+  }
+
+  TestHeaderMapImpl moved(std::move(headers));
+  EXPECT_EQ(0UL, headers.size());
+  EXPECT_EQ(nullptr, headers.Path());
+  EXPECT_EQ(nullptr, headers.Host());
+
+  EXPECT_EQ(23UL, moved.size());
+  EXPECT_STREQ("/", moved.Path()->value().c_str());
+  EXPECT_STREQ("envoy", moved.Host()->value().c_str());
+  EXPECT_EQ("world", moved.get_("hello"));
+  EXPECT_EQ("value", moved.get_("header19"));
+
+  // The moved from map is still usable.
+  headers.addCopy("foo", "bar");
+  headers.insertPath().value(std::string("/foo"));
+  EXPECT_EQ(2UL, headers.size());
+  EXPECT_STREQ("/foo", headers.Path()->value().c_str());
+}
+
 } // namespace Http
 } // namespace Envoy
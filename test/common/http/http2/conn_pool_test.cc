@@ -59,8 +59,11 @@ public:
     Event::MockTimer* connect_timer_;
   };
 
-  Http2ConnPoolImplTest()
-      : pool_(dispatcher_, host_, Upstream::ResourcePriority::Default, nullptr) {}
+  Http2ConnPoolImplTest() : Http2ConnPoolImplTest(1) {}
+
+  Http2ConnPoolImplTest(uint32_t max_active_clients)
+      : pool_(dispatcher_, host_, Upstream::ResourcePriority::Default, nullptr,
+              max_active_clients) {}
 
   ~Http2ConnPoolImplTest() {
     // Make sure all gauges are 0.
@@ -142,13 +145,16 @@ TEST_F(Http2ConnPoolImplTest, DrainConnections) {
   r2.callbacks_.outer_encoder_->encodeHeaders(HeaderMapImpl{}, true);
   expectClientConnect(1);
 
-  // This will move primary to draining and destroy draining.
+  // This will move the active client to draining. The client that was already draining keeps its
+  // request.
   pool_.drainConnections();
+
+  // This will destroy both draining clients.
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
   EXPECT_CALL(*this, onClientDestroy());
   dispatcher_.clearDeferredDeleteList();
 
-  // This will destroy draining.
-  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
   EXPECT_CALL(*this, onClientDestroy());
   dispatcher_.clearDeferredDeleteList();
 }
@@ -443,6 +449,177 @@ TEST_F(Http2ConnPoolImplTest, GoAway) {
   EXPECT_EQ(1U, cluster_->stats_.upstream_cx_close_notify_.value());
 }
 
+/**
+ * Verify that with the default settings, one connection and no max concurrent streams, streams are
+ * never queued.
+ */
+TEST_F(Http2ConnPoolImplTest, DefaultSettingsNeverQueue) {
+  InSequence s;
+  expectClientCreate();
+  std::vector<std::unique_ptr<ActiveTestRequest>> requests;
+  for (uint32_t i = 0; i < 200; i++) {
+    requests.emplace_back(new ActiveTestRequest(*this, 0));
+  }
+  expectClientConnect(0);
+  requests.emplace_back(new ActiveTestRequest(*this, 0));
+
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(*this, onClientDestroy());
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_total_.value());
+  EXPECT_EQ(201U, cluster_->stats_.upstream_rq_total_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_rq_pending_total_.value());
+}
+
+class Http2ConnPoolImplMultiConnectionTest : public Http2ConnPoolImplTest {
+public:
+  Http2ConnPoolImplMultiConnectionTest() : Http2ConnPoolImplTest(2) {}
+};
+
+/**
+ * Verify that a second connection is opened when the first one nears max concurrent streams, and
+ * that new streams then go to the connection with the fewest active streams.
+ */
+TEST_F(Http2ConnPoolImplMultiConnectionTest, LeastLoadedConnection) {
+  InSequence s;
+  // A new connection is opened at 3 active streams.
+  cluster_->http2_settings_.max_concurrent_streams_ = 4;
+
+  expectClientCreate();
+  ActiveTestRequest r1(*this, 0);
+  ActiveTestRequest r2(*this, 0);
+  ActiveTestRequest r3(*this, 0);
+  expectClientConnect(0);
+
+  expectClientCreate();
+  ActiveTestRequest r4(*this, 1);
+  expectClientConnect(1);
+  ActiveTestRequest r5(*this, 1);
+
+  EXPECT_CALL(r1.decoder_, decodeHeaders_(_, true));
+  r1.inner_decoder_->decodeHeaders(HeaderMapPtr{new HeaderMapImpl{}}, true);
+  EXPECT_CALL(r2.decoder_, decodeHeaders_(_, true));
+  r2.inner_decoder_->decodeHeaders(HeaderMapPtr{new HeaderMapImpl{}}, true);
+
+  // The first connection now has 1 active stream and the second one 2.
+  ActiveTestRequest r6(*this, 0);
+
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(*this, onClientDestroy()).Times(2);
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_total_.value());
+  EXPECT_EQ(4U, cluster_->stats_.upstream_rq_pending_failure_eject_.value());
+}
+
+/**
+ * Verify that a stream over the max requests limit fails without opening another connection.
+ */
+TEST_F(Http2ConnPoolImplMultiConnectionTest, MaxGlobalRequestsNoNewConnection) {
+  InSequence s;
+  cluster_->http2_settings_.max_concurrent_streams_ = 1;
+  cluster_->resource_manager_.reset(
+      new Upstream::ResourceManagerImpl(runtime_, "fake_key", 1024, 1024, 1, 1));
+
+  expectClientCreate();
+  ActiveTestRequest r1(*this, 0);
+  expectClientConnect(0);
+
+  ConnPoolCallbacks callbacks;
+  Http::MockStreamDecoder decoder;
+  EXPECT_CALL(dispatcher_, createClientConnection_(_, _, _, _)).Times(0);
+  EXPECT_CALL(callbacks.pool_failure_, ready());
+  EXPECT_EQ(nullptr, pool_.newStream(decoder, callbacks));
+
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(*this, onClientDestroy());
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_total_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_rq_pending_overflow_.value());
+}
+
+/**
+ * Verify that without a configured max concurrent streams, a second connection is opened once the
+ * first one has 75 active streams.
+ */
+TEST_F(Http2ConnPoolImplMultiConnectionTest, DefaultMaxConcurrentStreams) {
+  InSequence s;
+  expectClientCreate();
+  std::vector<std::unique_ptr<ActiveTestRequest>> requests;
+  for (uint32_t i = 0; i < 75; i++) {
+    requests.emplace_back(new ActiveTestRequest(*this, 0));
+  }
+  expectClientConnect(0);
+
+  expectClientCreate();
+  requests.emplace_back(new ActiveTestRequest(*this, 1));
+  expectClientConnect(1);
+  requests.emplace_back(new ActiveTestRequest(*this, 1));
+
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(*this, onClientDestroy()).Times(2);
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_total_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_rq_pending_total_.value());
+}
+
+/**
+ * Verify that streams are queued once every connection is at max concurrent streams, and that
+ * queued streams are attached when a stream finishes.
+ */
+TEST_F(Http2ConnPoolImplMultiConnectionTest, QueueWhenAllConnectionsFull) {
+  InSequence s;
+  cluster_->http2_settings_.max_concurrent_streams_ = 1;
+
+  expectClientCreate();
+  ActiveTestRequest r1(*this, 0);
+  expectClientConnect(0);
+  expectClientCreate();
+  ActiveTestRequest r2(*this, 1);
+  expectClientConnect(1);
+
+  Http::MockStreamDecoder decoder3;
+  ConnPoolCallbacks callbacks3;
+  EXPECT_NE(nullptr, pool_.newStream(decoder3, callbacks3));
+
+  Http::MockStreamDecoder decoder4;
+  ConnPoolCallbacks callbacks4;
+  ConnectionPool::Cancellable* handle4 = pool_.newStream(decoder4, callbacks4);
+  EXPECT_NE(nullptr, handle4);
+  EXPECT_EQ(2U, cluster_->stats_.upstream_rq_pending_total_.value());
+  EXPECT_EQ(2U, cluster_->stats_.upstream_rq_pending_active_.value());
+
+  handle4->cancel();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_rq_cancelled_.value());
+
+  // The first queued stream goes to the connection whose stream finished.
+  Http::StreamDecoder* inner_decoder3{};
+  NiceMock<Http::MockStreamEncoder> inner_encoder3;
+  EXPECT_CALL(*test_clients_[0].codec_, newStream(_))
+      .WillOnce(DoAll(SaveArgAddress(&inner_decoder3), ReturnRef(inner_encoder3)));
+  EXPECT_CALL(callbacks3.pool_ready_, ready());
+  EXPECT_CALL(r1.decoder_, decodeHeaders_(_, true));
+  r1.inner_decoder_->decodeHeaders(HeaderMapPtr{new HeaderMapImpl{}}, true);
+  EXPECT_EQ(0U, cluster_->stats_.upstream_rq_pending_active_.value());
+
+  EXPECT_CALL(decoder3, decodeHeaders_(_, true));
+  inner_decoder3->decodeHeaders(HeaderMapPtr{new HeaderMapImpl{}}, true);
+  EXPECT_CALL(r2.decoder_, decodeHeaders_(_, true));
+  r2.inner_decoder_->decodeHeaders(HeaderMapPtr{new HeaderMapImpl{}}, true);
+
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(*this, onClientDestroy()).Times(2);
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(3U, cluster_->stats_.upstream_rq_total_.value());
+}
+
 } // namespace Http2
 } // namespace Http
 } // namespace Envoy
@@ -0,0 +1,109 @@
+#include <string>
+
+#include "envoy/json/json_object.h"
+
+#include "common/json/json_streaming_parser.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Json {
+
+// Records the parser's callbacks as a string.
+class TestCallbacks : public StreamingParserCallbacks {
+public:
+  void onStartObject() override { events_ += "{"; }
+  void onKey(const std::string& key) override { events_ += key + ":"; }
+  void onEndObject() override { events_ += "}"; }
+  void onStartArray() override { events_ += "["; }
+  void onEndArray() override { events_ += "]"; }
+  void onString(const std::string& value) override { events_ += "'" + value + "' "; }
+  void onNumber(double value) override { events_ += std::to_string(value) + " "; }
+  void onBool(bool value) override { events_ += value ? "true " : "false "; }
+  void onNull() override { events_ += "null "; }
+
+  std::string events_;
+};
+
+std::string parse(const std::string& json, uint32_t max_depth = 16) {
+  TestCallbacks callbacks;
+  StreamingParser parser(callbacks, max_depth);
+  parser.parse(json.data(), json.size());
+  parser.finish();
+  return callbacks.events_;
+}
+
+TEST(JsonStreamingParserTest, Values) {
+  EXPECT_EQ("{a:'b' c:1.500000 d:[true false null ]e:{}f:[]}",
+            parse(R"EOF({"a": "b", "c": 1.5, "d": [true, false, null], "e": {}, "f": []})EOF"));
+  EXPECT_EQ("'hello' ", parse(" \"hello\" \n"));
+  EXPECT_EQ("-12.000000 ", parse("-12"));
+  EXPECT_EQ("[0.000000 -0.250000 1500.000000 -0.120000 100.000000 ]",
+            parse("[0, -0.25, 1.5e3, -12E-2, 1e+2]"));
+}
+
+// A document split at any offset is parsed the same as the whole document.
+TEST(JsonStreamingParserTest, Chunks) {
+  const std::string json = R"EOF({"TableName": "locations",
+      "Partitions": {"p1": 0.5, "p\u00e9": -1e2}, "ok": [true]})EOF";
+  const std::string expected = parse(json);
+
+  for (size_t split = 0; split <= json.size(); split++) {
+    TestCallbacks callbacks;
+    StreamingParser parser(callbacks, 16);
+    parser.parse(json.data(), split);
+    parser.parse(json.data() + split, json.size() - split);
+    parser.finish();
+    EXPECT_EQ(expected, callbacks.events_);
+  }
+
+  TestCallbacks callbacks;
+  StreamingParser parser(callbacks, 16);
+  for (char c : json) {
+    parser.parse(&c, 1);
+  }
+  parser.finish();
+  EXPECT_EQ(expected, callbacks.events_);
+}
+
+TEST(JsonStreamingParserTest, Escapes) {
+  EXPECT_EQ("'a\"\\/\b\f\n\r\tb' ", parse(R"EOF("a\"\\\/\b\f\n\r\tb")EOF"));
+  EXPECT_EQ("'\x41\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80' ",
+            parse(R"EOF("\u0041\u00E9\u20ac\ud83d\ude00")EOF"));
+  EXPECT_EQ("{\xc3\xa9:null }", parse(R"EOF({"\u00e9": null})EOF"));
+}
+
+TEST(JsonStreamingParserTest, MaxDepth) {
+  const std::string json = R"EOF({"a": {"b": {"c": "d"}, "e": [1, [2]]}, "f": 3})EOF";
+  EXPECT_EQ("{a:{b:{c:'d' }e:[1.000000 [2.000000 ]]}f:3.000000 }", parse(json));
+  EXPECT_EQ("{a:{b:e:}f:3.000000 }", parse(json, 2));
+  EXPECT_EQ("{a:f:3.000000 }", parse(json, 1));
+  EXPECT_EQ("", parse(json, 0));
+  EXPECT_EQ("'top' ", parse("\"top\"", 0));
+}
+
+TEST(JsonStreamingParserTest, Invalid) {
+  for (const std::string json :
+       {"", " ", "{", "[1,]", "{\"a\":1,}", "{\"a\" 1}", "{1:2}", "[1 2]", "[1}", "{\"a\":1]",
+        "{} {}", "01", "1.", "1.e2", "-", "-a", "1e", "1e+", "+1", ".5", "tru", "nul", "nulL",
+        "\"abc", "\"\\x\"", "\"\\u12g4\"", "\"\\ud800\"", "\"\\ud800a\"", "\"\\ud800\\n\"",
+        "\"\\ud800\\ud800\"", "\"\\udc00\"", "\"\\ud800\\u0041\"", "\"a\nb\"", "[1]]", "}"}) {
+    EXPECT_THROW(parse(json), Exception) << json;
+    EXPECT_THROW(parse(json, 0), Exception) << json;
+  }
+}
+
+TEST(JsonStreamingParserTest, ErrorOffset) {
+  TestCallbacks callbacks;
+  StreamingParser parser(callbacks, 16);
+  parser.parse("{\"a\":", 5);
+  try {
+    parser.parse(" 1 2", 4);
+    FAIL();
+  } catch (const Exception& e) {
+    EXPECT_STREQ("JSON supplied is not valid. Error(offset 8): expected ',' or '}'", e.what());
+  }
+}
+
+} // namespace Json
+} // namespace Envoy
@@ -4,6 +4,7 @@
 #include "common/mongo/bson_impl.h"
 
 #include "test/test_common/printers.h"
+#include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
 
@@ -48,6 +49,80 @@ TEST(BsonImplTest, InvalodDocumentTermination) {
   EXPECT_THROW(DocumentImpl::create(buffer), EnvoyException);
 }
 
+TEST(BsonImplTest, InvalidStringLength) {
+  Buffer::OwnedImpl buffer;
+  DocumentImpl::create()->addString("hello", "world")->encode(buffer);
+  // Make the string length, which follows the document length, type and key, run past the end of
+  // the document.
+  std::string bytes = TestUtility::bufferToString(buffer);
+  bytes[4 + 1 + 6] = 100;
+  Buffer::OwnedImpl corrupted(bytes);
+  EXPECT_THROW(DocumentImpl::create(corrupted), EnvoyException);
+}
+
+TEST(BsonImplTest, InvalidSubDocument) {
+  Buffer::OwnedImpl buffer;
+  DocumentImpl::create()
+      ->addDocument("hello", DocumentImpl::create()->addInt32("world", 1))
+      ->encode(buffer);
+  // Corrupt the terminating byte of the sub-document, which is second to last.
+  std::string bytes = TestUtility::bufferToString(buffer);
+  bytes[bytes.size() - 2] = 1;
+  Buffer::OwnedImpl corrupted(bytes);
+  EXPECT_THROW(DocumentImpl::create(corrupted), EnvoyException);
+}
+
+// A document read from a buffer is decoded lazily, and is equal to the document it was encoded
+// from.
+TEST(BsonImplTest, LazyDocument) {
+  Field::ObjectId object_id;
+  object_id.fill(0x42);
+  DocumentSharedPtr doc =
+      DocumentImpl::create()
+          ->addDouble("double", 2.0)
+          ->addString("string", "hello")
+          ->addDocument("document", DocumentImpl::create()->addString("$comment", "comment"))
+          ->addArray("array", DocumentImpl::create()->addInt32("0", 1)->addInt32("1", 2))
+          ->addBinary("binary", std::string("bin\0ary", 7))
+          ->addObjectId("object_id", std::move(object_id))
+          ->addBoolean("boolean", true)
+          ->addDatetime("datetime", 1)
+          ->addNull("null")
+          ->addRegex("regex", {"pattern", "options"})
+          ->addInt32("int32", -1)
+          ->addTimestamp("timestamp", 2)
+          ->addInt64("int64", -3);
+
+  Buffer::OwnedImpl buffer;
+  doc->encode(buffer);
+  const std::string bytes = TestUtility::bufferToString(buffer);
+  DocumentSharedPtr lazy_doc = DocumentImpl::create(buffer);
+  EXPECT_EQ(0UL, buffer.length());
+  EXPECT_EQ(doc->byteSize(), lazy_doc->byteSize());
+
+  EXPECT_EQ(nullptr, lazy_doc->find("missing"));
+  EXPECT_EQ(nullptr, lazy_doc->find("string", Field::Type::INT32));
+  const Field* document = lazy_doc->find("document", Field::Type::DOCUMENT);
+  ASSERT_NE(nullptr, document);
+  EXPECT_EQ("comment", document->asDocument().find("$comment")->asString());
+
+  // Fields that have been found are kept when all of the fields are created.
+  EXPECT_TRUE(*doc == *lazy_doc);
+  EXPECT_EQ(document, lazy_doc->find("document"));
+  EXPECT_EQ(doc->toString(), lazy_doc->toString());
+
+  lazy_doc->encode(buffer);
+  EXPECT_EQ(bytes, TestUtility::bufferToString(buffer));
+  buffer.drain(buffer.length());
+
+  // A modified document is encoded from its fields.
+  lazy_doc->addString("added", "field");
+  doc->addString("added", "field");
+  EXPECT_EQ(doc->byteSize(), lazy_doc->byteSize());
+  lazy_doc->encode(buffer);
+  EXPECT_TRUE(*doc == *DocumentImpl::create(buffer));
+}
+
 TEST(BufferHelperTest, InvalidSize) {
   Buffer::OwnedImpl buffer;
   EXPECT_THROW(BufferHelper::peakInt32(buffer), EnvoyException);
@@ -0,0 +1,45 @@
+#include "common/network/adaptive_read_size.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Network {
+
+TEST(AdaptiveReadSizeTest, GrowsOnFullReads) {
+  AdaptiveReadSize read_size;
+  EXPECT_EQ(AdaptiveReadSize::INITIAL_READ_SIZE, read_size.readSize(0));
+
+  read_size.onReadEvent(AdaptiveReadSize::INITIAL_READ_SIZE);
+  EXPECT_EQ(2 * AdaptiveReadSize::INITIAL_READ_SIZE, read_size.readSize(0));
+
+  for (int i = 0; i < 10; i++) {
+    read_size.onReadEvent(1024 * 1024);
+  }
+  EXPECT_EQ(AdaptiveReadSize::MAX_READ_SIZE, read_size.readSize(0));
+}
+
+TEST(AdaptiveReadSizeTest, ShrinksOnSmallReads) {
+  AdaptiveReadSize read_size;
+
+  // Reads of at least a quarter of the read size keep it.
+  read_size.onReadEvent(AdaptiveReadSize::INITIAL_READ_SIZE / 4);
+  EXPECT_EQ(AdaptiveReadSize::INITIAL_READ_SIZE, read_size.readSize(0));
+
+  read_size.onReadEvent(100);
+  EXPECT_EQ(AdaptiveReadSize::INITIAL_READ_SIZE / 2, read_size.readSize(0));
+
+  for (int i = 0; i < 10; i++) {
+    read_size.onReadEvent(0);
+  }
+  EXPECT_EQ(AdaptiveReadSize::MIN_READ_SIZE, read_size.readSize(0));
+}
+
+TEST(AdaptiveReadSizeTest, BufferLimit) {
+  AdaptiveReadSize read_size;
+  EXPECT_EQ(8192UL, read_size.readSize(8192));
+  EXPECT_EQ(AdaptiveReadSize::MIN_READ_SIZE, read_size.readSize(1));
+  EXPECT_EQ(AdaptiveReadSize::INITIAL_READ_SIZE, read_size.readSize(1024 * 1024));
+}
+
+} // namespace Network
+} // namespace Envoy
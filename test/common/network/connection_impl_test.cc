@@ -978,6 +978,47 @@ TEST_F(MockTransportConnectionImplTest, HalfCloseWrite) {
   connection_->write(buffer, true);
 }
 
+// Test that the bytes held in the read and write buffers are charged to the buffer memory account,
+// and credited back when the connection is closed.
+TEST_F(MockTransportConnectionImplTest, BufferMemoryAccount) {
+  class TestAccount : public Buffer::MemoryAccount {
+  public:
+    void charge(uint64_t bytes) override { balance_ += bytes; }
+    void credit(uint64_t bytes) override {
+      ASSERT_GE(balance_, bytes);
+      balance_ -= bytes;
+    }
+
+    uint64_t balance_{};
+  };
+
+  TestAccount account;
+  connection_->setBufferMemoryAccount(&account);
+  EXPECT_EQ(0UL, account.balance_);
+
+  Buffer::OwnedImpl buffer("some data");
+  EXPECT_CALL(*file_event_, activate(Event::FileReadyType::Write));
+  connection_->write(buffer, false);
+  EXPECT_EQ(9UL, account.balance_);
+
+  std::shared_ptr<MockReadFilter> read_filter(new NiceMock<MockReadFilter>());
+  connection_->addReadFilter(read_filter);
+  EXPECT_CALL(*transport_socket_, doRead(_))
+      .WillOnce(Invoke([](Buffer::Instance& read_buffer) -> IoResult {
+        read_buffer.add("hello");
+        return {PostIoAction::KeepOpen, 5, false};
+      }));
+  file_ready_cb_(Event::FileReadyType::Read);
+  EXPECT_EQ(14UL, account.balance_);
+
+  EXPECT_CALL(*transport_socket_, doWrite(_, false)).WillOnce(Invoke(SimulateSuccessfulWrite));
+  file_ready_cb_(Event::FileReadyType::Write);
+  EXPECT_EQ(5UL, account.balance_);
+
+  connection_->close(ConnectionCloseType::NoFlush);
+  EXPECT_EQ(0UL, account.balance_);
+}
+
 TEST_F(MockTransportConnectionImplTest, ReadMultipleEndStream) {
   std::shared_ptr<MockReadFilter> read_filter(new NiceMock<MockReadFilter>());
   connection_->enableHalfClose(true);
@@ -1,7 +1,10 @@
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
+#include "common/common/fmt.h"
 #include "common/redis/codec_impl.h"
 
 #include "test/mocks/redis/mocks.h"
@@ -155,6 +158,48 @@ TEST_F(RedisEncoderDecoderImplTest, NestedArray) {
   EXPECT_EQ(value, *decoded_values_[0]);
 }
 
+TEST_F(RedisEncoderDecoderImplTest, BufferedBulkString) {
+  const std::string body(DecoderImpl::MinBufferedBulkStringSize, 'a');
+  const std::string request =
+      fmt::format("*3\r\n$3\r\nset\r\n$3\r\nfoo\r\n${}\r\n{}\r\n", body.size(), body);
+
+  // Feed the request in pieces so that the body is moved from several buffers.
+  for (uint64_t i = 0; i < request.size(); i += 1000) {
+    Buffer::OwnedImpl temp_buffer(request.substr(i, 1000));
+    decoder_.decode(temp_buffer);
+    EXPECT_EQ(0UL, temp_buffer.length());
+  }
+
+  ASSERT_EQ(1UL, decoded_values_.size());
+  RespValue& value = *decoded_values_[0];
+  EXPECT_EQ(nullptr, value.asArray()[1].asBuffer());
+  std::shared_ptr<Buffer::Instance> value_buffer = value.asArray()[2].asBuffer();
+  ASSERT_NE(nullptr, value_buffer);
+  EXPECT_EQ(body, TestUtility::bufferToString(*value_buffer));
+
+  // Encoding references the value's buffer, which is released once the output is drained.
+  encoder_.encode(value, buffer_);
+  EXPECT_EQ(request, TestUtility::bufferToString(buffer_));
+  decoded_values_.clear();
+  EXPECT_LT(1, value_buffer.use_count());
+  buffer_.drain(buffer_.length());
+  EXPECT_EQ(1, value_buffer.use_count());
+}
+
+TEST_F(RedisEncoderDecoderImplTest, BufferedBulkStringAsString) {
+  const std::string body(DecoderImpl::MinBufferedBulkStringSize, 'a');
+  buffer_.add(fmt::format("${}\r\n{}\r\n", body.size(), body));
+  decoder_.decode(buffer_);
+  EXPECT_EQ(0UL, buffer_.length());
+
+  RespValue& value = *decoded_values_[0];
+  ASSERT_NE(nullptr, value.asBuffer());
+  EXPECT_EQ(fmt::format("\"{}\"", body), value.toString());
+  EXPECT_NE(nullptr, value.asBuffer());
+  EXPECT_EQ(body, value.asString());
+  EXPECT_EQ(nullptr, value.asBuffer());
+}
+
 TEST_F(RedisEncoderDecoderImplTest, NullArray) {
   buffer_.add("*-1\r\n");
   decoder_.decode(buffer_);
@@ -1,8 +1,10 @@
 #include <cstdint>
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/fmt.h"
 #include "common/redis/command_splitter_impl.h"
 #include "common/redis/supported_commands.h"
@@ -19,6 +21,7 @@ using testing::ByRef;
 using testing::DoAll;
 using testing::Eq;
 using testing::InSequence;
+using testing::Invoke;
 using testing::Ref;
 using testing::Return;
 using testing::WithArg;
@@ -331,6 +334,23 @@ TEST_F(RedisMGETCommandHandlerTest, Normal) {
   EXPECT_EQ(1UL, store_.counter("redis.foo.command.mget.total").value());
 };
 
+TEST_F(RedisMGETCommandHandlerTest, BufferedResponse) {
+  InSequence s;
+
+  setup(1, {});
+  EXPECT_NE(nullptr, handle_);
+
+  // The buffer of a buffered bulk string is moved into the response without copying it.
+  std::shared_ptr<Buffer::Instance> buffer(new Buffer::OwnedImpl("response"));
+  RespValuePtr response1(new RespValue());
+  response1->type(RespType::BulkString);
+  response1->asBuffer() = buffer;
+  EXPECT_CALL(callbacks_, onResponse_(_)).WillOnce(Invoke([&](RespValuePtr& response) -> void {
+    EXPECT_EQ(buffer, response->asArray()[0].asBuffer());
+  }));
+  pool_callbacks_[0]->onResponse(std::move(response1));
+};
+
 TEST_F(RedisMGETCommandHandlerTest, NormalWithNull) {
   InSequence s;
 
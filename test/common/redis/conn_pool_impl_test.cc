@@ -5,8 +5,10 @@
 #include "common/redis/conn_pool_impl.h"
 #include "common/upstream/upstream_impl.h"
 
+#include "test/common/upstream/utility.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/redis/mocks.h"
+#include "test/mocks/runtime/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/printers.h"
@@ -17,10 +19,13 @@
 using testing::Eq;
 using testing::InSequence;
 using testing::Invoke;
+using testing::IsNull;
+using testing::NotNull;
 using testing::Ref;
 using testing::Return;
 using testing::ReturnRef;
 using testing::SaveArg;
+using testing::Truly;
 using testing::_;
 
 namespace Envoy {
@@ -55,7 +60,7 @@ public:
   }
 
   void setup() {
-    config_.reset(new ConfigImpl(createConnPoolSettings()));
+    config_.reset(new ConfigImpl(createConnPoolSettings(), runtime_));
     finishSetup();
   }
 
@@ -98,6 +103,7 @@ public:
   DecoderCallbacks* callbacks_{};
   NiceMock<Network::MockClientConnection>* upstream_connection_{};
   Network::ReadFilterSharedPtr upstream_read_filter_;
+  NiceMock<Runtime::MockLoader> runtime_;
   std::unique_ptr<Config> config_;
   ClientPtr client_;
 };
@@ -297,6 +303,7 @@ TEST_F(RedisClientImplTest, ConnectFail) {
 class ConfigOutlierDisabled : public Config {
   bool disableOutlierEvents() const override { return true; }
   std::chrono::milliseconds opTimeout() const override { return std::chrono::milliseconds(25); }
+  uint32_t maxBufferSizeBeforeFlush() const override { return 0; }
 };
 
 TEST_F(RedisClientImplTest, OutlierDisabled) {
@@ -319,6 +326,64 @@ TEST_F(RedisClientImplTest, OutlierDisabled) {
   EXPECT_EQ(1UL, host_->stats_.cx_connect_fail_.value());
 }
 
+class ConfigBufferRequests : public Config {
+  bool disableOutlierEvents() const override { return false; }
+  std::chrono::milliseconds opTimeout() const override { return std::chrono::milliseconds(25); }
+  uint32_t maxBufferSizeBeforeFlush() const override { return 8; }
+};
+
+TEST_F(RedisClientImplTest, BufferRequests) {
+  InSequence s;
+
+  setup(std::make_unique<ConfigBufferRequests>());
+
+  // Null requests are encoded in 5 bytes, so the second request in a row fills the buffer.
+  RespValue request1;
+  MockPoolCallbacks callbacks1;
+  EXPECT_CALL(*encoder_, encode(Ref(request1), _));
+  Event::MockTimer* flush_timer = new Event::MockTimer(&dispatcher_);
+  EXPECT_CALL(*flush_timer, enableTimer(std::chrono::milliseconds(0)));
+  EXPECT_NE(nullptr, client_->makeRequest(request1, callbacks1));
+
+  onConnected();
+
+  RespValue request2;
+  MockPoolCallbacks callbacks2;
+  EXPECT_CALL(*encoder_, encode(Ref(request2), _));
+  EXPECT_CALL(*flush_timer, disableTimer());
+  EXPECT_CALL(*upstream_connection_, write(_, false))
+      .WillOnce(Invoke([](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ(10UL, data.length());
+        data.drain(data.length());
+      }));
+  EXPECT_NE(nullptr, client_->makeRequest(request2, callbacks2));
+  EXPECT_EQ(1UL, host_->cluster_.stats_store_.counter("redis.batch_flush_buffer_full").value());
+
+  // A request below the limit is written on the next dispatcher loop iteration.
+  RespValue request3;
+  MockPoolCallbacks callbacks3;
+  EXPECT_CALL(*encoder_, encode(Ref(request3), _));
+  EXPECT_CALL(*flush_timer, enableTimer(std::chrono::milliseconds(0)));
+  EXPECT_NE(nullptr, client_->makeRequest(request3, callbacks3));
+
+  EXPECT_CALL(*flush_timer, disableTimer());
+  EXPECT_CALL(*upstream_connection_, write(_, false))
+      .WillOnce(Invoke([](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ(5UL, data.length());
+        data.drain(data.length());
+      }));
+  flush_timer->callback_();
+  EXPECT_EQ(1UL, host_->cluster_.stats_store_.counter("redis.batch_flush_loop").value());
+
+  EXPECT_CALL(*upstream_connection_, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(callbacks1, onFailure());
+  EXPECT_CALL(callbacks2, onFailure());
+  EXPECT_CALL(callbacks3, onFailure());
+  EXPECT_CALL(*connect_or_op_timer_, disableTimer());
+  EXPECT_CALL(*flush_timer, disableTimer());
+  client_->close();
+}
+
 TEST_F(RedisClientImplTest, ConnectTimeout) {
   InSequence s;
 
@@ -363,6 +428,18 @@ TEST_F(RedisClientImplTest, OpTimeout) {
   EXPECT_EQ(1UL, host_->stats_.rq_timeout_.value());
 }
 
+TEST(RedisClusterSlotUtilityTest, HashSlot) {
+  EXPECT_EQ(12739U, ClusterSlotUtility::hashSlot("123456789"));
+  EXPECT_EQ(12182U, ClusterSlotUtility::hashSlot("foo"));
+  EXPECT_EQ(3443U, ClusterSlotUtility::hashSlot("user1000"));
+
+  // Only the hash tag is hashed, unless it is empty.
+  EXPECT_EQ(3443U, ClusterSlotUtility::hashSlot("{user1000}.following"));
+  EXPECT_EQ(ClusterSlotUtility::hashSlot("bar"), ClusterSlotUtility::hashSlot("foo{bar}{zap}"));
+  EXPECT_EQ(ClusterSlotUtility::hashSlot("{bar"), ClusterSlotUtility::hashSlot("foo{{bar}}zap"));
+  EXPECT_NE(ClusterSlotUtility::hashSlot("bar"), ClusterSlotUtility::hashSlot("foo{}{bar}"));
+}
+
 TEST(RedisClientFactoryImplTest, Basic) {
   ClientFactoryImpl factory;
   Upstream::MockHost::MockCreateConnectionData conn_info;
@@ -370,7 +447,8 @@ TEST(RedisClientFactoryImplTest, Basic) {
   std::shared_ptr<Upstream::MockHost> host(new NiceMock<Upstream::MockHost>());
   EXPECT_CALL(*host, createConnection_(_, _)).WillOnce(Return(conn_info));
   NiceMock<Event::MockDispatcher> dispatcher;
-  ConfigImpl config(createConnPoolSettings());
+  NiceMock<Runtime::MockLoader> runtime;
+  ConfigImpl config(createConnPoolSettings(), runtime);
   ClientPtr client = factory.create(host, dispatcher, config);
   client->close();
 }
@@ -378,7 +456,8 @@ TEST(RedisClientFactoryImplTest, Basic) {
 class RedisConnPoolImplTest : public testing::Test, public ClientFactory {
 public:
   RedisConnPoolImplTest() {
-    conn_pool_.reset(new InstanceImpl(cluster_name_, cm_, *this, tls_, createConnPoolSettings()));
+    conn_pool_.reset(
+        new InstanceImpl(cluster_name_, cm_, *this, tls_, createConnPoolSettings(), runtime_));
   }
 
   // Redis::ConnPool::ClientFactory
@@ -391,6 +470,7 @@ public:
   const std::string cluster_name_{"foo"};
   NiceMock<Upstream::MockClusterManager> cm_;
   NiceMock<ThreadLocal::MockInstance> tls_;
+  NiceMock<Runtime::MockLoader> runtime_;
   InstancePtr conn_pool_;
 };
 
@@ -491,6 +571,154 @@ TEST_F(RedisConnPoolImplTest, RemoteClose) {
   tls_.shutdownThread();
 }
 
+void makeRequestValue(const std::vector<std::string>& arguments, RespValue& request) {
+  std::vector<RespValue> values(arguments.size());
+  for (uint64_t i = 0; i < arguments.size(); i++) {
+    values[i].type(RespType::BulkString);
+    values[i].asString() = arguments[i];
+  }
+  request.type(RespType::Array);
+  request.asArray().swap(values);
+}
+
+void makeClusterNode(const std::string& ip, int64_t port, RespValue& node) {
+  std::vector<RespValue> values(2);
+  values[0].type(RespType::BulkString);
+  values[0].asString() = ip;
+  values[1].type(RespType::Integer);
+  values[1].asInteger() = port;
+  node.type(RespType::Array);
+  node.asArray().swap(values);
+}
+
+// With CLUSTER SLOTS discovery enabled, reads go to the least active healthy replica of the key's
+// slot and writes to its master.
+TEST_F(RedisConnPoolImplTest, ClusterSlots) {
+  Upstream::MockHostSet& host_set =
+      *cm_.thread_local_cluster_.cluster_.prioritySet().getMockHostSet(0);
+  Upstream::ClusterInfoConstSharedPtr info = cm_.thread_local_cluster_.cluster_.info_;
+  Upstream::HostSharedPtr master = Upstream::makeTestHost(info, "tcp://10.0.0.1:6379");
+  Upstream::HostSharedPtr replica1 = Upstream::makeTestHost(info, "tcp://10.0.0.2:6379");
+  Upstream::HostSharedPtr replica2 = Upstream::makeTestHost(info, "tcp://10.0.0.3:6379");
+  host_set.hosts_ = {master, replica1, replica2};
+
+  EXPECT_CALL(runtime_.snapshot_, getInteger("redis.cluster_slots_refresh_interval_ms", 0))
+      .WillRepeatedly(Return(1000));
+  // Pools that never serve requests, such as the main thread's, do not start discovery.
+  EXPECT_CALL(tls_.dispatcher_, createTimer_(_)).Times(0);
+  conn_pool_.reset(
+      new InstanceImpl(cluster_name_, cm_, *this, tls_, createConnPoolSettings(), runtime_));
+
+  // The first request starts discovery, and is load balanced until the slot table is known.
+  RespValue get;
+  makeRequestValue({"GET", "foo"}, get);
+  MockPoolCallbacks callbacks;
+  MockPoolRequest active_request;
+  MockClient* master_client = new NiceMock<MockClient>();
+  Event::MockTimer* refresh_timer = new Event::MockTimer(&tls_.dispatcher_);
+  EXPECT_CALL(*refresh_timer, enableTimer(std::chrono::milliseconds(0)));
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(NotNull())).WillOnce(Return(master));
+  EXPECT_CALL(*this, create_(Eq(master))).WillOnce(Return(master_client));
+  EXPECT_CALL(*master_client, makeRequest(Ref(get), Ref(callbacks)))
+      .WillOnce(Return(&active_request));
+  EXPECT_EQ(&active_request, conn_pool_->makeRequest("foo", get, callbacks));
+
+  // Discovery asks a load balanced host for the slot table.
+  MockPoolRequest cluster_slots_request;
+  PoolCallbacks* cluster_slots_callbacks{};
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(IsNull())).WillOnce(Return(master));
+  EXPECT_CALL(*master_client, makeRequest(Truly([](const RespValue& value) -> bool {
+                                            return value.toString() == "[\"CLUSTER\", \"SLOTS\"]";
+                                          }),
+                                          _))
+      .WillOnce(Invoke([&](const RespValue&, PoolCallbacks& callbacks) -> PoolRequest* {
+        cluster_slots_callbacks = &callbacks;
+        return &cluster_slots_request;
+      }));
+  refresh_timer->callback_();
+
+  // A single shard serves every slot. The unknown replica is ignored.
+  RespValuePtr cluster_slots(new RespValue());
+  std::vector<RespValue> slot_range(6);
+  slot_range[0].type(RespType::Integer);
+  slot_range[0].asInteger() = 0;
+  slot_range[1].type(RespType::Integer);
+  slot_range[1].asInteger() = 16383;
+  makeClusterNode("10.0.0.1", 6379, slot_range[2]);
+  makeClusterNode("10.0.0.2", 6379, slot_range[3]);
+  makeClusterNode("10.0.0.3", 6379, slot_range[4]);
+  makeClusterNode("10.0.0.9", 6379, slot_range[5]);
+  std::vector<RespValue> slot_ranges(1);
+  slot_ranges[0].type(RespType::Array);
+  slot_ranges[0].asArray().swap(slot_range);
+  cluster_slots->type(RespType::Array);
+  cluster_slots->asArray().swap(slot_ranges);
+  EXPECT_CALL(*refresh_timer, enableTimer(std::chrono::milliseconds(1000)));
+  cluster_slots_callbacks->onResponse(std::move(cluster_slots));
+
+  // The first read on a replica connection is preceded by READONLY.
+  replica1->stats().rq_active_.set(1);
+  MockClient* replica_client = new NiceMock<MockClient>();
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_)).Times(0);
+  EXPECT_CALL(*this, create_(Eq(replica2))).WillOnce(Return(replica_client));
+  {
+    InSequence s;
+    EXPECT_CALL(*replica_client, makeRequest(Truly([](const RespValue& value) -> bool {
+                                               return value.toString() == "[\"READONLY\"]";
+                                             }),
+                                             _));
+    EXPECT_CALL(*replica_client, makeRequest(Ref(get), Ref(callbacks)))
+        .WillOnce(Return(&active_request));
+  }
+  EXPECT_EQ(&active_request, conn_pool_->makeRequest("foo", get, callbacks));
+
+  EXPECT_CALL(*replica_client, makeRequest(Ref(get), Ref(callbacks)))
+      .WillOnce(Return(&active_request));
+  EXPECT_EQ(&active_request, conn_pool_->makeRequest("foo", get, callbacks));
+
+  RespValue set;
+  makeRequestValue({"SET", "foo", "bar"}, set);
+  EXPECT_CALL(*master_client, makeRequest(Ref(set), Ref(callbacks)))
+      .WillOnce(Return(&active_request));
+  EXPECT_EQ(&active_request, conn_pool_->makeRequest("foo", set, callbacks));
+
+  // Reads go to the master when no replica is healthy.
+  replica1->healthFlagSet(Upstream::Host::HealthFlag::FAILED_ACTIVE_HC);
+  replica2->healthFlagSet(Upstream::Host::HealthFlag::FAILED_ACTIVE_HC);
+  EXPECT_CALL(*master_client, makeRequest(Ref(get), Ref(callbacks)))
+      .WillOnce(Return(&active_request));
+  EXPECT_EQ(&active_request, conn_pool_->makeRequest("foo", get, callbacks));
+
+  // Unhealthy replicas are skipped even when they are less active.
+  replica1->healthFlagClear(Upstream::Host::HealthFlag::FAILED_ACTIVE_HC);
+  MockClient* replica1_client = new NiceMock<MockClient>();
+  EXPECT_CALL(*this, create_(Eq(replica1))).WillOnce(Return(replica1_client));
+  {
+    InSequence s;
+    EXPECT_CALL(*replica1_client, makeRequest(Truly([](const RespValue& value) -> bool {
+                                                return value.toString() == "[\"READONLY\"]";
+                                              }),
+                                              _));
+    EXPECT_CALL(*replica1_client, makeRequest(Ref(get), Ref(callbacks)))
+        .WillOnce(Return(&active_request));
+  }
+  EXPECT_EQ(&active_request, conn_pool_->makeRequest("foo", get, callbacks));
+  testing::Mock::VerifyAndClearExpectations(&cm_.thread_local_cluster_.lb_);
+
+  // Removing a host drops the slot table until it is refreshed.
+  EXPECT_CALL(*refresh_timer, enableTimer(std::chrono::milliseconds(0)));
+  EXPECT_CALL(*replica1_client, close());
+  host_set.runCallbacks({}, {replica1});
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_)).WillOnce(Return(master));
+  EXPECT_CALL(*master_client, makeRequest(Ref(get), Ref(callbacks)))
+      .WillOnce(Return(&active_request));
+  EXPECT_EQ(&active_request, conn_pool_->makeRequest("foo", get, callbacks));
+
+  EXPECT_CALL(*master_client, close());
+  EXPECT_CALL(*replica_client, close());
+  tls_.shutdownThread();
+}
+
 } // namespace ConnPool
 } // namespace Redis
 } // namespace Envoy
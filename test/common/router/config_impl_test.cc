@@ -1035,6 +1035,125 @@ TEST(RouteMatcherTest, HeaderMatchedRouting) {
   }
 }
 
+// Routes are indexed by path, but the first route in configuration order must still win when
+// several route types match the same request.
+TEST(RouteMatcherTest, FirstMatchAcrossRouteTypes) {
+  const std::string yaml = R"EOF(
+name: foo
+virtual_hosts:
+  - name: local_service
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/api/v1", headers: [{ name: "x-canary", value: "true" }] }
+        route: { cluster: canary }
+      - match: { regex: "/api/v[0-9]+/users" }
+        route: { cluster: users_regex }
+      - match: { path: "/api/v1/users" }
+        route: { cluster: users_exact }
+      - match: { prefix: "/API/V1", case_sensitive: false }
+        route: { cluster: api_v1 }
+      - match: { path: "/health" }
+        route: { cluster: health }
+      - match: { prefix: "/" }
+        route: { cluster: default }
+  )EOF";
+
+  NiceMock<Runtime::MockLoader> runtime;
+  NiceMock<Upstream::MockClusterManager> cm;
+  ConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), runtime, cm, true);
+
+  {
+    Http::TestHeaderMapImpl headers = genHeaders("example.com", "/api/v1/users", "GET");
+    headers.addCopy("x-canary", "true");
+    EXPECT_EQ("canary", config.route(headers, 0)->routeEntry()->clusterName());
+  }
+  EXPECT_EQ("users_regex",
+            config.route(genHeaders("example.com", "/api/v1/users", "GET"), 0)
+                ->routeEntry()
+                ->clusterName());
+  EXPECT_EQ("users_regex",
+            config.route(genHeaders("example.com", "/api/v1/users?id=1", "GET"), 0)
+                ->routeEntry()
+                ->clusterName());
+  EXPECT_EQ("api_v1",
+            config.route(genHeaders("example.com", "/Api/V1/groups", "GET"), 0)
+                ->routeEntry()
+                ->clusterName());
+  EXPECT_EQ("health", config.route(genHeaders("example.com", "/health?verbose", "GET"), 0)
+                          ->routeEntry()
+                          ->clusterName());
+  EXPECT_EQ("default", config.route(genHeaders("example.com", "/health/check", "GET"), 0)
+                           ->routeEntry()
+                           ->clusterName());
+  EXPECT_EQ("default", config.route(genHeaders("example.com", "/api/v2", "GET"), 0)
+                           ->routeEntry()
+                           ->clusterName());
+}
+
+TEST(RouteMatcherTest, Re2RegexEngine) {
+  const std::string yaml = R"EOF(
+name: foo
+virtual_hosts:
+  - name: local_service
+    domains: ["*"]
+    routes:
+      - match:
+          regex: "/(a+)+b"
+          headers: [{ name: "x-id", value: "[0-9]+", regex: true }]
+          query_parameters: [{ name: "debug", value: "(true|1)", regex: true }]
+        route: { cluster: regex }
+      - match: { prefix: "/" }
+        route: { cluster: default }
+    virtual_clusters:
+      - pattern: "^/users/[0-9]+$"
+        name: users
+  )EOF";
+
+  NiceMock<Runtime::MockLoader> runtime;
+  NiceMock<Upstream::MockClusterManager> cm;
+  ON_CALL(runtime.snapshot_, getInteger("router.use_re2", 0)).WillByDefault(Return(1));
+  ConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), runtime, cm, true);
+  EXPECT_EQ(Regex::Engine::Re2, config.regexEngine());
+
+  {
+    Http::TestHeaderMapImpl headers = genHeaders("example.com", "/aaaab?debug=1", "GET");
+    headers.addCopy("x-id", "123");
+    EXPECT_EQ("regex", config.route(headers, 0)->routeEntry()->clusterName());
+  }
+  {
+    Http::TestHeaderMapImpl headers = genHeaders("example.com", "/aaaa?debug=1", "GET");
+    headers.addCopy("x-id", "123");
+    EXPECT_EQ("default", config.route(headers, 0)->routeEntry()->clusterName());
+  }
+  {
+    Http::TestHeaderMapImpl headers = genHeaders("example.com", "/aaaab?debug=yes", "GET");
+    headers.addCopy("x-id", "123");
+    EXPECT_EQ("default", config.route(headers, 0)->routeEntry()->clusterName());
+  }
+  {
+    Http::TestHeaderMapImpl headers = genHeaders("example.com", "/users/123", "GET");
+    EXPECT_EQ("users", config.route(headers, 0)->routeEntry()->virtualCluster(headers)->name());
+  }
+  {
+    Http::TestHeaderMapImpl headers = genHeaders("example.com", "/users/abc", "GET");
+    EXPECT_EQ("other", config.route(headers, 0)->routeEntry()->virtualCluster(headers)->name());
+  }
+
+  // Backreferences are valid std::regex syntax but are rejected by RE2.
+  const std::string backreference_yaml = R"EOF(
+name: foo
+virtual_hosts:
+  - name: local_service
+    domains: ["*"]
+    routes:
+      - match: { regex: "/(a)\\1" }
+        route: { cluster: regex }
+  )EOF";
+  EXPECT_THROW_WITH_REGEX(
+      ConfigImpl(parseRouteConfigurationFromV2Yaml(backreference_yaml), runtime, cm, true),
+      EnvoyException, "Invalid regex");
+}
+
 // Verify the fixes for https://github.com/envoyproxy/envoy/issues/2406
 TEST(RouteMatcherTest, InvalidHeaderMatchedRoutingConfig) {
   std::string value_with_regex_chars = R"EOF(
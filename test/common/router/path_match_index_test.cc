@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/router/path_match_index.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+std::vector<uint32_t> findCandidates(const PathMatchIndex& index, const std::string& path) {
+  const size_t query_start = std::min(path.find('?'), path.size());
+  PathMatchIndex::Candidates candidates = index.findCandidates(path, query_start);
+  std::vector<uint32_t> indexes;
+  uint32_t route_index;
+  while (candidates.next(route_index)) {
+    indexes.push_back(route_index);
+  }
+  return indexes;
+}
+
+TEST(PathMatchIndexTest, Empty) {
+  PathMatchIndex index;
+  EXPECT_THAT(findCandidates(index, "/foo"), IsEmpty());
+}
+
+TEST(PathMatchIndexTest, PrefixesInRouteOrder) {
+  PathMatchIndex index;
+  index.addPrefix(0, "/foo/bar", true);
+  index.addPrefix(1, "/baz", true);
+  index.addPrefix(2, "/foo", true);
+  index.addPrefix(3, "/", true);
+  index.addPrefix(4, "", true);
+
+  EXPECT_THAT(findCandidates(index, "/foo/bar/baz"), ElementsAre(0, 2, 3, 4));
+  EXPECT_THAT(findCandidates(index, "/foo"), ElementsAre(2, 3, 4));
+  EXPECT_THAT(findCandidates(index, "/fo"), ElementsAre(3, 4));
+  EXPECT_THAT(findCandidates(index, "/baz?foo"), ElementsAre(1, 3, 4));
+  EXPECT_THAT(findCandidates(index, "bar"), ElementsAre(4));
+}
+
+TEST(PathMatchIndexTest, PrefixMatchesQueryString) {
+  PathMatchIndex index;
+  index.addPrefix(0, "/foo?bar", true);
+  EXPECT_THAT(findCandidates(index, "/foo?bar=1"), ElementsAre(0));
+  EXPECT_THAT(findCandidates(index, "/foo?baz=1"), IsEmpty());
+}
+
+TEST(PathMatchIndexTest, ExactPathIgnoresQueryString) {
+  PathMatchIndex index;
+  index.addPath(0, "/foo", true);
+  index.addPath(1, "/foo/bar", true);
+  EXPECT_THAT(findCandidates(index, "/foo"), ElementsAre(0));
+  EXPECT_THAT(findCandidates(index, "/foo?bar"), ElementsAre(0));
+  EXPECT_THAT(findCandidates(index, "/foo/"), IsEmpty());
+  EXPECT_THAT(findCandidates(index, "/fo"), IsEmpty());
+  EXPECT_THAT(findCandidates(index, "/foo/bar"), ElementsAre(1));
+}
+
+TEST(PathMatchIndexTest, CaseInsensitive) {
+  PathMatchIndex index;
+  index.addPrefix(0, "/FOO", false);
+  index.addPath(1, "/Foo/Bar", false);
+  index.addPrefix(2, "/FOO", true);
+  EXPECT_THAT(findCandidates(index, "/foo/bar"), ElementsAre(0, 1));
+  EXPECT_THAT(findCandidates(index, "/FOO/BAR?x"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(findCandidates(index, "/fOo"), ElementsAre(0));
+}
+
+TEST(PathMatchIndexTest, UnindexedAlwaysCandidates) {
+  PathMatchIndex index;
+  index.addPrefix(0, "/foo", true);
+  index.addUnindexed(1);
+  index.addPath(2, "/foo", true);
+  index.addUnindexed(3);
+  EXPECT_THAT(findCandidates(index, "/foo"), ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(findCandidates(index, "/bar"), ElementsAre(1, 3));
+}
+
+// A prefix added after longer prefixes is a candidate for the paths of the longer prefixes too.
+TEST(PathMatchIndexTest, ShorterPrefixAddedLater) {
+  PathMatchIndex index;
+  index.addPrefix(0, "/foo/bar", true);
+  index.addPath(1, "/foo/bar", true);
+  index.addPrefix(2, "/foo/baz", true);
+  index.addPrefix(3, "/foo", true);
+  index.addPrefix(4, "/foo/bar", true);
+  index.addPrefix(5, "/f", false);
+  index.addUnindexed(6);
+  EXPECT_THAT(findCandidates(index, "/foo/bar"), ElementsAre(0, 1, 3, 4, 5, 6));
+  EXPECT_THAT(findCandidates(index, "/foo/baz/x"), ElementsAre(2, 3, 5, 6));
+  EXPECT_THAT(findCandidates(index, "/foo/ba"), ElementsAre(3, 5, 6));
+  EXPECT_THAT(findCandidates(index, "/F"), ElementsAre(5, 6));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -16,6 +16,7 @@
 
 #include "test/common/ssl/ssl_certs_test.h"
 #include "test/mocks/buffer/mocks.h"
+#include "test/mocks/common.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/server/mocks.h"
@@ -2219,6 +2220,17 @@ TEST_P(SslReadBufferLimitTest, NoLimitSmallWrites) {
   readBufferLimitTest(0, 256 * 1024, 1, 256 * 1024, false);
 }
 
+// Writes past the point where the socket switches from small to full size TLS records.
+TEST_P(SslReadBufferLimitTest, NoLimitLargeWrite) {
+  readBufferLimitTest(0, 2 * 1024 * 1024, 2 * 1024 * 1024, 1, false);
+}
+
+// Writes that leave the write buffer with many fragments smaller than a TLS record, which are
+// coalesced before being encrypted.
+TEST_P(SslReadBufferLimitTest, NoLimitFragmentedWrites) {
+  readBufferLimitTest(0, 2 * 1024 * 1024, 3000, 512, false);
+}
+
 TEST_P(SslReadBufferLimitTest, SomeLimit) {
   readBufferLimitTest(32 * 1024, 32 * 1024, 256 * 1024, 1, false);
 }
@@ -2264,5 +2276,108 @@ TEST_P(SslReadBufferLimitTest, TestBind) {
   disconnect();
 }
 
+class SslSocketWriteSizeTest : public testing::Test {
+public:
+  SslSocketWriteSizeTest() : manager_(runtime_) {
+    Json::ObjectSharedPtr loader = TestEnvironment::jsonLoadFromString("{}");
+    ClientContextConfigImpl config(*loader);
+    ctx_ = manager_.createSslClientContext(stats_store_, config);
+    socket_.reset(new SslSocket(*ctx_, InitialState::Client, time_source_));
+  }
+
+  uint64_t nextWriteSize(const Buffer::Instance& buffer) { return socket_->nextWriteSize(buffer); }
+  void setBytesWritten(uint64_t bytes) { socket_->bytes_written_ = bytes; }
+
+  void writeStartAt(MonotonicTime time) {
+    EXPECT_CALL(time_source_, currentTime()).WillOnce(Return(time));
+    socket_->onWriteStart();
+  }
+
+  void addFragment(Buffer::Instance& buffer, const std::string& data) {
+    fragments_.emplace_back(new Buffer::BufferFragmentImpl(data.data(), data.size(), nullptr));
+    buffer.addBufferFragment(*fragments_.back());
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  ContextManagerImpl manager_;
+  ClientContextPtr ctx_;
+  NiceMock<MockMonotonicTimeSource> time_source_;
+  std::unique_ptr<SslSocket> socket_;
+  std::vector<std::unique_ptr<Buffer::BufferFragmentImpl>> fragments_;
+};
+
+// Records are one TCP segment until 1MiB has been written, and full size after that.
+TEST_F(SslSocketWriteSizeTest, RecordSizeRamp) {
+  Buffer::OwnedImpl buffer(std::string(20000, 'a'));
+  EXPECT_EQ(1400U, nextWriteSize(buffer));
+
+  setBytesWritten(1024 * 1024 - 1);
+  EXPECT_EQ(1400U, nextWriteSize(buffer));
+
+  setBytesWritten(1024 * 1024);
+  EXPECT_EQ(16384U, nextWriteSize(buffer));
+
+  Buffer::OwnedImpl short_buffer(std::string(1000, 'a'));
+  EXPECT_EQ(1000U, nextWriteSize(short_buffer));
+  EXPECT_EQ(0U, nextWriteSize(Buffer::OwnedImpl()));
+}
+
+// A connection that has not written for a second goes back to small records.
+TEST_F(SslSocketWriteSizeTest, IdleReset) {
+  Buffer::OwnedImpl buffer(std::string(20000, 'a'));
+  const MonotonicTime start = MonotonicTime() + std::chrono::hours(1);
+
+  writeStartAt(start);
+  setBytesWritten(2 * 1024 * 1024);
+  EXPECT_EQ(16384U, nextWriteSize(buffer));
+
+  writeStartAt(start + std::chrono::milliseconds(999));
+  EXPECT_EQ(16384U, nextWriteSize(buffer));
+
+  // The idle time is measured from the last write, not the first one.
+  writeStartAt(start + std::chrono::milliseconds(1998));
+  EXPECT_EQ(16384U, nextWriteSize(buffer));
+
+  writeStartAt(start + std::chrono::milliseconds(2998));
+  EXPECT_EQ(1400U, nextWriteSize(buffer));
+}
+
+// Records are encrypted straight from a large first slice, without linearize() copying it.
+TEST_F(SslSocketWriteSizeTest, NoCopyWrite) {
+  const std::string data1(8192, 'a');
+  const std::string data2(8192, 'b');
+  Buffer::OwnedImpl buffer;
+  addFragment(buffer, data1);
+  addFragment(buffer, data2);
+
+  EXPECT_EQ(1400U, nextWriteSize(buffer));
+  EXPECT_EQ(data1.data(), buffer.linearize(1400));
+
+  // A full size record does not fit in the first slice, so the record is cut short rather than
+  // copying the second slice.
+  setBytesWritten(1024 * 1024);
+  EXPECT_EQ(8192U, nextWriteSize(buffer));
+  EXPECT_EQ(data1.data(), buffer.linearize(8192));
+}
+
+// Small fragments are coalesced, up to but not including a following large slice.
+TEST_F(SslSocketWriteSizeTest, CoalesceSmallFragments) {
+  const std::string small1(100, 'a');
+  const std::string small2(200, 'b');
+  const std::string large(8192, 'c');
+  Buffer::OwnedImpl buffer;
+  addFragment(buffer, small1);
+  addFragment(buffer, small2);
+  addFragment(buffer, large);
+
+  EXPECT_EQ(300U, nextWriteSize(buffer));
+  buffer.linearize(300);
+  Buffer::RawSlice slices[2];
+  ASSERT_EQ(2U, buffer.getRawSlices(slices, 2));
+  EXPECT_EQ(300U, slices[0].len_);
+  EXPECT_EQ(large.data(), slices[1].mem_);
+}
+
 } // namespace Ssl
 } // namespace Envoy
@@ -1,4 +1,5 @@
 #include "common/stats/grpc_metrics_service_impl.h"
+#include "common/stats/histogram_impl.h"
 
 #include "test/mocks/grpc/mocks.h"
 #include "test/mocks/local_info/mocks.h"
@@ -10,6 +11,7 @@ using testing::InSequence;
 using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
+using testing::ReturnRef;
 using testing::_;
 
 namespace Envoy {
@@ -143,6 +145,38 @@ TEST(MetricsServiceSinkTest, CheckStatsCount) {
   EXPECT_EQ(1, (*streamer_).metric_count);
 }
 
+TEST(MetricsServiceSinkTest, FlushHistogram) {
+  std::shared_ptr<MockGrpcMetricsStreamer> streamer_{new MockGrpcMetricsStreamer()};
+
+  MetricsServiceSink sink(streamer_);
+
+  LogLinearHistogram values;
+  values.recordValue(10);
+  values.recordValue(20);
+  HistogramStatisticsImpl statistics;
+  statistics.refresh(values);
+
+  NiceMock<MockParentHistogram> histogram;
+  histogram.name_ = "test_histogram";
+  ON_CALL(histogram, cumulativeStatistics()).WillByDefault(ReturnRef(statistics));
+
+  sink.beginFlush();
+  sink.flushHistogram(histogram);
+  EXPECT_CALL(*streamer_, send(_))
+      .WillOnce(Invoke([](envoy::service::metrics::v2::StreamMetricsMessage& message) {
+        ASSERT_EQ(1, message.envoy_metrics_size());
+        const auto& metrics_family = message.envoy_metrics(0);
+        EXPECT_EQ(io::prometheus::client::MetricType::SUMMARY, metrics_family.type());
+        EXPECT_EQ("test_histogram", metrics_family.name());
+        const auto& summary = metrics_family.metric(0).summary();
+        EXPECT_EQ(2, summary.sample_count());
+        EXPECT_EQ(30, summary.sample_sum());
+        EXPECT_EQ(4, summary.quantile_size());
+        EXPECT_EQ(0.5, summary.quantile(0).quantile());
+      }));
+  sink.endFlush();
+}
+
 } // namespace Metrics
 } // namespace Stats
 } // namespace Envoy
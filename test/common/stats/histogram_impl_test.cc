@@ -0,0 +1,84 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "common/stats/histogram_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+
+TEST(LogLinearHistogramTest, BucketBounds) {
+  // Small values are recorded exactly.
+  for (uint64_t value = 0; value < 2 * LogLinearHistogram::SUB_BUCKET_COUNT; value++) {
+    const uint32_t index = LogLinearHistogram::bucketIndex(value);
+    EXPECT_EQ(value, LogLinearHistogram::bucketLowerBound(index));
+    EXPECT_EQ(value, LogLinearHistogram::bucketUpperBound(index));
+  }
+
+  // Every value falls within the bounds of its bucket, and buckets are contiguous.
+  for (uint64_t value : {32UL, 33UL, 34UL, 100UL, 1000UL, 123456789UL, 1UL << 40}) {
+    const uint32_t index = LogLinearHistogram::bucketIndex(value);
+    EXPECT_LE(LogLinearHistogram::bucketLowerBound(index), value);
+    EXPECT_GE(LogLinearHistogram::bucketUpperBound(index), value);
+    EXPECT_EQ(LogLinearHistogram::bucketUpperBound(index - 1) + 1,
+              LogLinearHistogram::bucketLowerBound(index));
+  }
+
+  const uint64_t max = std::numeric_limits<uint64_t>::max();
+  const uint32_t max_index = LogLinearHistogram::bucketIndex(max);
+  EXPECT_EQ(max, LogLinearHistogram::bucketUpperBound(max_index));
+  EXPECT_LE(LogLinearHistogram::bucketLowerBound(max_index), max);
+}
+
+TEST(LogLinearHistogramTest, Quantiles) {
+  LogLinearHistogram histogram;
+  EXPECT_TRUE(std::isnan(histogram.quantile(0.5)));
+
+  for (uint64_t value = 1; value <= 1000; value++) {
+    histogram.recordValue(value);
+  }
+  EXPECT_EQ(1000UL, histogram.sampleCount());
+  EXPECT_EQ(500500UL, histogram.sampleSum());
+  EXPECT_EQ(1, histogram.quantile(0));
+  for (double quantile : {0.5, 0.9, 0.99, 0.999}) {
+    const double expected = quantile * 1000;
+    EXPECT_NEAR(expected, histogram.quantile(quantile), expected / 16);
+  }
+  EXPECT_NEAR(1000, histogram.quantile(1), 1000 / 16);
+}
+
+TEST(LogLinearHistogramTest, MergeAndClear) {
+  LogLinearHistogram small;
+  LogLinearHistogram large;
+  small.recordValue(1);
+  large.recordValue(1000000);
+
+  small.merge(large);
+  EXPECT_EQ(2UL, small.sampleCount());
+  EXPECT_EQ(1000001UL, small.sampleSum());
+  EXPECT_EQ(1, small.quantile(0));
+  EXPECT_NEAR(1000000, small.quantile(1), 1000000 / 16);
+
+  small.clear();
+  EXPECT_EQ(0UL, small.sampleCount());
+  EXPECT_EQ(0UL, small.sampleSum());
+  EXPECT_TRUE(std::isnan(small.quantile(0.5)));
+}
+
+TEST(HistogramStatisticsImplTest, Summary) {
+  HistogramStatisticsImpl statistics;
+  EXPECT_EQ("P50: nan, P90: nan, P99: nan, P99.9: nan", statistics.summary());
+
+  LogLinearHistogram histogram;
+  histogram.recordValue(10);
+  statistics.refresh(histogram);
+  EXPECT_EQ("P50: 10, P90: 10, P99: 10, P99.9: 10", statistics.summary());
+  EXPECT_EQ(1UL, statistics.sampleCount());
+  EXPECT_EQ(10UL, statistics.sampleSum());
+  EXPECT_EQ(statistics.supportedQuantiles().size(), statistics.computedQuantiles().size());
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -1,10 +1,14 @@
 #include <chrono>
+#include <cmath>
 #include <memory>
 #include <string>
 #include <unordered_map>
 
 #include "common/common/c_smart_ptr.h"
+#include "common/common/thread.h"
+#include "common/event/dispatcher_impl.h"
 #include "common/stats/thread_local_store.h"
+#include "common/thread_local/thread_local_impl.h"
 
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/stats/mocks.h"
@@ -320,6 +324,165 @@ TEST_F(StatsThreadLocalStoreTest, AllocFailed) {
   EXPECT_CALL(*this, free(_));
 }
 
+TEST_F(StatsThreadLocalStoreTest, HistogramMerge) {
+  InSequence s;
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  ScopePtr scope1 = store_->createScope("scope1.");
+  Histogram& h1 = store_->histogram("h1");
+  Histogram& h2 = scope1->histogram("h2");
+  EXPECT_EQ(&h1, &store_->histogram("h1"));
+
+  // Values are still delivered to the sinks one at a time.
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), _)).Times(100);
+  for (uint64_t i = 1; i <= 100; i++) {
+    h1.recordValue(i);
+  }
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h2), 5));
+  h2.recordValue(5);
+
+  // Nothing is visible before the merge.
+  std::list<ParentHistogramSharedPtr> histograms = store_->histograms();
+  EXPECT_EQ(2UL, histograms.size());
+  for (const ParentHistogramSharedPtr& histogram : histograms) {
+    EXPECT_FALSE(histogram->used());
+  }
+
+  bool merge_called = false;
+  EXPECT_CALL(tls_, runOnAllThreads(_, _));
+  store_->mergeHistograms([&merge_called]() -> void { merge_called = true; });
+  EXPECT_TRUE(merge_called);
+
+  ParentHistogramSharedPtr parent_h1;
+  for (const ParentHistogramSharedPtr& histogram : store_->histograms()) {
+    EXPECT_TRUE(histogram->used());
+    if (histogram->name() == "h1") {
+      parent_h1 = histogram;
+    }
+  }
+  ASSERT_NE(nullptr, parent_h1);
+  EXPECT_EQ(100UL, parent_h1->intervalStatistics().sampleCount());
+  EXPECT_EQ(5050UL, parent_h1->intervalStatistics().sampleSum());
+  EXPECT_EQ(100UL, parent_h1->cumulativeStatistics().sampleCount());
+  EXPECT_NEAR(50, parent_h1->intervalStatistics().computedQuantiles()[0], 50 * 0.0625);
+  EXPECT_NEAR(99, parent_h1->intervalStatistics().computedQuantiles()[2], 99 * 0.0625);
+  EXPECT_EQ(parent_h1->intervalStatistics().computedQuantiles(),
+            parent_h1->cumulativeStatistics().computedQuantiles());
+  EXPECT_THAT(parent_h1->summary(), testing::StartsWith("P50("));
+
+  // A merge without any new values empties the interval but keeps the cumulative statistics.
+  EXPECT_CALL(tls_, runOnAllThreads(_, _));
+  store_->mergeHistograms([]() -> void {});
+  EXPECT_TRUE(parent_h1->used());
+  EXPECT_EQ(0UL, parent_h1->intervalStatistics().sampleCount());
+  EXPECT_TRUE(std::isnan(parent_h1->intervalStatistics().computedQuantiles()[0]));
+  EXPECT_EQ(100UL, parent_h1->cumulativeStatistics().sampleCount());
+
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 1000));
+  h1.recordValue(1000);
+  EXPECT_CALL(tls_, runOnAllThreads(_, _));
+  store_->mergeHistograms([]() -> void {});
+  EXPECT_EQ(1UL, parent_h1->intervalStatistics().sampleCount());
+  EXPECT_EQ(101UL, parent_h1->cumulativeStatistics().sampleCount());
+  EXPECT_EQ(6050UL, parent_h1->cumulativeStatistics().sampleSum());
+
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+
+  // Includes overflow stat.
+  EXPECT_CALL(*this, free(_));
+}
+
+TEST_F(StatsThreadLocalStoreTest, HistogramMergeNoTls) {
+  InSequence s;
+
+  Histogram& h1 = store_->histogram("h1");
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 200));
+  h1.recordValue(200);
+
+  // Without threading there is nothing to swap, so the callback is called right away. Values
+  // recorded without thread local histograms are only delivered to the sinks.
+  bool merge_called = false;
+  store_->mergeHistograms([&merge_called]() -> void { merge_called = true; });
+  EXPECT_TRUE(merge_called);
+  EXPECT_EQ(1UL, store_->histograms().size());
+  EXPECT_FALSE(store_->histograms().front()->used());
+
+  store_->shutdownThreading();
+
+  // Includes overflow stat.
+  EXPECT_CALL(*this, free(_));
+}
+
+// Long lived stats get their histograms on the main thread and then record into them on the
+// workers, which must each record into their own thread local histogram.
+TEST_F(StatsThreadLocalStoreTest, HistogramRecordedOnWorker) {
+  Event::DispatcherImpl main_dispatcher;
+  Event::DispatcherImpl worker_dispatcher;
+  ThreadLocal::InstanceImpl tls;
+  tls.registerThread(main_dispatcher, true);
+  tls.registerThread(worker_dispatcher, false);
+  store_->initializeThreading(main_dispatcher, tls);
+
+  Histogram& h1 = store_->histogram("h1");
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 10));
+  h1.recordValue(10);
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 20));
+  worker_dispatcher.post([&h1]() -> void { h1.recordValue(20); });
+
+  // The worker runs until it is told to exit, as the merge must run on the thread that created the
+  // thread local histogram.
+  Thread::Thread worker([&worker_dispatcher]() -> void {
+    Event::TimerPtr keepalive_timer = worker_dispatcher.createTimer([]() -> void {});
+    keepalive_timer->enableTimer(std::chrono::hours(1));
+    worker_dispatcher.run(Event::Dispatcher::RunType::Block);
+  });
+
+  Event::TimerPtr keepalive_timer = main_dispatcher.createTimer([]() -> void {});
+  keepalive_timer->enableTimer(std::chrono::hours(1));
+  store_->mergeHistograms([&main_dispatcher]() -> void { main_dispatcher.exit(); });
+  main_dispatcher.run(Event::Dispatcher::RunType::Block);
+  worker_dispatcher.exit();
+  worker.join();
+
+  const ParentHistogramSharedPtr parent_h1 = store_->histograms().front();
+  EXPECT_EQ(&h1, parent_h1.get());
+  EXPECT_EQ(2UL, parent_h1->intervalStatistics().sampleCount());
+  EXPECT_EQ(30UL, parent_h1->intervalStatistics().sampleSum());
+
+  store_->shutdownThreading();
+  tls.shutdownGlobalThreading();
+  tls.shutdownThread();
+
+  // Includes overflow stat. The store is destroyed before the thread local instance that its slot
+  // belongs to.
+  EXPECT_CALL(*this, free(_));
+  store_.reset();
+}
+
+// A sink that only consumes merged histograms never sees the individual values.
+TEST_F(StatsThreadLocalStoreTest, HistogramMergedOnlySink) {
+  MockSink merged_sink;
+  EXPECT_CALL(merged_sink, wantsHistogramValues()).WillOnce(Return(false));
+  store_->addSink(merged_sink);
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  Histogram& h1 = store_->histogram("h1");
+  EXPECT_CALL(merged_sink, onHistogramComplete(_, _)).Times(0);
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 10));
+  h1.recordValue(10);
+
+  EXPECT_CALL(tls_, runOnAllThreads(_, _));
+  store_->mergeHistograms([]() -> void {});
+  EXPECT_EQ(1UL, store_->histograms().front()->intervalStatistics().sampleCount());
+
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+
+  // Includes overflow stat.
+  EXPECT_CALL(*this, free(_));
+}
+
 TEST_F(StatsThreadLocalStoreTest, ShuttingDown) {
   InSequence s;
   store_->initializeThreading(main_thread_dispatcher_, tls_);
@@ -14,6 +14,7 @@
 #include "spdlog/spdlog.h"
 
 using testing::NiceMock;
+using testing::_;
 
 namespace Envoy {
 namespace Stats {
@@ -22,6 +23,7 @@ namespace Statsd {
 class MockWriter : public Writer {
 public:
   MOCK_METHOD1(write, void(const std::string& message));
+  MOCK_METHOD1(writeMany, void(const std::vector<std::string>& messages));
 };
 
 class UdpStatsdSinkTest : public testing::TestWithParam<Network::Address::IpVersion> {};
@@ -34,7 +36,7 @@ TEST_P(UdpStatsdSinkTest, InitWithIpAddress) {
   Network::Address::InstanceConstSharedPtr server_address =
       Network::Utility::parseInternetAddressAndPort(
           fmt::format("{}:8125", Network::Test::getLoopbackAddressUrlString(GetParam())));
-  UdpStatsdSink sink(tls_, server_address, false);
+  UdpStatsdSink sink(tls_, server_address, false, 0);
   int fd = sink.getFdForTests();
   EXPECT_NE(fd, -1);
 
@@ -71,7 +73,7 @@ TEST_P(UdpStatsdSinkWithTagsTest, InitWithIpAddress) {
   Network::Address::InstanceConstSharedPtr server_address =
       Network::Utility::parseInternetAddressAndPort(
           fmt::format("{}:8125", Network::Test::getLoopbackAddressUrlString(GetParam())));
-  UdpStatsdSink sink(tls_, server_address, true);
+  UdpStatsdSink sink(tls_, server_address, true, 0);
   int fd = sink.getFdForTests();
   EXPECT_NE(fd, -1);
 
@@ -129,6 +131,47 @@ TEST(UdpStatsdSinkTest, CheckActualStats) {
   tls_.shutdownThread();
 }
 
+TEST(UdpStatsdSinkTest, CoalesceFlushedStats) {
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  // "envoy.test_counter:1|c" and "envoy.test_gauge:1|g" are 22 and 20 bytes.
+  UdpStatsdSink sink(tls_, writer_ptr, false, 43);
+
+  NiceMock<MockCounter> counter;
+  counter.name_ = "test_counter";
+  NiceMock<MockGauge> gauge;
+  gauge.name_ = "test_gauge";
+  NiceMock<MockCounter> long_counter;
+  long_counter.name_ = "a_counter_with_a_name_longer_than_the_max_packet_size";
+
+  EXPECT_CALL(*writer_ptr, write(_)).Times(0);
+  EXPECT_CALL(*writer_ptr, writeMany(_)).Times(0);
+  sink.beginFlush();
+  sink.flushCounter(counter, 1);
+  sink.flushGauge(gauge, 1);
+  sink.flushCounter(counter, 2);
+  sink.flushCounter(long_counter, 3);
+  sink.flushGauge(gauge, 2);
+
+  // Histogram samples are not part of a flush and are still sent right away.
+  NiceMock<MockHistogram> timer;
+  timer.name_ = "test_timer";
+  EXPECT_CALL(*writer_ptr, write("envoy.test_timer:5|ms"));
+  sink.onHistogramComplete(timer, 5);
+
+  const std::vector<std::string> expected_packets{
+      "envoy.test_counter:1|c\nenvoy.test_gauge:1|g", "envoy.test_counter:2|c",
+      "envoy.a_counter_with_a_name_longer_than_the_max_packet_size:3|c", "envoy.test_gauge:2|g"};
+  EXPECT_CALL(*writer_ptr, writeMany(expected_packets));
+  sink.endFlush();
+
+  // Nothing is left over for the next flush.
+  sink.beginFlush();
+  sink.endFlush();
+
+  tls_.shutdownThread();
+}
+
 TEST(UdpStatsdSinkWithTagsTest, CheckActualStats) {
   auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
   NiceMock<ThreadLocal::MockInstance> tls_;
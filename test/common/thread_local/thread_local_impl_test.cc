@@ -82,6 +82,33 @@ TEST_F(ThreadLocalInstanceImplTest, All) {
   tls_.shutdownThread();
 }
 
+// Validate ThreadLocal::runOnAllThreads behavior with all_thread_complete call back.
+TEST_F(ThreadLocalInstanceImplTest, RunOnAllThreads) {
+  SlotPtr tlsptr = tls_.allocateSlot();
+
+  EXPECT_CALL(thread_dispatcher_, post(_));
+  EXPECT_CALL(main_dispatcher_, post(_));
+
+  // Ensure that the thread local call back and all_thread_complete call back are called.
+  struct {
+    uint64_t thread_local_calls_{0};
+    bool all_threads_complete_ = false;
+  } thread_status;
+
+  tlsptr->runOnAllThreads([&thread_status]() -> void { ++thread_status.thread_local_calls_; },
+                          [&thread_status]() -> void {
+                            EXPECT_EQ(thread_status.thread_local_calls_, 2);
+                            thread_status.all_threads_complete_ = true;
+                          });
+
+  EXPECT_TRUE(thread_status.all_threads_complete_);
+
+  tls_.shutdownGlobalThreading();
+  tlsptr.reset();
+  EXPECT_CALL(thread_dispatcher_, post(_)).Times(0);
+  tls_.shutdownThread();
+}
+
 // Validate ThreadLocal::InstanceImpl's dispatcher() behavior.
 TEST(ThreadLocalInstanceImplDispatcherTest, Dispatcher) {
   InstanceImpl tls;
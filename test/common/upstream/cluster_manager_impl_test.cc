@@ -1085,6 +1085,58 @@ TEST_F(ClusterManagerImplTest, DynamicHostRemoveDefaultPriority) {
   factory_.tls_.shutdownThread();
 }
 
+// Thread local clusters share the primary cluster's host lists instead of copies of them.
+TEST_F(ClusterManagerImplTest, DynamicHostUpdateSharesHostLists) {
+  const std::string json = R"EOF(
+  {
+    "clusters": [
+    {
+      "name": "cluster_1",
+      "connect_timeout_ms": 250,
+      "type": "strict_dns",
+      "dns_resolvers": [ "1.2.3.4:80" ],
+      "lb_type": "round_robin",
+      "hosts": [{"url": "tcp://localhost:11001"}]
+    }]
+  }
+  )EOF";
+
+  std::shared_ptr<Network::MockDnsResolver> dns_resolver(new Network::MockDnsResolver());
+  EXPECT_CALL(factory_.dispatcher_, createDnsResolver(_)).WillOnce(Return(dns_resolver));
+
+  Network::DnsResolver::ResolveCb dns_callback;
+  Event::MockTimer* dns_timer_ = new NiceMock<Event::MockTimer>(&factory_.dispatcher_);
+  Network::MockActiveDnsQuery active_dns_query;
+  EXPECT_CALL(*dns_resolver, resolve(_, _, _))
+      .WillRepeatedly(DoAll(SaveArg<2>(&dns_callback), Return(&active_dns_query)));
+  create(parseBootstrapFromJson(json));
+
+  const HostSet& primary_host_set = *cluster_manager_->clusters()
+                                         .at("cluster_1")
+                                         .get()
+                                         .prioritySet()
+                                         .hostSetsPerPriority()[0];
+  auto thread_local_host_set = [this]() -> const HostSet& {
+    return *cluster_manager_->get("cluster_1")->prioritySet().hostSetsPerPriority()[0];
+  };
+
+  dns_callback(TestUtility::makeDnsResponse({"127.0.0.1", "127.0.0.2"}));
+  EXPECT_EQ(2UL, thread_local_host_set().hosts().size());
+  EXPECT_EQ(&primary_host_set.hosts(), &thread_local_host_set().hosts());
+  EXPECT_EQ(&primary_host_set.healthyHosts(), &thread_local_host_set().healthyHosts());
+  EXPECT_EQ(&primary_host_set.hostsPerLocality(), &thread_local_host_set().hostsPerLocality());
+  EXPECT_EQ(&primary_host_set.healthyHostsPerLocality(),
+            &thread_local_host_set().healthyHostsPerLocality());
+
+  dns_timer_->callback_();
+  dns_callback(TestUtility::makeDnsResponse({"127.0.0.2"}));
+  EXPECT_EQ(1UL, thread_local_host_set().hosts().size());
+  EXPECT_EQ(&primary_host_set.hosts(), &thread_local_host_set().hosts());
+  EXPECT_EQ(&primary_host_set.healthyHosts(), &thread_local_host_set().healthyHosts());
+
+  factory_.tls_.shutdownThread();
+}
+
 TEST_F(ClusterManagerImplTest, OriginalDstInitialization) {
   const std::string json = R"EOF(
   {
@@ -189,6 +189,40 @@ TEST_F(EdsTest, EndpointMetadata) {
   EXPECT_TRUE(hosts[1]->canary());
 }
 
+// Validate that onConfigUpdate() raises a membership update when only an endpoint weight changes,
+// so that weighted load balancers rebuild.
+TEST_F(EdsTest, EndpointWeightChange) {
+  Protobuf::RepeatedPtrField<envoy::api::v2::ClusterLoadAssignment> resources;
+  auto* cluster_load_assignment = resources.Add();
+  cluster_load_assignment->set_cluster_name("fare");
+  auto* endpoint = cluster_load_assignment->add_endpoints()->add_lb_endpoints();
+  endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address()->set_address("1.2.3.4");
+  endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address()->set_port_value(80);
+  endpoint->mutable_load_balancing_weight()->set_value(1);
+
+  bool initialized = false;
+  cluster_->initialize([&initialized] { initialized = true; });
+  VERBOSE_EXPECT_NO_THROW(cluster_->onConfigUpdate(resources));
+  EXPECT_TRUE(initialized);
+
+  uint32_t membership_updates = 0;
+  cluster_->prioritySet().addMemberUpdateCb(
+      [&membership_updates](uint32_t, const HostVector&, const HostVector&) -> void {
+        membership_updates++;
+      });
+
+  // The same config is not an update.
+  VERBOSE_EXPECT_NO_THROW(cluster_->onConfigUpdate(resources));
+  EXPECT_EQ(0U, membership_updates);
+
+  endpoint->mutable_load_balancing_weight()->set_value(31);
+  VERBOSE_EXPECT_NO_THROW(cluster_->onConfigUpdate(resources));
+  EXPECT_EQ(1U, membership_updates);
+  auto& hosts = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+  EXPECT_EQ(1U, hosts.size());
+  EXPECT_EQ(31U, hosts[0]->weight());
+}
+
 // Validate that onConfigUpdate() updates the endpoint locality.
 TEST_F(EdsTest, EndpointLocality) {
   Protobuf::RepeatedPtrField<envoy::api::v2::ClusterLoadAssignment> resources;
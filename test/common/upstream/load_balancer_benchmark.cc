@@ -1,4 +1,5 @@
 #include "common/runtime/runtime_impl.h"
+#include "common/upstream/load_balancer_impl.h"
 #include "common/upstream/maglev_lb.h"
 #include "common/upstream/ring_hash_lb.h"
 #include "common/upstream/upstream_impl.h"
@@ -14,16 +15,19 @@ namespace {
 
 class BaseTester {
 public:
-  BaseTester(uint64_t num_hosts) {
+  // When weighted, host i has weight i % 4 + 1.
+  BaseTester(uint64_t num_hosts, bool weighted = false) {
     HostSet& host_set = priority_set_.getOrCreateHostSet(0);
 
     HostVector hosts;
     ASSERT(num_hosts < 65536);
     for (uint64_t i = 0; i < num_hosts; i++) {
-      hosts.push_back(makeTestHost(info_, fmt::format("tcp://10.0.{}.{}:6379", i / 256, i % 256)));
+      hosts.push_back(makeTestHost(info_, fmt::format("tcp://10.0.{}.{}:6379", i / 256, i % 256),
+                                   weighted ? i % 4 + 1 : 1));
     }
     HostVectorConstSharedPtr updated_hosts{new HostVector(hosts)};
-    host_set.updateHosts(updated_hosts, updated_hosts, nullptr, nullptr, hosts, {});
+    host_set.updateHosts(updated_hosts, updated_hosts, HostsPerLocalityImpl::empty(),
+                         HostsPerLocalityImpl::empty(), hosts, {});
   }
 
   PrioritySetImpl priority_set_;
@@ -48,6 +52,21 @@ public:
   envoy::api::v2::Cluster::CommonLbConfig common_config_;
 };
 
+class LeastRequestTester : public BaseTester {
+public:
+  LeastRequestTester(uint64_t num_hosts, bool weighted) : BaseTester(num_hosts, weighted) {
+    lb_.reset(new LeastRequestLoadBalancer(priority_set_, nullptr, stats_, runtime_, random_,
+                                           common_config_));
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  ClusterStats stats_{ClusterInfoImpl::generateStats(stats_store_)};
+  NiceMock<Runtime::MockLoader> runtime_;
+  Runtime::RandomGeneratorImpl random_;
+  envoy::api::v2::Cluster::CommonLbConfig common_config_;
+  std::unique_ptr<LeastRequestLoadBalancer> lb_;
+};
+
 uint64_t hashInt(uint64_t i) {
   // Hack to hash an integer.
   return HashUtil::xxHash64(absl::string_view(reinterpret_cast<const char*>(&i), sizeof(i)));
@@ -74,6 +93,34 @@ BENCHMARK(BM_RingHashLoadBalancerBuildRing)
     ->Args({500, 256000})
     ->Unit(benchmark::kMillisecond);
 
+void BM_RingHashLoadBalancerRebuildRing(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    const uint64_t num_hosts = state.range(0);
+    const uint64_t min_ring_size = state.range(1);
+    RingHashTester tester(num_hosts, min_ring_size);
+    tester.ring_hash_lb_->initialize();
+
+    HostSet& host_set = tester.priority_set_.getOrCreateHostSet(0);
+    HostVector hosts = host_set.hosts();
+    HostVector hosts_removed{hosts.back()};
+    hosts.back() = makeTestHost(tester.info_, "tcp://10.1.0.0:6379");
+    HostVector hosts_added{hosts.back()};
+    HostVectorConstSharedPtr updated_hosts{new HostVector(hosts)};
+    state.ResumeTiming();
+
+    // We are only interested in timing the ring rebuild after one host is replaced.
+    host_set.updateHosts(updated_hosts, updated_hosts, HostsPerLocalityImpl::empty(),
+                         HostsPerLocalityImpl::empty(), hosts_added, hosts_removed);
+  }
+}
+BENCHMARK(BM_RingHashLoadBalancerRebuildRing)
+    ->Args({100, 65536})
+    ->Args({500, 65536})
+    ->Args({100, 256000})
+    ->Args({500, 256000})
+    ->Unit(benchmark::kMillisecond);
+
 void BM_MaglevLoadBalancerBuildTable(benchmark::State& state) {
   for (auto _ : state) {
     state.PauseTiming();
@@ -173,7 +220,7 @@ void BM_MaglevLoadBalancerChooseHost(benchmark::State& state) {
     // std::unordered_map. However, it should be roughly equivalent to the work done when
     // comparing different hashing algorithms.
     for (uint64_t i = 0; i < keys_to_simulate; i++) {
-      hit_counter[table.chooseHost(hashInt(i))->address()->asString()] += 1;
+      hit_counter[table.chooseHost(hashInt(i), 0)->address()->asString()] += 1;
     }
 
     // Do not time computation of mean, standard deviation, and relative standard deviation.
@@ -188,6 +235,41 @@ BENCHMARK(BM_MaglevLoadBalancerChooseHost)
     ->Args({500, 100000})
     ->Unit(benchmark::kMillisecond);
 
+void BM_LeastRequestLoadBalancerChooseHost(benchmark::State& state) {
+  for (auto _ : state) {
+    // Do not time the creation of the load balancer.
+    state.PauseTiming();
+    const uint64_t num_hosts = state.range(0);
+    const bool weighted = state.range(1) != 0;
+    const uint64_t keys_to_simulate = state.range(2);
+    LeastRequestTester tester(num_hosts, weighted);
+    std::unordered_map<std::string, uint64_t> hit_counter;
+    state.ResumeTiming();
+
+    for (uint64_t i = 0; i < keys_to_simulate; i++) {
+      hit_counter[tester.lb_->chooseHost(nullptr)->address()->asString()] += 1;
+    }
+
+    // Do not time computation of mean, standard deviation, and relative standard deviation. Hits
+    // are normalized by host weight, so an even distribution has a relative stddev near 0.
+    state.PauseTiming();
+    for (const auto& host : tester.priority_set_.hostSetsPerPriority()[0]->hosts()) {
+      auto hits = hit_counter.find(host->address()->asString());
+      if (hits != hit_counter.end()) {
+        hits->second /= host->weight();
+      }
+    }
+    computeHitStats(state, hit_counter);
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_LeastRequestLoadBalancerChooseHost)
+    ->Args({100, 0, 1000000})
+    ->Args({100, 1, 1000000})
+    ->Args({10000, 0, 1000000})
+    ->Args({10000, 1, 1000000})
+    ->Unit(benchmark::kMillisecond);
+
 void BM_RingHashLoadBalancerHostLoss(benchmark::State& state) {
   for (auto _ : state) {
     const uint64_t num_hosts = state.range(0);
@@ -244,14 +326,14 @@ void BM_MaglevLoadBalancerHostLoss(benchmark::State& state) {
     MaglevTable table(tester.priority_set_.getOrCreateHostSet(0).hosts());
     std::vector<HostConstSharedPtr> hosts;
     for (uint64_t i = 0; i < keys_to_simulate; i++) {
-      hosts.push_back(table.chooseHost(hashInt(i)));
+      hosts.push_back(table.chooseHost(hashInt(i), 0));
     }
 
     BaseTester tester2(num_hosts - hosts_to_lose);
     MaglevTable table2(tester2.priority_set_.getOrCreateHostSet(0).hosts());
     std::vector<HostConstSharedPtr> hosts2;
     for (uint64_t i = 0; i < keys_to_simulate; i++) {
-      hosts2.push_back(table2.chooseHost(hashInt(i)));
+      hosts2.push_back(table2.chooseHost(hashInt(i), 0));
     }
 
     ASSERT(hosts.size() == hosts2.size());
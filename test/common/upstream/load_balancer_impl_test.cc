@@ -330,6 +330,27 @@ TEST_P(RoundRobinLoadBalancerTest, Normal) {
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
 }
 
+// Hosts are picked in proportion to their weights, interleaved.
+TEST_P(RoundRobinLoadBalancerTest, Weighted) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", 2)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  init(false);
+  for (uint32_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+    EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+    EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+  }
+
+  // A weight change takes effect on the next membership update.
+  hostSet().healthy_hosts_[0]->weight(2);
+  hostSet().runCallbacks({}, {});
+  for (uint32_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+    EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+  }
+}
+
 TEST_P(RoundRobinLoadBalancerTest, MaxUnhealthyPanic) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80"),
                               makeTestHost(info_, "tcp://127.0.0.1:81")};
@@ -466,6 +487,45 @@ TEST_P(RoundRobinLoadBalancerTest, ZoneAwareRoutingLargeZoneSwitchOnOff) {
   EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr));
 }
 
+// Weighted hosts of the local locality are picked in proportion to their weights.
+TEST_P(RoundRobinLoadBalancerTest, ZoneAwareRoutingWeighted) {
+  if (&hostSet() == &failover_host_set_) { // P = 1 does not support zone-aware routing.
+    return;
+  }
+  HostVectorSharedPtr hosts(new HostVector({makeTestHost(info_, "tcp://127.0.0.1:80", 1),
+                                            makeTestHost(info_, "tcp://127.0.0.1:81", 3),
+                                            makeTestHost(info_, "tcp://127.0.0.1:82"),
+                                            makeTestHost(info_, "tcp://127.0.0.1:83")}));
+  HostsPerLocalitySharedPtr hosts_per_locality =
+      makeHostsPerLocality({{(*hosts)[0], (*hosts)[1]}, {(*hosts)[2]}, {(*hosts)[3]}});
+  HostVectorSharedPtr local_hosts(new HostVector({makeTestHost(info_, "tcp://127.0.0.1:0"),
+                                                  makeTestHost(info_, "tcp://127.0.0.1:1"),
+                                                  makeTestHost(info_, "tcp://127.0.0.1:2")}));
+  HostsPerLocalitySharedPtr local_hosts_per_locality = makeHostsPerLocality(
+      {{(*local_hosts)[0]}, {(*local_hosts)[1]}, {(*local_hosts)[2]}});
+
+  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.healthy_panic_threshold", 50))
+      .WillRepeatedly(Return(50));
+  EXPECT_CALL(runtime_.snapshot_, featureEnabled("upstream.zone_routing.enabled", 100))
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.zone_routing.min_cluster_size", 6))
+      .WillRepeatedly(Return(3));
+
+  hostSet().healthy_hosts_ = *hosts;
+  hostSet().hosts_ = *hosts;
+  hostSet().healthy_hosts_per_locality_ = hosts_per_locality;
+  init(true);
+  local_host_set_->updateHosts(local_hosts, local_hosts, local_hosts_per_locality,
+                               local_hosts_per_locality, empty_host_vector_, empty_host_vector_);
+
+  // Half of the upstream hosts are in the local locality, so all requests stay in it.
+  EXPECT_EQ((*hosts)[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ((*hosts)[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ((*hosts)[0], lb_->chooseHost(nullptr));
+  EXPECT_EQ((*hosts)[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(4U, stats_.lb_zone_routing_all_directly_.value());
+}
+
 TEST_P(RoundRobinLoadBalancerTest, ZoneAwareRoutingSmallZone) {
   if (&hostSet() == &failover_host_set_) { // P = 1 does not support zone-aware routing.
     return;
@@ -693,21 +753,21 @@ TEST_P(LeastRequestLoadBalancerTest, SingleHost) {
   // Host weight is 1.
   {
     EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2)).WillOnce(Return(3));
-    stats_.max_host_weight_.set(1UL);
     EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
   }
 
-  // Host weight is 100.
+  // Host weight is 100. A single host is never weighted.
   {
-    EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2));
-    stats_.max_host_weight_.set(100UL);
+    hostSet().healthy_hosts_[0]->weight(100);
+    hostSet().runCallbacks({}, {});
+    EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2)).WillOnce(Return(3));
     EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
   }
 
   HostVector empty;
   {
     hostSet().runCallbacks(empty, empty);
-    EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2));
+    EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2)).WillOnce(Return(3));
     EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
   }
 
@@ -725,7 +785,6 @@ TEST_P(LeastRequestLoadBalancerTest, SingleHost) {
 TEST_P(LeastRequestLoadBalancerTest, Normal) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80"),
                               makeTestHost(info_, "tcp://127.0.0.1:81")};
-  stats_.max_host_weight_.set(1UL);
   hostSet().hosts_ = hostSet().healthy_hosts_;
   hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
   EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2)).WillOnce(Return(3));
@@ -742,87 +801,56 @@ TEST_P(LeastRequestLoadBalancerTest, Normal) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
 }
 
-TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceRuntimeOff) {
-  // Disable weight balancing.
-  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.weight_enabled", 1))
-      .WillRepeatedly(Return(0));
-  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.healthy_panic_threshold", 50))
-      .WillRepeatedly(Return(50));
-
+// Hosts with different weights are picked in proportion to their weights.
+TEST_P(LeastRequestLoadBalancerTest, WeightImbalance) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
                               makeTestHost(info_, "tcp://127.0.0.1:81", 3)};
-  stats_.max_host_weight_.set(3UL);
-
   hostSet().hosts_ = hostSet().healthy_hosts_;
-  hostSet().healthy_hosts_[0]->stats().rq_active_.set(1);
-  hostSet().healthy_hosts_[1]->stats().rq_active_.set(2);
   hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
 
-  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
-  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
-
-  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1)).WillOnce(Return(0));
+  // Only the priority is chosen randomly.
+  EXPECT_CALL(random_, random()).Times(4).WillRepeatedly(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
 }
 
-TEST_P(LeastRequestLoadBalancerTest, WeightImbalance) {
+// A host's weight is divided by its active requests plus one.
+TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceWithActiveRequests) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
                               makeTestHost(info_, "tcp://127.0.0.1:81", 3)};
-  stats_.max_host_weight_.set(3UL);
-
   hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(2);
   hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
-  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.healthy_panic_threshold", 50))
-      .WillRepeatedly(Return(50));
-
-  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.weight_enabled", 1))
-      .WillRepeatedly(Return(1));
-  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.healthy_panic_threshold", 50))
-      .WillRepeatedly(Return(50));
-
-  // As max weight higher then 1 we do random host pick and keep it for weight requests.
-  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1));
-  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
 
-  // Same host stays as we have to hit it 3 times.
-  hostSet().healthy_hosts_[0]->stats().rq_active_.set(2);
-  hostSet().healthy_hosts_[1]->stats().rq_active_.set(1);
-  EXPECT_CALL(random_, random()).Times(0);
-  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
-
-  // Same host stays as we have to hit it 3 times.
-  EXPECT_CALL(random_, random()).Times(0);
-  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
-
-  // Get random host after previous one was selected 3 times in a row.
-  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2));
-  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
-
-  // Select second host again.
-  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1));
-  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
-
-  // Set weight to 1, we will switch to the two random hosts mode.
-  stats_.max_host_weight_.set(1UL);
-  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2)).WillOnce(Return(3));
-  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(0));
+  for (uint32_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+    EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+  }
 
-  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2)).WillOnce(Return(2));
-  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+  // Once host 1 catches up with its requests it is picked three times as often again.
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(0);
+  uint32_t host_1_picks = 0;
+  for (uint32_t i = 0; i < 400; ++i) {
+    if (lb_.chooseHost(nullptr) == hostSet().healthy_hosts_[1]) {
+      ++host_1_picks;
+    }
+  }
+  EXPECT_NEAR(300, host_1_picks, 2);
 }
 
 TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceCallbacks) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
                               makeTestHost(info_, "tcp://127.0.0.1:81", 3)};
-  stats_.max_host_weight_.set(3UL);
-
   hostSet().hosts_ = hostSet().healthy_hosts_;
   hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
 
-  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0));
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
 
-  // Same host stays as we have to hit it 3 times, but we remove it and fire callback.
+  // Remove the weighted host and fire callback. The remaining host is picked unweighted.
   HostVector empty;
   HostVector hosts_removed;
   hosts_removed.push_back(hostSet().hosts_[1]);
@@ -830,7 +858,7 @@ TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceCallbacks) {
   hostSet().healthy_hosts_.erase(hostSet().healthy_hosts_.begin() + 1);
   hostSet().runCallbacks(empty, hosts_removed);
 
-  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1)).WillOnce(Return(2));
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
 }
 
@@ -1,6 +1,7 @@
 #include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "envoy/router/router.h"
 
@@ -180,6 +181,126 @@ TEST_P(RingHashFailoverTest, BasicFailover) {
   EXPECT_EQ(failover_host_set_.healthy_hosts_[0], lb->chooseHost(nullptr));
 }
 
+// With a balance factor, hosts at the load bound are skipped for the next host on the ring.
+TEST_P(RingHashLoadBalancerTest, BoundedLoad) {
+  hostSet().hosts_ = {
+      makeTestHost(info_, "tcp://127.0.0.1:90"), makeTestHost(info_, "tcp://127.0.0.1:91"),
+      makeTestHost(info_, "tcp://127.0.0.1:92"), makeTestHost(info_, "tcp://127.0.0.1:93"),
+      makeTestHost(info_, "tcp://127.0.0.1:94"), makeTestHost(info_, "tcp://127.0.0.1:95")};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_.value(envoy::api::v2::Cluster::RingHashLbConfig());
+  config_.value().mutable_minimum_ring_size()->set_value(12);
+  config_.value().mutable_deprecated_v1()->mutable_use_std_hash()->set_value(false);
+
+  init();
+  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.consistent_hash.balance_factor", 0))
+      .WillRepeatedly(Return(150));
+
+  // The ring is the same as in the Basic test, which starts with :94, :92, :90. With 2 active
+  // requests across 6 hosts, a host may have at most ceil(1.5 * 3 / 6) - 1 = 0 active requests.
+  stats_.upstream_rq_active_.set(2);
+  LoadBalancerPtr lb = lb_->factory()->create();
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(hostSet().hosts_[4], lb->chooseHost(&context));
+  EXPECT_EQ(0UL, stats_.lb_hash_bounded_load_overflow_.value());
+
+  hostSet().hosts_[4]->stats().rq_active_.set(1);
+  EXPECT_EQ(hostSet().hosts_[2], lb->chooseHost(&context));
+  EXPECT_EQ(1UL, stats_.lb_hash_bounded_load_overflow_.value());
+
+  hostSet().hosts_[2]->stats().rq_active_.set(1);
+  EXPECT_EQ(hostSet().hosts_[0], lb->chooseHost(&context));
+  EXPECT_EQ(3UL, stats_.lb_hash_bounded_load_overflow_.value());
+
+  // With more requests in the cluster the bound grows and the hash's own host is used again.
+  stats_.upstream_rq_active_.set(11);
+  EXPECT_EQ(hostSet().hosts_[4], lb->chooseHost(&context));
+  EXPECT_EQ(3UL, stats_.lb_hash_bounded_load_overflow_.value());
+
+  // When every host is at the bound, the hash's own host is used.
+  stats_.upstream_rq_active_.set(0);
+  for (const auto& host : hostSet().hosts_) {
+    host->stats().rq_active_.set(1);
+  }
+  EXPECT_EQ(hostSet().hosts_[4], lb->chooseHost(&context));
+  EXPECT_EQ(9UL, stats_.lb_hash_bounded_load_overflow_.value());
+
+  // :91 owns two consecutive entries. The walk from its first entry checks it once and goes on
+  // to :93, :95, :92, :94 and finally :90, the only host left under the bound.
+  hostSet().hosts_[0]->stats().rq_active_.set(0);
+  TestLoadBalancerContext context_91(5000000000000000000);
+  EXPECT_EQ(hostSet().hosts_[0], lb->chooseHost(&context_91));
+  EXPECT_EQ(14UL, stats_.lb_hash_bounded_load_overflow_.value());
+}
+
+// The bounded load walk checks at most 16 hosts before it falls back to the hash's own host.
+TEST_P(RingHashLoadBalancerTest, BoundedLoadMaxHosts) {
+  for (uint32_t i = 0; i < 20; i++) {
+    hostSet().hosts_.push_back(makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 90 + i)));
+    hostSet().hosts_.back()->stats().rq_active_.set(1);
+  }
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  init();
+  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.consistent_hash.balance_factor", 0))
+      .WillRepeatedly(Return(100));
+
+  LoadBalancerPtr lb = lb_->factory()->create();
+  TestLoadBalancerContext context(0);
+  stats_.upstream_rq_active_.set(20);
+  HostConstSharedPtr first_choice = lb->chooseHost(&context);
+  EXPECT_EQ(0UL, stats_.lb_hash_bounded_load_overflow_.value());
+
+  // With every host at the bound, only 16 hosts are checked.
+  stats_.upstream_rq_active_.set(0);
+  EXPECT_EQ(first_choice, lb->chooseHost(&context));
+  EXPECT_EQ(16UL, stats_.lb_hash_bounded_load_overflow_.value());
+}
+
+// A ring rebuilt from the previous ring after a membership update matches a ring built from
+// scratch for the same hosts.
+TEST_P(RingHashLoadBalancerTest, IncrementalRebuild) {
+  for (uint32_t i = 0; i < 10; i++) {
+    hostSet().hosts_.push_back(makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 90 + i)));
+  }
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_.value(envoy::api::v2::Cluster::RingHashLbConfig());
+  config_.value().mutable_minimum_ring_size()->set_value(10000);
+  config_.value().mutable_deprecated_v1()->mutable_use_std_hash()->set_value(false);
+  init();
+
+  // Replace one host, keeping the objects of the other hosts.
+  HostSharedPtr removed_host = hostSet().hosts_[3];
+  hostSet().hosts_[3] = makeTestHost(info_, "tcp://127.0.0.1:100");
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({hostSet().hosts_[3]}, {removed_host});
+
+  const uint64_t num_keys = 1000;
+  const uint64_t key_spacing = std::numeric_limits<uint64_t>::max() / num_keys;
+  std::vector<HostConstSharedPtr> incremental_picks;
+  LoadBalancerPtr lb = lb_->factory()->create();
+  for (uint64_t i = 0; i < num_keys; i++) {
+    TestLoadBalancerContext context(i * key_spacing);
+    incremental_picks.push_back(lb->chooseHost(&context));
+  }
+
+  init();
+  lb = lb_->factory()->create();
+  bool picked_added_host = false;
+  for (uint64_t i = 0; i < num_keys; i++) {
+    TestLoadBalancerContext context(i * key_spacing);
+    EXPECT_EQ(lb->chooseHost(&context), incremental_picks[i]);
+    EXPECT_NE(removed_host, incremental_picks[i]);
+    picked_added_host |= incremental_picks[i] == hostSet().hosts_[3];
+  }
+  EXPECT_TRUE(picked_added_host);
+}
+
 #ifndef __APPLE__
 // Run similar tests with the default hash algorithm for GCC 5.
 // TODO(danielhochman): After v1 is deprecated this test can be deleted since std::hash will no
@@ -54,6 +54,7 @@ public:
   uint64_t maxStats() override { return 16384; }
   uint64_t maxObjNameLength() override { return 60; }
   bool hotRestartDisabled() override { return false; }
+  uint64_t maxWorkerBufferedBytes() override { return 0; }
 
 private:
   const std::string config_path_;
@@ -163,12 +164,17 @@ public:
     std::unique_lock<std::mutex> lock(lock_);
     return store_.gauges();
   }
+  std::list<ParentHistogramSharedPtr> histograms() const override {
+    std::unique_lock<std::mutex> lock(lock_);
+    return store_.histograms();
+  }
 
   // Stats::StoreRoot
   void addSink(Sink&) override {}
   void setTagProducer(TagProducerPtr&&) override {}
   void initializeThreading(Event::Dispatcher&, ThreadLocal::Instance&) override {}
   void shutdownThreading() override {}
+  void mergeHistograms(PostMergeCb merge_complete_cb) override { merge_complete_cb(); }
 
 private:
   mutable std::mutex lock_;
@@ -101,6 +101,7 @@ public:
   MOCK_METHOD1(post, void(std::function<void()> callback));
   MOCK_METHOD1(run, void(RunType type));
   Buffer::WatermarkFactory& getWatermarkFactory() override { return buffer_factory_; }
+  MOCK_METHOD2(initializeStats, void(Stats::Scope& scope, const std::string& prefix));
 
   std::list<DeferredDeletablePtr> to_delete_;
   MockBufferFactory buffer_factory_;
@@ -14,6 +14,7 @@
 #include "envoy/http/filter.h"
 #include "envoy/ssl/connection.h"
 
+#include "common/common/arena_impl.h"
 #include "common/http/conn_manager_impl.h"
 
 #include "test/mocks/common.h"
@@ -206,6 +207,7 @@ public:
   Event::MockDispatcher dispatcher_;
   testing::NiceMock<RequestInfo::MockRequestInfo> request_info_;
   std::shared_ptr<Router::MockRoute> route_;
+  ArenaImpl arena_;
 };
 
 class MockStreamDecoderFilterCallbacks : public StreamDecoderFilterCallbacks,
@@ -224,6 +226,7 @@ public:
   MOCK_METHOD0(requestInfo, RequestInfo::RequestInfo&());
   MOCK_METHOD0(activeSpan, Tracing::Span&());
   MOCK_METHOD0(tracingConfig, Tracing::Config&());
+  MOCK_METHOD0(arena, Arena&());
   MOCK_METHOD0(onDecoderFilterAboveWriteBufferHighWatermark, void());
   MOCK_METHOD0(onDecoderFilterBelowWriteBufferLowWatermark, void());
   MOCK_METHOD1(addDownstreamWatermarkCallbacks, void(DownstreamWatermarkCallbacks&));
@@ -270,6 +273,7 @@ public:
   MOCK_METHOD0(requestInfo, RequestInfo::RequestInfo&());
   MOCK_METHOD0(activeSpan, Tracing::Span&());
   MOCK_METHOD0(tracingConfig, Tracing::Config&());
+  MOCK_METHOD0(arena, Arena&());
   MOCK_METHOD0(onEncoderFilterAboveWriteBufferHighWatermark, void());
   MOCK_METHOD0(onEncoderFilterBelowWriteBufferLowWatermark, void());
   MOCK_METHOD1(setEncoderBufferLimit, void(uint32_t));
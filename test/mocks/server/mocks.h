@@ -64,6 +64,7 @@ public:
   MOCK_METHOD0(maxStats, uint64_t());
   MOCK_METHOD0(maxObjNameLength, uint64_t());
   MOCK_METHOD0(hotRestartDisabled, bool());
+  MOCK_METHOD0(maxWorkerBufferedBytes, uint64_t());
 
   std::string config_path_;
   bool v2_config_only_{};
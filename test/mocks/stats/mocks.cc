@@ -5,6 +5,7 @@
 
 using testing::Invoke;
 using testing::NiceMock;
+using testing::Return;
 using testing::ReturnRef;
 using testing::_;
 
@@ -36,7 +37,13 @@ MockHistogram::MockHistogram() {
 }
 MockHistogram::~MockHistogram() {}
 
-MockSink::MockSink() {}
+MockParentHistogram::MockParentHistogram() {
+  ON_CALL(*this, tagExtractedName()).WillByDefault(ReturnRef(name_));
+  ON_CALL(*this, tags()).WillByDefault(ReturnRef(tags_));
+}
+MockParentHistogram::~MockParentHistogram() {}
+
+MockSink::MockSink() { ON_CALL(*this, wantsHistogramValues()).WillByDefault(Return(true)); }
 MockSink::~MockSink() {}
 
 MockStore::MockStore() {
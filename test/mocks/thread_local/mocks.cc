@@ -12,6 +12,8 @@ namespace ThreadLocal {
 MockInstance::MockInstance() {
   ON_CALL(*this, allocateSlot()).WillByDefault(Invoke(this, &MockInstance::allocateSlot_));
   ON_CALL(*this, runOnAllThreads(_)).WillByDefault(Invoke(this, &MockInstance::runOnAllThreads_));
+  ON_CALL(*this, runOnAllThreads(_, _))
+      .WillByDefault(Invoke(this, &MockInstance::runOnAllThreadsWithBarrier_));
   ON_CALL(*this, shutdownThread()).WillByDefault(Invoke(this, &MockInstance::shutdownThread_));
 }
 
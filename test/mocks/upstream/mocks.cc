@@ -28,6 +28,20 @@ MockHostSet::MockHostSet(uint32_t priority) : priority_(priority) {
   ON_CALL(*this, healthyHostsPerLocality())
       .WillByDefault(
           Invoke([this]() -> const HostsPerLocality& { return *healthy_hosts_per_locality_; }));
+  // The mock keeps its hosts by value so that tests can edit them, so hand out copies.
+  ON_CALL(*this, hostsPtr()).WillByDefault(Invoke([this]() -> HostVectorConstSharedPtr {
+    return std::make_shared<const HostVector>(hosts_);
+  }));
+  ON_CALL(*this, healthyHostsPtr()).WillByDefault(Invoke([this]() -> HostVectorConstSharedPtr {
+    return std::make_shared<const HostVector>(healthy_hosts_);
+  }));
+  ON_CALL(*this, hostsPerLocalityPtr())
+      .WillByDefault(Invoke(
+          [this]() -> HostsPerLocalityConstSharedPtr { return hosts_per_locality_->clone(); }));
+  ON_CALL(*this, healthyHostsPerLocalityPtr())
+      .WillByDefault(Invoke([this]() -> HostsPerLocalityConstSharedPtr {
+        return healthy_hosts_per_locality_->clone();
+      }));
 }
 
 MockPrioritySet::MockPrioritySet() {
@@ -1,10 +1,12 @@
 #include "envoy/registry/registry.h"
 #include "envoy/server/access_log_config.h"
 
+#include "common/access_log/binary_file_access_log_impl.h"
 #include "common/access_log/grpc_access_log_impl.h"
 #include "common/config/well_known_names.h"
 
 #include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -53,6 +55,41 @@ TEST_F(HttpGrpcAccessLogConfigTest, Ok) {
   EXPECT_NE(nullptr, dynamic_cast<AccessLog::HttpGrpcAccessLog*>(instance.get()));
 }
 
+class BinaryFileAccessLogConfigTest : public testing::Test {
+public:
+  void SetUp() override {
+    factory_ = Registry::FactoryRegistry<AccessLogInstanceFactory>::getFactory(
+        Config::AccessLogNames::get().BINARY_FILE);
+    ASSERT_NE(nullptr, factory_);
+
+    message_ = factory_->createEmptyConfigProto();
+    ASSERT_NE(nullptr, message_);
+
+    file_access_log_.set_path("/dev/null");
+  }
+
+  AccessLog::FilterPtr filter_;
+  NiceMock<Server::Configuration::MockFactoryContext> context_;
+  envoy::config::filter::accesslog::v2::FileAccessLog file_access_log_;
+  ProtobufTypes::MessagePtr message_;
+  AccessLogInstanceFactory* factory_{};
+};
+
+TEST_F(BinaryFileAccessLogConfigTest, Ok) {
+  MessageUtil::jsonConvert(file_access_log_, *message_);
+  AccessLog::InstanceSharedPtr instance =
+      factory_->createAccessLogInstance(*message_, std::move(filter_), context_);
+  EXPECT_NE(nullptr, dynamic_cast<AccessLog::BinaryFileAccessLog*>(instance.get()));
+}
+
+TEST_F(BinaryFileAccessLogConfigTest, FormatNotSupported) {
+  file_access_log_.set_format("%PROTOCOL%");
+  MessageUtil::jsonConvert(file_access_log_, *message_);
+  EXPECT_THROW_WITH_MESSAGE(
+      factory_->createAccessLogInstance(*message_, std::move(filter_), context_), EnvoyException,
+      "envoy.binary_file_access_log does not support a format");
+}
+
 } // namespace Configuration
 } // namespace Server
 } // namespace Envoy
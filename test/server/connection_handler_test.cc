@@ -17,6 +17,7 @@ using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
+using testing::SaveArg;
 using testing::_;
 
 namespace Envoy {
@@ -141,6 +142,60 @@ TEST_F(ConnectionHandlerTest, DestroyCloseConnections) {
   handler_.reset();
 }
 
+TEST_F(ConnectionHandlerTest, BufferOverloadClosesLargestConnection) {
+  Event::MockTimer* overload_timer = new Event::MockTimer(&dispatcher_);
+  handler_.reset(new ConnectionHandlerImpl(ENVOY_LOGGER(), dispatcher_, 100));
+
+  Network::MockListener* listener = new NiceMock<Network::MockListener>();
+  Network::ListenerCallbacks* listener_callbacks;
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return listener;
+          }));
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  EXPECT_CALL(test_listener->socket_, localAddress());
+  handler_->addListener(*test_listener);
+
+  Network::MockConnection* connection1 = new NiceMock<Network::MockConnection>();
+  Buffer::MemoryAccount* account1;
+  EXPECT_CALL(*connection1, setBufferMemoryAccount(_)).WillOnce(SaveArg<0>(&account1));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_)).WillRepeatedly(Return(true));
+  listener_callbacks->onNewConnection(Network::ConnectionPtr{connection1});
+
+  Network::MockConnection* connection2 = new NiceMock<Network::MockConnection>();
+  Buffer::MemoryAccount* account2;
+  EXPECT_CALL(*connection2, setBufferMemoryAccount(_)).WillOnce(SaveArg<0>(&account2));
+  listener_callbacks->onNewConnection(Network::ConnectionPtr{connection2});
+  EXPECT_EQ(2UL, handler_->numConnections());
+
+  Stats::Gauge& buffered_bytes = stats_store_.gauge("downstream_cx_buffered_bytes");
+  account1->charge(70);
+  account2->charge(20);
+  EXPECT_EQ(90UL, buffered_bytes.value());
+
+  // Going over the limit schedules the overload check once.
+  EXPECT_CALL(*overload_timer, enableTimer(std::chrono::milliseconds(0)));
+  account2->charge(20);
+  account1->charge(5);
+  EXPECT_EQ(115UL, buffered_bytes.value());
+
+  // Closing the largest connection is enough to get back under the limit.
+  EXPECT_CALL(*connection1, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*connection2, close(_)).Times(0);
+  overload_timer->callback_();
+  EXPECT_EQ(1UL, handler_->numConnections());
+  EXPECT_EQ(40UL, buffered_bytes.value());
+  EXPECT_EQ(1UL, stats_store_.counter("downstream_cx_buffer_overload_reset").value());
+
+  account2->credit(40);
+  EXPECT_EQ(0UL, buffered_bytes.value());
+
+  EXPECT_CALL(*listener, onDestroy());
+  handler_.reset();
+}
+
 TEST_F(ConnectionHandlerTest, CloseDuringFilterChainCreate) {
   InSequence s;
 
@@ -13,7 +13,9 @@
 
 using testing::HasSubstr;
 using testing::InSequence;
+using testing::NiceMock;
 using testing::Property;
+using testing::Return;
 using testing::SaveArg;
 using testing::StrictMock;
 using testing::_;
@@ -35,7 +37,30 @@ TEST(ServerInstanceUtil, flushHelper) {
 
   std::list<Stats::SinkPtr> sinks;
   sinks.emplace_back(std::move(sink));
-  InstanceUtil::flushCountersAndGaugesToSinks(sinks, store);
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+}
+
+TEST(ServerInstanceUtil, flushHelperHistograms) {
+  InSequence s;
+
+  NiceMock<Stats::MockStore> store;
+  auto used_histogram = std::make_shared<NiceMock<Stats::MockParentHistogram>>();
+  used_histogram->name_ = "used";
+  auto unused_histogram = std::make_shared<NiceMock<Stats::MockParentHistogram>>();
+  unused_histogram->name_ = "unused";
+  ON_CALL(*used_histogram, used()).WillByDefault(Return(true));
+  ON_CALL(store, histograms())
+      .WillByDefault(Return(std::list<Stats::ParentHistogramSharedPtr>{used_histogram,
+                                                                        unused_histogram}));
+
+  std::unique_ptr<Stats::MockSink> sink(new StrictMock<Stats::MockSink>());
+  EXPECT_CALL(*sink, beginFlush());
+  EXPECT_CALL(*sink, flushHistogram(Property(&Stats::Metric::name, "used")));
+  EXPECT_CALL(*sink, endFlush());
+
+  std::list<Stats::SinkPtr> sinks;
+  sinks.emplace_back(std::move(sink));
+  InstanceUtil::flushMetricsToSinks(sinks, store);
 }
 
 class RunHelperTest : public testing::Test {